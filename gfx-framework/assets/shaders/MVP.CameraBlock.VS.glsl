@@ -0,0 +1,35 @@
+#version 330
+
+// Input
+layout(location = 0) in vec3 v_position;
+layout(location = 1) in vec3 v_normal;
+layout(location = 2) in vec2 v_texture_coord;
+layout(location = 3) in vec3 v_color;
+
+// Camera data of the frame, see CameraUniformBuffer
+layout(std140) uniform CameraBlock
+{
+    mat4 View;
+    mat4 Projection;
+    mat4 ViewProjection;
+    vec4 EyePosition;
+    vec2 ClipPlanes;
+    vec2 Resolution;
+};
+
+// Uniform properties
+uniform mat4 Model;
+
+// Output
+out vec3 frag_normal;
+out vec3 frag_color;
+out vec2 tex_coord;
+
+
+void main()
+{
+    frag_normal = v_normal;
+    frag_color = v_color;
+    tex_coord = v_texture_coord;
+    gl_Position = ViewProjection * Model * vec4(v_position, 1.0);
+}
@@ -0,0 +1,26 @@
+#version 330
+
+// Input
+layout(location = 0) in vec3 v_position;
+layout(location = 1) in vec3 v_normal;
+layout(location = 2) in vec2 v_texture_coord;
+layout(location = 4) in float v_texture_layer;
+
+// Uniform properties
+uniform mat4 Model;
+uniform mat4 View;
+uniform mat4 Projection;
+
+// Output
+out vec3 frag_normal;
+out vec2 tex_coord;
+flat out float texture_layer;
+
+
+void main()
+{
+    frag_normal = v_normal;
+    tex_coord = v_texture_coord;
+    texture_layer = v_texture_layer;
+    gl_Position = Projection * View * Model * vec4(v_position, 1.0);
+}
@@ -1,12 +1,12 @@
 #version 330 core
 in vec2 TexCoords;
+in vec4 Color;
 out vec4 color;
 
 uniform sampler2D text;
-uniform vec3 textColor;
 
 void main()
 {
 	vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
-	color = vec4(textColor, 1.0) * sampled;
+	color = Color * sampled;
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #version 330 core
 layout(location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+layout(location = 1) in vec4 vertex_color;
+
 out vec2 TexCoords;
+out vec4 Color;
 
 uniform mat4 projection;
 
@@ -8,4 +11,5 @@ void main()
 {
 	gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
 	TexCoords = vertex.zw;
+	Color = vertex_color;
 }
\ No newline at end of file
@@ -0,0 +1,22 @@
+#version 330
+
+// Input
+in vec3 frag_normal;
+in vec2 tex_coord;
+flat in float texture_layer;
+
+// Uniform properties
+uniform sampler2DArray u_texture_0;
+
+// Output
+layout(location = 0) out vec4 out_color;
+
+
+void main()
+{
+    out_color = texture(u_texture_0, vec3(tex_coord, texture_layer));
+    if(out_color.a < 0.9)
+    {
+        discard;
+    }
+}
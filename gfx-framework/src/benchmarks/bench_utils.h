@@ -0,0 +1,98 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+
+/*
+ *  Minimal helpers shared by the headless benchmarks. Nothing here needs
+ *  an OpenGL context, so the benchmarks can run on build machines.
+ */
+
+namespace bench
+{
+    class Timer
+    {
+     public:
+        Timer()
+        {
+            Start();
+        }
+
+        void Start()
+        {
+            start = std::chrono::steady_clock::now();
+        }
+
+        double ElapsedMs() const
+        {
+            auto end = std::chrono::steady_clock::now();
+            return std::chrono::duration<double, std::milli>(end - start).count();
+        }
+
+     private:
+        std::chrono::steady_clock::time_point start;
+    };
+
+
+    // Runs `func` a few times to warm up caches, then returns the average
+    // duration of one iteration in milliseconds
+    template <class Function>
+    double MeasureMs(Function func, unsigned int iterations, unsigned int warmup = 2)
+    {
+        for (unsigned int i = 0; i < warmup; i++) {
+            func();
+        }
+
+        Timer timer;
+        for (unsigned int i = 0; i < iterations; i++) {
+            func();
+        }
+
+        return timer.ElapsedMs() / iterations;
+    }
+
+
+    // Reads an option of the form `--name=value` from the command line
+    inline std::string GetStringArg(int argc, char **argv, const std::string &name, const std::string &defaultValue)
+    {
+        const std::string prefix = "--" + name + "=";
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg.compare(0, prefix.size(), prefix) == 0) {
+                return arg.substr(prefix.size());
+            }
+        }
+        return defaultValue;
+    }
+
+
+    inline unsigned int GetArg(int argc, char **argv, const std::string &name, unsigned int defaultValue)
+    {
+        const std::string value = GetStringArg(argc, argv, name, "");
+        return value.empty() ? defaultValue : static_cast<unsigned int>(std::strtoul(value.c_str(), nullptr, 10));
+    }
+
+
+    inline double GetDoubleArg(int argc, char **argv, const std::string &name, double defaultValue)
+    {
+        const std::string value = GetStringArg(argc, argv, name, "");
+        return value.empty() ? defaultValue : std::strtod(value.c_str(), nullptr);
+    }
+
+
+    // Prevents the compiler from discarding a computed value: the value must
+    // be in a register or in memory, and the compiler cannot tell what reads it
+    template <class T>
+    inline void DoNotOptimize(const T &value)
+    {
+#if defined(_MSC_VER)
+        volatile char sink = *reinterpret_cast<const volatile char *>(&value);
+        (void)sink;
+#else
+        asm volatile("" : : "r,m"(value) : "memory");
+#endif
+    }
+}   // namespace bench
@@ -0,0 +1,123 @@
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmarks/bench_utils.h"
+#include "core/cpu_profiler.h"
+
+
+/*
+ *  Measures the cost of a CpuProfiler zone, on one thread and on several
+ *  threads recording at the same time, against the same loop without the
+ *  zone. Each thread has its own buffer, so the cost per zone should not
+ *  grow with the number of threads.
+ *
+ *  Before timing, a trace is written while the threads record, and is
+ *  checked to hold every zone recorded before it, each on the thread that
+ *  recorded it.
+ */
+
+
+static unsigned int CountOccurrences(const std::string &text, const std::string &pattern)
+{
+    unsigned int count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+        count++;
+    return count;
+}
+
+
+static void Work(unsigned int zones, bool profiled)
+{
+    unsigned int value = 0;
+    for (unsigned int i = 0; i < zones; i++)
+    {
+        if (profiled)
+        {
+            PROFILE_ZONE("Work");
+            value = value * 1664525U + 1013904223U;
+        }
+        else
+        {
+            value = value * 1664525U + 1013904223U;
+        }
+        bench::DoNotOptimize(value);
+    }
+}
+
+
+static bool CheckTrace(const std::string &path)
+{
+    const unsigned int kThreads = 4;
+    const unsigned int kZones = 10000;
+
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < kThreads; t++)
+        threads.emplace_back(Work, kZones, true);
+
+    // Written while the threads are still recording
+    const bool written = CpuProfiler::WriteTrace(path);
+
+    for (std::thread &thread : threads)
+        thread.join();
+
+    if (!written || !CpuProfiler::WriteTrace(path))
+        return false;
+
+    std::ifstream file(path);
+    std::stringstream stream;
+    stream << file.rdbuf();
+    const std::string trace = stream.str();
+
+    if (CountOccurrences(trace, "\"ph\":\"X\"") != CpuProfiler::GetEventCount()
+        || CpuProfiler::GetEventCount() < kThreads * kZones)
+        return false;
+
+    for (unsigned int t = 0; t < kThreads; t++)
+    {
+        if (trace.find("\"tid\":" + std::to_string(t) + ",") == std::string::npos)
+            return false;
+    }
+
+    return trace.compare(0, 15, "{\"displayTimeUn") == 0 && trace.find("\n]}") != std::string::npos;
+}
+
+
+int main(int argc, char **argv)
+{
+    const unsigned int zones = bench::GetArg(argc, argv, "zones", 1000000);
+    const unsigned int maxThreads = bench::GetArg(argc, argv, "threads", std::thread::hardware_concurrency());
+    const std::string tracePath = bench::GetStringArg(argc, argv, "trace", "bench_cpu_profiler.json");
+
+    if (!CheckTrace(tracePath))
+    {
+        printf("the trace is wrong\n");
+        return 1;
+    }
+
+    printf("%u zones per thread\n\n", zones);
+    printf("%8s %14s %14s %14s\n", "threads", "without (ms)", "with (ms)", "ns per zone");
+
+    for (unsigned int threadCount = 1; threadCount <= (maxThreads ? maxThreads : 1); threadCount *= 2)
+    {
+        auto run = [&](bool profiled)
+        {
+            std::vector<std::thread> threads;
+            for (unsigned int t = 0; t < threadCount; t++)
+                threads.emplace_back(Work, zones, profiled);
+            for (std::thread &thread : threads)
+                thread.join();
+        };
+
+        const double without = bench::MeasureMs([&]() { run(false); }, 3, 1);
+        const double with = bench::MeasureMs([&]() { run(true); }, 3, 1);
+
+        printf("%8u %14.3f %14.3f %14.2f\n", threadCount, without, with, (with - without) * 1e6 / zones);
+    }
+
+    printf("\n%u events recorded\n", CpuProfiler::GetEventCount());
+    return 0;
+}
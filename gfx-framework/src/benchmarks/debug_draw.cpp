@@ -0,0 +1,140 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "benchmarks/bench_utils.h"
+#include "core/gpu/debug_draw.h"
+
+
+/*
+ *  Measures the cost of accumulating a frame of debug shapes with
+ *  DebugDraw, and compares the number of OpenGL calls needed to draw them
+ *  through DebugDrawBuffer with drawing every shape on its own, the way
+ *  SimpleScene::DrawCoordinateSystem drew the axes before: a model matrix,
+ *  a color and a draw call per shape.
+ *
+ *  Before timing, the shapes are checked: the vertex count of each one,
+ *  and the corners of the frustum of a camera, which must project to the
+ *  corners of the clip volume.
+ */
+
+
+static bool CheckShapes()
+{
+    DebugDraw debugDraw;
+
+    debugDraw.AddBox(glm::vec3(-1), glm::vec3(1), glm::vec3(1));
+    if (debugDraw.GetVertices(DebugDraw::LINES).size() != 24)
+        return false;
+
+    debugDraw.Clear();
+    debugDraw.AddSphere(glm::vec3(0), 2, glm::vec3(1));
+    if (debugDraw.GetVertices(DebugDraw::LINES).size() != 6 * DebugDraw::kCircleSegments)
+        return false;
+
+    for (const DebugVertex &vertex : debugDraw.GetVertices(DebugDraw::LINES))
+    {
+        if (std::abs(glm::length(vertex.position) - 2) > 1e-4f)
+            return false;
+    }
+
+    debugDraw.Clear();
+    debugDraw.AddAxes(glm::mat4(1), 25, true);
+    if (debugDraw.GetVertices(DebugDraw::THICK_LINES).size() != 6 || !debugDraw.GetVertices(DebugDraw::LINES).empty())
+        return false;
+
+    debugDraw.Clear();
+    debugDraw.AddGrid(glm::vec3(0), 25, 1, glm::vec3(0.5f));
+    if (debugDraw.GetVertices(DebugDraw::LINES).size() != 4 * 51)
+        return false;
+
+    const glm::mat4 viewProjection = glm::perspective(glm::radians(60.0f), 16.0f / 9, 0.1f, 100.0f)
+        * glm::lookAt(glm::vec3(3, 2, 5), glm::vec3(0), glm::vec3(0, 1, 0));
+
+    debugDraw.Clear();
+    debugDraw.AddFrustum(viewProjection, glm::vec3(1));
+    for (const DebugVertex &vertex : debugDraw.GetVertices(DebugDraw::LINES))
+    {
+        const glm::vec4 clip = viewProjection * glm::vec4(vertex.position, 1);
+        const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        for (int i = 0; i < 3; i++)
+        {
+            if (std::abs(std::abs(ndc[i]) - 1) > 1e-3f)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
+int main(int argc, char **argv)
+{
+    const unsigned int shapes = bench::GetArg(argc, argv, "shapes", 10000);
+    const unsigned int iterations = bench::GetArg(argc, argv, "iterations", 100);
+
+    if (!CheckShapes())
+    {
+        printf("the debug shapes are wrong\n");
+        return 1;
+    }
+
+    std::mt19937 generator(1234U);
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+
+    std::vector<glm::vec3> positions(shapes);
+    for (glm::vec3 &p : positions)
+        p = glm::vec3(position(generator), position(generator), position(generator));
+
+    // A mix of the shapes labs draw: bounds, light volumes and object axes
+    DebugDraw debugDraw;
+    unsigned int immediateCalls = 0;
+
+    auto frame = [&]()
+    {
+        debugDraw.Clear();
+        debugDraw.AddGrid(glm::vec3(0), 25, 1, glm::vec3(0.5f));
+        debugDraw.AddAxes(glm::mat4(1), 25, true);
+        immediateCalls = 3 * (1 + 3);
+
+        for (unsigned int i = 0; i < shapes; i++)
+        {
+            const glm::vec3 &p = positions[i];
+            switch (i % 3)
+            {
+            case 0:
+                debugDraw.AddBox(p - glm::vec3(0.5f), p + glm::vec3(0.5f), glm::vec3(1, 1, 0));
+                break;
+            case 1:
+                debugDraw.AddSphere(p, 1, glm::vec3(0, 1, 1));
+                break;
+            default:
+                debugDraw.AddAxes(glm::translate(glm::mat4(1), p), 1);
+                break;
+            }
+        }
+
+        // Model, color and draw per box and sphere, and per axis
+        immediateCalls += 3 * (shapes - shapes / 3) + 3 * 3 * (shapes / 3);
+    };
+
+    const double ms = bench::MeasureMs(frame, iterations);
+
+    // Buffer data, one sub data and one draw call per stream, and the
+    // program, the camera and the line widths
+    unsigned int batchedCalls = 1 + 4 + 2;
+    for (unsigned int i = 0; i < DebugDraw::STREAM_COUNT; i++)
+    {
+        if (!debugDraw.GetVertices(static_cast<DebugDraw::Stream>(i)).empty())
+            batchedCalls += 2;
+    }
+
+    printf("%u shapes, %u vertices, %.2f MB\n", shapes, debugDraw.GetVertexCount(),
+           debugDraw.GetVertexCount() * sizeof(DebugVertex) / (1024.0 * 1024.0));
+    printf("accumulate: %.3f ms\n\n", ms);
+    printf("%12s %12s\n", "submission", "GL calls");
+    printf("%12s %12u\n", "per shape", immediateCalls);
+    printf("%12s %12u\n", "batched", batchedCalls);
+
+    return 0;
+}
@@ -0,0 +1,225 @@
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "benchmarks/bench_utils.h"
+#include "components/camera.h"
+#include "components/frustum.h"
+
+
+/*
+ *  Benchmark for gfxc::CullBoxes and gfxc::CullSpheres, which test bounding
+ *  volumes stored as arrays of components against the frustum of a
+ *  gfxc::Camera and output the indices of the visible ones.
+ *
+ *  The baseline tests one box at a time, from an array of structures, with
+ *  Frustum::IsBoxVisible. Before timing, every path is checked against it,
+ *  and the frustum is checked against the camera matrices: a box whose
+ *  center is inside the clip volume must never be culled.
+ */
+
+
+struct Box
+{
+    glm::vec3 min;
+    glm::vec3 max;
+};
+
+
+struct Scene
+{
+    std::vector<Box>    boxes;
+
+    std::vector<float>  minX, minY, minZ;
+    std::vector<float>  maxX, maxY, maxZ;
+    std::vector<float>  centerX, centerY, centerZ, radius;
+
+    gfxc::BoxBounds     boxBounds;
+    gfxc::SphereBounds  sphereBounds;
+};
+
+
+static void BuildScene(Scene &scene, unsigned int count, float extent)
+{
+    std::mt19937 generator(1234U);
+    std::uniform_real_distribution<float> position(-extent, extent);
+    std::uniform_real_distribution<float> size(0.1F, 5.0F);
+
+    scene.boxes.resize(count);
+    for (std::vector<float> *values : { &scene.minX, &scene.minY, &scene.minZ, &scene.maxX, &scene.maxY, &scene.maxZ,
+                                        &scene.centerX, &scene.centerY, &scene.centerZ, &scene.radius }) {
+        values->resize(count);
+    }
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        const glm::vec3 center(position(generator), position(generator), position(generator));
+        const glm::vec3 halfSize(size(generator), size(generator), size(generator));
+
+        Box &box = scene.boxes[i];
+        box.min = center - halfSize;
+        box.max = center + halfSize;
+
+        scene.minX[i] = box.min.x;  scene.minY[i] = box.min.y;  scene.minZ[i] = box.min.z;
+        scene.maxX[i] = box.max.x;  scene.maxY[i] = box.max.y;  scene.maxZ[i] = box.max.z;
+
+        scene.centerX[i] = center.x;
+        scene.centerY[i] = center.y;
+        scene.centerZ[i] = center.z;
+        scene.radius[i] = glm::length(halfSize);
+    }
+
+    scene.boxBounds = { scene.minX.data(), scene.minY.data(), scene.minZ.data(),
+                        scene.maxX.data(), scene.maxY.data(), scene.maxZ.data() };
+    scene.sphereBounds = { scene.centerX.data(), scene.centerY.data(), scene.centerZ.data(), scene.radius.data() };
+}
+
+
+static unsigned int CullBoxesOneByOne(const gfxc::Frustum &frustum, const Scene &scene, unsigned int *visible)
+{
+    unsigned int visibleCount = 0;
+    for (unsigned int i = 0; i < scene.boxes.size(); i++)
+    {
+        if (frustum.IsBoxVisible(scene.boxes[i].min, scene.boxes[i].max)) {
+            visible[visibleCount++] = i;
+        }
+    }
+    return visibleCount;
+}
+
+
+static unsigned int CullSpheresOneByOne(const gfxc::Frustum &frustum, const Scene &scene, unsigned int *visible)
+{
+    unsigned int visibleCount = 0;
+    for (unsigned int i = 0; i < scene.boxes.size(); i++)
+    {
+        const glm::vec3 center(scene.centerX[i], scene.centerY[i], scene.centerZ[i]);
+        if (frustum.IsSphereVisible(center, scene.radius[i])) {
+            visible[visibleCount++] = i;
+        }
+    }
+    return visibleCount;
+}
+
+
+static bool SameIndices(const std::vector<unsigned int> &a, unsigned int countA,
+                        const std::vector<unsigned int> &b, unsigned int countB)
+{
+    if (countA != countB) {
+        return false;
+    }
+    for (unsigned int i = 0; i < countA; i++) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// Boxes whose center is inside the clip volume must be visible
+static bool CheckFrustum(const gfxc::Camera &camera, const Scene &scene,
+                         const std::vector<unsigned int> &visible, unsigned int visibleCount)
+{
+    const glm::mat4 viewProjection = camera.GetProjectionMatrix() * camera.GetViewMatrix();
+
+    unsigned int next = 0;
+    for (unsigned int i = 0; i < scene.boxes.size(); i++)
+    {
+        while (next < visibleCount and visible[next] < i) {
+            next++;
+        }
+        const bool isVisible = next < visibleCount and visible[next] == i;
+
+        const glm::vec4 clip = viewProjection * glm::vec4(0.5F * (scene.boxes[i].min + scene.boxes[i].max), 1.0F);
+        const bool isCenterInside = glm::abs(clip.x) < clip.w and glm::abs(clip.y) < clip.w and glm::abs(clip.z) < clip.w;
+        if (isCenterInside and !isVisible) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+int main(int argc, char **argv)
+{
+    const unsigned int iterations = bench::GetArg(argc, argv, "iterations", 50);
+    const unsigned int count = bench::GetArg(argc, argv, "count", 1000000);
+    const float extent = static_cast<float>(bench::GetDoubleArg(argc, argv, "extent", 500.0));
+
+    Scene scene;
+    BuildScene(scene, count, extent);
+
+    gfxc::Camera camera;
+    camera.SetPerspective(60.0F, 16.0F / 9.0F, 0.1F, extent);
+    camera.SetPositionAndRotation(glm::vec3(0.0F, 10.0F, 0.0F), glm::quat(glm::vec3(-0.1F, 0.7F, 0.0F)));
+    const gfxc::Frustum &frustum = camera.GetFrustum();
+
+    std::vector<unsigned int> expected(count);
+    std::vector<unsigned int> visible(count);
+
+    const unsigned int expectedBoxes = CullBoxesOneByOne(frustum, scene, expected.data());
+    if (!CheckFrustum(camera, scene, expected, expectedBoxes))
+    {
+        printf("a box with its center inside the clip volume was culled\n");
+        return 1;
+    }
+
+    printf("%10s %10s %10s %12s %14s %10s\n", "volume", "path", "visible", "ms/cull", "Mvolumes/s", "speedup");
+
+    const double boxesMs = bench::MeasureMs([&]()
+    {
+        bench::DoNotOptimize(CullBoxesOneByOne(frustum, scene, visible.data()));
+    }, iterations);
+    printf("%10s %10s %10u %12.3f %14.1f %10.2f\n", "box", "one-by-one", expectedBoxes, boxesMs, count / boxesMs / 1e3, 1.0);
+
+    const SimdPath paths[] = { SimdPath::SCALAR, SimdPath::SSE2, SimdPath::AVX2, SimdPath::NEON };
+    for (SimdPath path : paths)
+    {
+        if (!IsSimdPathSupported(path)) {
+            continue;
+        }
+
+        const unsigned int visibleCount = gfxc::CullBoxes(path, frustum, scene.boxBounds, count, visible.data());
+        if (!SameIndices(expected, expectedBoxes, visible, visibleCount))
+        {
+            printf("%s box culling differs from Frustum::IsBoxVisible\n", GetSimdPathName(path));
+            return 1;
+        }
+
+        const double ms = bench::MeasureMs([&]()
+        {
+            bench::DoNotOptimize(gfxc::CullBoxes(path, frustum, scene.boxBounds, count, visible.data()));
+        }, iterations);
+        printf("%10s %10s %10u %12.3f %14.1f %10.2f\n", "box", GetSimdPathName(path), visibleCount, ms, count / ms / 1e3, boxesMs / ms);
+    }
+
+    const unsigned int expectedSpheres = CullSpheresOneByOne(frustum, scene, expected.data());
+    const double spheresMs = bench::MeasureMs([&]()
+    {
+        bench::DoNotOptimize(CullSpheresOneByOne(frustum, scene, visible.data()));
+    }, iterations);
+    printf("%10s %10s %10u %12.3f %14.1f %10.2f\n", "sphere", "one-by-one", expectedSpheres, spheresMs, count / spheresMs / 1e3, 1.0);
+
+    for (SimdPath path : paths)
+    {
+        if (!IsSimdPathSupported(path)) {
+            continue;
+        }
+
+        const unsigned int visibleCount = gfxc::CullSpheres(path, frustum, scene.sphereBounds, count, visible.data());
+        if (!SameIndices(expected, expectedSpheres, visible, visibleCount))
+        {
+            printf("%s sphere culling differs from Frustum::IsSphereVisible\n", GetSimdPathName(path));
+            return 1;
+        }
+
+        const double ms = bench::MeasureMs([&]()
+        {
+            bench::DoNotOptimize(gfxc::CullSpheres(path, frustum, scene.sphereBounds, count, visible.data()));
+        }, iterations);
+        printf("%10s %10s %10u %12.3f %14.1f %10.2f\n", "sphere", GetSimdPathName(path), visibleCount, ms, count / ms / 1e3, spheresMs / ms);
+    }
+
+    return 0;
+}
@@ -0,0 +1,226 @@
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "benchmarks/bench_utils.h"
+#include "core/gpu/render_queue.h"
+
+
+/*
+ *  Compares the CPU cost of submitting a scene of repeated meshes one draw
+ *  at a time and with the instanced batches of RenderQueue, as done by
+ *  SimpleScene::FlushRenderQueue.
+ *
+ *  The scene is a forest: every instance draws one of a few meshes with the
+ *  same shader and texture, and a different model matrix. There is no
+ *  OpenGL context, so the calls are recorded into a command list, which
+ *  stands for the driver work of validating and queueing them; the model
+ *  matrices are copied with the commands, or once into an upload buffer
+ *  for the instanced path. Both paths sort the same queue. Before timing,
+ *  the batches are checked to cover the sorted packets exactly once, with
+ *  identical state inside each batch.
+ */
+
+
+enum class CommandType
+{
+    USE_PROGRAM,
+    BIND_VAO,
+    BIND_TEXTURE,
+    SET_MODEL,
+    SET_INSTANCE_BASE,
+    DRAW,
+    DRAW_INSTANCED,
+};
+
+
+struct Command
+{
+    CommandType type;
+    const void *object;
+    unsigned int value;
+    glm::mat4 model;
+};
+
+
+struct Frame
+{
+    std::vector<Command> commands;
+    std::vector<glm::mat4> uploadBuffer;
+
+    void Record(CommandType type, const void *object, unsigned int value = 0)
+    {
+        Command command;
+        command.type = type;
+        command.object = object;
+        command.value = value;
+        commands.push_back(command);
+    }
+
+    void RecordModel(const glm::mat4 &model)
+    {
+        Record(CommandType::SET_MODEL, nullptr);
+        commands.back().model = model;
+    }
+
+    void Clear()
+    {
+        commands.clear();
+        uploadBuffer.clear();
+    }
+
+    std::size_t GetBytes() const
+    {
+        std::size_t bytes = uploadBuffer.size() * sizeof(glm::mat4);
+        for (const Command &command : commands)
+        {
+            bytes += (command.type == CommandType::SET_MODEL) ? sizeof(glm::mat4) : sizeof(unsigned int);
+        }
+        return bytes;
+    }
+};
+
+
+static void RecordState(Frame &frame, const DrawPacket &packet, const RenderStateChange &change)
+{
+    if (change.program)
+        frame.Record(CommandType::USE_PROGRAM, packet.shader);
+    if (change.mesh)
+        frame.Record(CommandType::BIND_VAO, packet.mesh);
+
+    for (unsigned int t = 0; t < DrawPacket::kMaxTextures; t++)
+    {
+        if (change.textureMask & (1U << t))
+            frame.Record(CommandType::BIND_TEXTURE, packet.textures[t], t);
+    }
+}
+
+
+static void SubmitPerDraw(const RenderQueue &queue, Frame &frame)
+{
+    RenderStateTracker state;
+    for (unsigned int i = 0; i < queue.GetSize(); i++)
+    {
+        const DrawPacket &packet = queue.GetSortedPacket(i);
+        RecordState(frame, packet, state.Apply(packet));
+        frame.RecordModel(packet.model);
+        frame.Record(CommandType::DRAW, packet.mesh);
+    }
+}
+
+
+static void SubmitInstanced(const RenderQueue &queue, Frame &frame)
+{
+    const std::vector<glm::mat4> &models = queue.GetSortedModels();
+    frame.uploadBuffer.resize(models.size());
+    std::memcpy(frame.uploadBuffer.data(), models.data(), models.size() * sizeof(glm::mat4));
+
+    RenderStateTracker state;
+    for (const DrawBatch &batch : queue.GetBatches())
+    {
+        const DrawPacket &packet = queue.GetSortedPacket(batch.first);
+        RecordState(frame, packet, state.Apply(packet));
+        frame.Record(CommandType::SET_INSTANCE_BASE, nullptr, batch.first);
+        frame.Record(CommandType::DRAW_INSTANCED, packet.mesh, batch.count);
+    }
+}
+
+
+static bool CheckBatches(const RenderQueue &queue)
+{
+    unsigned int next = 0;
+    for (const DrawBatch &batch : queue.GetBatches())
+    {
+        if (batch.first != next || batch.count == 0)
+            return false;
+
+        const DrawPacket &first = queue.GetSortedPacket(batch.first);
+        for (unsigned int i = batch.first; i < batch.first + batch.count; i++)
+        {
+            const DrawPacket &packet = queue.GetSortedPacket(i);
+            if (packet.mesh != first.mesh || packet.shader != first.shader || packet.textures[0] != first.textures[0]
+                || packet.blend != first.blend || packet.model != queue.GetSortedModels()[i])
+            {
+                return false;
+            }
+        }
+        next += batch.count;
+    }
+
+    return next == queue.GetSize();
+}
+
+
+int main(int argc, char **argv)
+{
+    const unsigned int instances = bench::GetArg(argc, argv, "instances", 100000);
+    const unsigned int meshes = bench::GetArg(argc, argv, "meshes", 4);
+    const unsigned int iterations = bench::GetArg(argc, argv, "iterations", 20);
+
+    // Only the addresses are used, as identities
+    std::vector<char> storage(meshes + 2);
+    Shader *shader = reinterpret_cast<Shader *>(&storage[0]);
+    Texture2D *texture = reinterpret_cast<Texture2D *>(&storage[1]);
+
+    std::mt19937 generator(1234U);
+    std::uniform_int_distribution<unsigned int> mesh(0, meshes - 1);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+
+    std::vector<DrawPacket> packets(instances);
+    for (DrawPacket &packet : packets)
+    {
+        packet = DrawPacket();
+        packet.shader = shader;
+        packet.mesh = reinterpret_cast<Mesh *>(&storage[2 + mesh(generator)]);
+        packet.textures[0] = texture;
+        packet.model = glm::translate(glm::mat4(1), glm::vec3(position(generator), 0, position(generator)));
+    }
+
+    const glm::mat4 view = glm::lookAt(glm::vec3(0, 2, 110), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
+
+    RenderQueue queue;
+    Frame frame;
+
+    auto sort = [&]()
+    {
+        queue.Clear();
+        for (const DrawPacket &packet : packets) {
+            queue.Submit(packet);
+        }
+        queue.Sort(view);
+    };
+
+    auto submit = [&](bool instanced)
+    {
+        sort();
+        frame.Clear();
+
+        if (instanced)
+            SubmitInstanced(queue, frame);
+        else
+            SubmitPerDraw(queue, frame);
+    };
+
+    submit(true);
+    if (!CheckBatches(queue))
+    {
+        printf("the batches do not match the sorted packets\n");
+        return 1;
+    }
+
+    const double sortMs = bench::MeasureMs(sort, iterations);
+
+    printf("%u instances of %u meshes, %.3f ms to sort the queue\n\n", instances, meshes, sortMs);
+    printf("%12s %12s %12s %12s %12s\n", "submission", "ms", "w/o sort", "calls", "MB");
+
+    const char *names[] = { "per draw", "instanced" };
+    for (int instanced = 0; instanced < 2; instanced++)
+    {
+        const double ms = bench::MeasureMs([&]() { submit(instanced != 0); }, iterations);
+        printf("%12s %12.3f %12.3f %12zu %12.2f\n", names[instanced], ms, ms - sortMs, frame.commands.size() + (instanced ? 1 : 0),
+               frame.GetBytes() / (1024.0 * 1024.0));
+    }
+
+    return 0;
+}
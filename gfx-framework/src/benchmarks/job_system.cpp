@@ -0,0 +1,274 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "benchmarks/bench_utils.h"
+#include "core/job_system.h"
+
+
+/*
+ *  Measures the JobSystem on 1 to N threads:
+ *
+ *  - the overhead of a job: starting many empty jobs and waiting for them,
+ *    one by one with Run, and as ranges of one index with ParallelFor,
+ *    against starting a std::thread per job;
+ *  - the scaling of ParallelFor on two image filters, a grayscale
+ *    conversion, which is limited by the memory bandwidth, and a filter
+ *    that does a lot of math for every pixel.
+ *
+ *  Before timing, ParallelFor is checked to visit every index once, jobs to
+ *  start after their dependencies, and main thread jobs to only run on the
+ *  main thread.
+ */
+
+
+static bool CheckParallelFor(JobSystem &jobs)
+{
+    const unsigned int kCount = 100003;
+    const unsigned int grainSizes[] = { 0, 1, 7, 1000, kCount, 2 * kCount };
+
+    for (unsigned int grainSize : grainSizes)
+    {
+        std::vector<std::atomic<unsigned int>> visits(kCount);
+        for (std::atomic<unsigned int> &visit : visits)
+            visit = 0;
+
+        std::atomic<bool> valid(true);
+        jobs.ParallelFor(0, kCount, grainSize, [&](unsigned int first, unsigned int last)
+        {
+            if (first >= last || (grainSize && last - first > grainSize))
+                valid = false;
+            for (unsigned int i = first; i < last; i++)
+                visits[i]++;
+        });
+
+        for (const std::atomic<unsigned int> &visit : visits)
+        {
+            if (visit != 1)
+                return false;
+        }
+        if (!valid)
+            return false;
+    }
+
+    return true;
+}
+
+
+// A chain of stages, each started after the jobs of the previous one, which
+// start more jobs on the counter of their own stage
+static bool CheckDependencies(JobSystem &jobs)
+{
+    const unsigned int kStages = 8;
+    const unsigned int kJobs = 64;
+
+    std::vector<JobCounter> stages(kStages);
+    std::vector<std::atomic<unsigned int>> done(kStages);
+    for (std::atomic<unsigned int> &count : done)
+        count = 0;
+    std::atomic<bool> valid(true);
+
+    for (unsigned int stage = 0; stage < kStages; stage++)
+    {
+        for (unsigned int i = 0; i < kJobs; i++)
+        {
+            auto job = [&, stage]()
+            {
+                if (stage > 0 && done[stage - 1] != 2 * kJobs)
+                    valid = false;
+                done[stage]++;
+                jobs.Run([&, stage]() { done[stage]++; }, &stages[stage]);
+            };
+
+            if (stage == 0)
+                jobs.Run(job, &stages[stage]);
+            else
+                jobs.RunAfter(stages[stage - 1], job, &stages[stage]);
+        }
+    }
+
+    jobs.Wait(stages[kStages - 1]);
+
+    // Earlier stages are done, but their counters may still be released
+    for (JobCounter &stage : stages)
+        jobs.Wait(stage);
+
+    return valid && done[kStages - 1] == 2 * kJobs;
+}
+
+
+static bool CheckMainThread(JobSystem &jobs)
+{
+    const std::thread::id mainThread = std::this_thread::get_id();
+    std::atomic<unsigned int> wrongThread(0);
+    std::atomic<unsigned int> mainThreadJobs(0);
+
+    JobCounter loaded, uploaded;
+    for (unsigned int i = 0; i < 64; i++)
+    {
+        jobs.Run([&]()
+        {
+            jobs.Run([&]()
+            {
+                if (std::this_thread::get_id() != mainThread)
+                    wrongThread++;
+                mainThreadJobs++;
+            }, &uploaded, JobAffinity::MainThread);
+        }, &loaded);
+    }
+    jobs.RunAfter(loaded, [&]()
+    {
+        if (std::this_thread::get_id() != mainThread)
+            wrongThread++;
+        mainThreadJobs++;
+    }, &uploaded, JobAffinity::MainThread);
+
+    // Runs the main thread jobs until all of them are done
+    jobs.Wait(uploaded);
+
+    return jobs.IsMainThread() && wrongThread == 0 && mainThreadJobs == 65 && jobs.RunMainThreadJobs() == 0;
+}
+
+
+static double MeasureRunNs(JobSystem &jobs, unsigned int jobCount, unsigned int iterations)
+{
+    const double ms = bench::MeasureMs([&]()
+    {
+        JobCounter counter;
+        for (unsigned int i = 0; i < jobCount; i++)
+            jobs.Run([]() {}, &counter);
+        jobs.Wait(counter);
+    }, iterations);
+
+    return ms * 1e6 / jobCount;
+}
+
+
+static double MeasureParallelForNs(JobSystem &jobs, unsigned int jobCount, unsigned int iterations)
+{
+    const double ms = bench::MeasureMs([&]()
+    {
+        jobs.ParallelFor(0, jobCount, 1, [](unsigned int first, unsigned int last) {});
+    }, iterations);
+
+    return ms * 1e6 / jobCount;
+}
+
+
+static double MeasureThreadNs(unsigned int jobCount)
+{
+    const double ms = bench::MeasureMs([&]()
+    {
+        std::vector<std::thread> threads;
+        for (unsigned int i = 0; i < jobCount; i++)
+            threads.push_back(std::thread([]() {}));
+        for (std::thread &thread : threads)
+            thread.join();
+    }, 1, 1);
+
+    return ms * 1e6 / jobCount;
+}
+
+
+static void GrayScale(const std::vector<unsigned char> &image, std::vector<unsigned char> &result, unsigned int first, unsigned int last)
+{
+    for (unsigned int i = first; i < last; i++)
+    {
+        const unsigned char *pixel = &image[4 * i];
+        const unsigned char value = static_cast<unsigned char>(pixel[0] * 0.2f + pixel[1] * 0.71f + pixel[2] * 0.07f);
+        std::fill(&result[4 * i], &result[4 * i] + 3, value);
+        result[4 * i + 3] = pixel[3];
+    }
+}
+
+
+// Iterates a smooth function of the color, a stand in for the filters that
+// do more math than memory accesses
+static void ToneMap(const std::vector<unsigned char> &image, std::vector<unsigned char> &result, unsigned int first, unsigned int last)
+{
+    for (unsigned int i = first; i < last; i++)
+    {
+        for (unsigned int c = 0; c < 4; c++)
+        {
+            float value = image[4 * i + c] / 255.0f;
+            for (unsigned int step = 0; step < 8; step++)
+                value = std::sqrt(value * (1.0f - 0.5f * value) + 0.01f);
+            result[4 * i + c] = static_cast<unsigned char>(std::min(value, 1.0f) * 255.0f);
+        }
+    }
+}
+
+
+int main(int argc, char **argv)
+{
+    const unsigned int maxThreads = bench::GetArg(argc, argv, "threads", std::max(1U, std::thread::hardware_concurrency()));
+    const unsigned int jobCount = bench::GetArg(argc, argv, "jobs", 100000);
+    const unsigned int imageSize = bench::GetArg(argc, argv, "size", 1024);
+    const unsigned int iterations = bench::GetArg(argc, argv, "iterations", 10);
+
+    for (unsigned int threads = 1; threads <= maxThreads; threads++)
+    {
+        JobSystem jobs(threads);
+        if (!CheckParallelFor(jobs) || !CheckDependencies(jobs) || !CheckMainThread(jobs))
+        {
+            printf("the job system is wrong with %u threads\n", threads);
+            return 1;
+        }
+    }
+
+    printf("overhead of %u empty jobs, in ns per job\n", jobCount);
+    printf("%8s %12s %12s\n", "threads", "Run", "ParallelFor");
+    for (unsigned int threads = 1; threads <= maxThreads; threads++)
+    {
+        JobSystem jobs(threads);
+        printf("%8u %12.1f %12.1f\n", threads, MeasureRunNs(jobs, jobCount, iterations),
+               MeasureParallelForNs(jobs, jobCount, iterations));
+    }
+    printf("std::thread per job: %.1f ns\n\n", MeasureThreadNs(std::min(jobCount, 1000U)));
+
+    const unsigned int pixelCount = imageSize * imageSize;
+    std::vector<unsigned char> image(4 * pixelCount), result(4 * pixelCount);
+    for (unsigned int i = 0; i < image.size(); i++)
+        image[i] = static_cast<unsigned char>(i * 2654435761U >> 24);
+
+    printf("ParallelFor on a %ux%u image, in ms\n", imageSize, imageSize);
+    printf("%8s %12s %9s %12s %9s\n", "threads", "grayscale", "speedup", "tone map", "speedup");
+
+    double grayScaleSerial = 0, toneMapSerial = 0;
+    for (unsigned int threads = 1; threads <= maxThreads; threads++)
+    {
+        JobSystem jobs(threads);
+
+        const double grayScaleMs = bench::MeasureMs([&]()
+        {
+            jobs.ParallelFor(0, pixelCount, 0, [&](unsigned int first, unsigned int last)
+            {
+                GrayScale(image, result, first, last);
+            });
+            bench::DoNotOptimize(result[0]);
+        }, iterations);
+
+        const double toneMapMs = bench::MeasureMs([&]()
+        {
+            jobs.ParallelFor(0, pixelCount, 0, [&](unsigned int first, unsigned int last)
+            {
+                ToneMap(image, result, first, last);
+            });
+            bench::DoNotOptimize(result[0]);
+        }, iterations);
+
+        if (threads == 1)
+        {
+            grayScaleSerial = grayScaleMs;
+            toneMapSerial = toneMapMs;
+        }
+
+        printf("%8u %12.3f %8.2fx %12.3f %8.2fx\n", threads, grayScaleMs, grayScaleSerial / grayScaleMs,
+               toneMapMs, toneMapSerial / toneMapMs);
+    }
+
+    return 0;
+}
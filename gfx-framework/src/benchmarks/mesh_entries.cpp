@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "benchmarks/bench_utils.h"
+#include "core/gpu/mesh_entry.h"
+
+
+/*
+ *  Measures gpu_utils::MergeMeshEntries, which Mesh::LoadMesh uses to merge
+ *  the entries of a model that are drawn with the same texture, and counts
+ *  the calls needed to draw the model before and after the merge.
+ *
+ *  The model is made of many parts, the way Assimp loads them: each entry
+ *  has its own vertices, indexed from 0, and one of a few materials, each
+ *  with its own texture. Before timing, the merged entries are checked to
+ *  draw the same triangles with the same materials as the original ones.
+ */
+
+
+struct Model
+{
+    std::vector<MeshEntry> entries;
+    std::vector<unsigned int> indices;
+};
+
+
+static Model GenerateModel(unsigned int parts, unsigned int materials, unsigned int triangles)
+{
+    std::mt19937 generator(1234U);
+    std::uniform_int_distribution<unsigned int> material(0, materials - 1);
+
+    Model model;
+    unsigned int nrVertices = 0;
+    for (unsigned int i = 0; i < parts; i++)
+    {
+        MeshEntry entry;
+        entry.baseVertex = nrVertices;
+        entry.baseIndex = static_cast<unsigned int>(model.indices.size());
+        entry.nrIndices = triangles * 3;
+        entry.materialIndex = material(generator);
+
+        // A strip of triangles, indexed as a list
+        for (unsigned int t = 0; t < triangles; t++)
+        {
+            model.indices.push_back(t);
+            model.indices.push_back(t + 1);
+            model.indices.push_back(t + 2);
+        }
+
+        model.entries.push_back(entry);
+        nrVertices += triangles + 2;
+    }
+
+    return model;
+}
+
+
+// Every triangle, as its material and its first absolute vertex
+static std::vector<std::uint64_t> GetTriangles(const Model &model)
+{
+    std::vector<std::uint64_t> triangles;
+    for (const MeshEntry &entry : model.entries)
+    {
+        for (unsigned int k = 0; k < entry.nrIndices; k += 3)
+        {
+            const std::uint64_t vertex = model.indices[entry.baseIndex + k] + entry.baseVertex;
+            triangles.push_back((static_cast<std::uint64_t>(entry.materialIndex) << 32) | vertex);
+        }
+    }
+
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+
+static std::vector<unsigned int> GetGroups(const Model &model)
+{
+    std::vector<unsigned int> groups;
+    for (const MeshEntry &entry : model.entries)
+        groups.push_back(entry.materialIndex);
+    return groups;
+}
+
+
+int main(int argc, char **argv)
+{
+    const unsigned int parts = bench::GetArg(argc, argv, "parts", 64);
+    const unsigned int materials = bench::GetArg(argc, argv, "materials", 4);
+    const unsigned int triangles = bench::GetArg(argc, argv, "triangles", 2000);
+    const unsigned int iterations = bench::GetArg(argc, argv, "iterations", 20);
+
+    const Model model = GenerateModel(parts, materials, triangles);
+
+    Model merged = model;
+    gpu_utils::MergeMeshEntries(merged.entries, merged.indices, GetGroups(merged));
+
+    if (GetTriangles(merged) != GetTriangles(model) || merged.indices.size() != model.indices.size())
+    {
+        printf("the merged entries do not draw the same triangles\n");
+        return 1;
+    }
+
+    for (const MeshEntry &entry : merged.entries)
+    {
+        if (entry.baseVertex != 0)
+        {
+            printf("the merged entries must be drawn from vertex 0\n");
+            return 1;
+        }
+    }
+
+    const double ms = bench::MeasureMs([&]()
+    {
+        Model copy = model;
+        gpu_utils::MergeMeshEntries(copy.entries, copy.indices, GetGroups(copy));
+        bench::DoNotOptimize(copy.indices);
+    }, iterations);
+
+    const unsigned int before = static_cast<unsigned int>(model.entries.size());
+    const unsigned int after = static_cast<unsigned int>(merged.entries.size());
+
+    printf("%u parts, %u materials, %u triangles each\n", parts, materials, triangles);
+    printf("merge at load: %.3f ms\n\n", ms);
+
+    // With materials, every entry binds its texture and is drawn. Without,
+    // the entries of a mesh loaded with materials are drawn with one
+    // glMultiDrawElementsBaseVertex.
+    printf("%24s %12s %12s\n", "calls per draw", "entries", "merged");
+    printf("%24s %12u %12u\n", "with materials", 2 * before, 2 * after);
+    printf("%24s %12u %12u\n", "without materials", before, 1U);
+
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "benchmarks/bench_utils.h"
+#include "core/gpu/render_queue.h"
+
+
+/*
+ *  Measures the cost of sorting a frame of draws with RenderQueue, and the
+ *  number of program, VAO, texture and blend state changes it saves over
+ *  drawing in submission order.
+ *
+ *  The draws are generated the way lab code issues them: objects in a grid
+ *  around the camera, each drawn with a random shader, mesh and texture,
+ *  and a fraction of them blended. The queue never dereferences meshes,
+ *  shaders or textures, so fake addresses stand in for them. Before timing,
+ *  the sorted order is checked: every draw appears once, opaque draws come
+ *  grouped by pass and program, and blended draws go back to front.
+ */
+
+
+struct Resources
+{
+    // Only the addresses are used, as identities
+    std::vector<char> storage;
+
+    Shader *GetShader(unsigned int index)       { return reinterpret_cast<Shader *>(&storage[index]); }
+    Mesh *GetMesh(unsigned int index)           { return reinterpret_cast<Mesh *>(&storage[1000 + index]); }
+    Texture2D *GetTexture(unsigned int index)   { return reinterpret_cast<Texture2D *>(&storage[2000 + index]); }
+};
+
+
+static std::vector<DrawPacket> GeneratePackets(Resources &resources, unsigned int count, unsigned int shaders,
+                                               unsigned int meshes, unsigned int textures, float blendedFraction)
+{
+    std::mt19937 generator(1234U);
+    std::uniform_int_distribution<unsigned int> shader(0, shaders - 1);
+    std::uniform_int_distribution<unsigned int> mesh(0, meshes - 1);
+    std::uniform_int_distribution<unsigned int> texture(0, textures - 1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    const unsigned int side = static_cast<unsigned int>(std::sqrt(static_cast<float>(count))) + 1;
+
+    std::vector<DrawPacket> packets(count);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        DrawPacket &packet = packets[i];
+        packet = DrawPacket();
+        packet.shader = resources.GetShader(shader(generator));
+        packet.mesh = resources.GetMesh(mesh(generator));
+        packet.textures[0] = resources.GetTexture(texture(generator));
+        packet.model = glm::translate(glm::mat4(1), glm::vec3(1.0f * (i % side) - 0.5f * side, 0, -1.0f * (i / side)));
+        packet.blend = unit(generator) < blendedFraction;
+        packet.pass = 0;
+    }
+
+    return packets;
+}
+
+
+static bool CheckOrder(const RenderQueue &queue, const glm::mat4 &view)
+{
+    std::vector<bool> seen(queue.GetSize(), false);
+    const DrawPacket *first = &queue.GetPacket(0);
+
+    bool inBlended = false;
+    float previousDepth = 0;
+    std::vector<const Shader *> closedShaders;
+    const Shader *shader = nullptr;
+
+    for (unsigned int i = 0; i < queue.GetSize(); i++)
+    {
+        const DrawPacket &packet = queue.GetSortedPacket(i);
+        const unsigned int index = static_cast<unsigned int>(&packet - first);
+        if (seen[index]) {
+            return false;
+        }
+        seen[index] = true;
+
+        const float depth = -(view * packet.model[3]).z;
+
+        if (packet.blend)
+        {
+            // Back to front, after every opaque draw
+            if (inBlended and depth > previousDepth + 1e-3f) {
+                return false;
+            }
+            inBlended = true;
+            previousDepth = depth;
+            continue;
+        }
+
+        if (inBlended) {
+            return false;
+        }
+
+        // Each program is used by a single run of opaque draws
+        if (packet.shader != shader)
+        {
+            for (const Shader *closed : closedShaders) {
+                if (closed == packet.shader) {
+                    return false;
+                }
+            }
+            closedShaders.push_back(shader);
+            shader = packet.shader;
+        }
+    }
+
+    return true;
+}
+
+
+int main(int argc, char **argv)
+{
+    const unsigned int iterations = bench::GetArg(argc, argv, "iterations", 100);
+    const unsigned int shaders = bench::GetArg(argc, argv, "shaders", 8);
+    const unsigned int meshes = bench::GetArg(argc, argv, "meshes", 16);
+    const unsigned int textures = bench::GetArg(argc, argv, "textures", 32);
+    const float blendedFraction = static_cast<float>(bench::GetDoubleArg(argc, argv, "blended", 0.1));
+
+    const unsigned int counts[] = { 100, 1000, 10000, 100000 };
+
+    Resources resources;
+    resources.storage.resize(3000);
+
+    const glm::mat4 view = glm::lookAt(glm::vec3(0, 2, 5), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
+
+    printf("%10s %12s %12s %12s %12s %14s\n", "draws", "sort ms", "unsorted", "sorted", "saved", "saved/draw");
+
+    for (unsigned int count : counts)
+    {
+        const std::vector<DrawPacket> packets = GeneratePackets(resources, count, shaders, meshes, textures, blendedFraction);
+
+        RenderQueue queue;
+        for (const DrawPacket &packet : packets) {
+            queue.Submit(packet);
+        }
+        queue.Sort(view);
+
+        if (!CheckOrder(queue, view))
+        {
+            printf("the sorted order is wrong for %u draws\n", count);
+            return 1;
+        }
+
+        const double ms = bench::MeasureMs([&]()
+        {
+            queue.Clear();
+            for (const DrawPacket &packet : packets) {
+                queue.Submit(packet);
+            }
+            queue.Sort(view);
+        }, iterations);
+
+        const unsigned int unsorted = queue.GetUnsortedStats().GetStateChanges();
+        const unsigned int sorted = queue.GetStats().GetStateChanges();
+        printf("%10u %12.3f %12u %12u %12u %14.2f\n", count, ms, unsorted, sorted, queue.GetSavedStateChanges(),
+               static_cast<double>(queue.GetSavedStateChanges()) / count);
+    }
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "benchmarks/bench_utils.h"
+#include "components/performance_hud.h"
+
+
+/*
+ *  Measures the cost of building the performance HUD into a TextBatch, the
+ *  CPU side of drawing it, and compares the number of OpenGL calls needed
+ *  to draw it with one batched call against drawing every glyph on its
+ *  own, the way TextRenderer::RenderText did before: a texture bind, a
+ *  buffer update and a draw call per glyph.
+ *
+ *  The glyph metrics are those of a monospace font, made up so that the
+ *  benchmark does not need FreeType. Before timing, the quads are checked
+ *  against the metrics.
+ */
+
+
+static const int kGlyphWidth = 8;
+static const int kGlyphHeight = 12;
+static const int kAdvance = 9;
+
+
+static std::vector<gfxc::Character> CreateCharacters()
+{
+    std::vector<gfxc::Character> characters(128);
+    for (unsigned int c = 0; c < characters.size(); c++)
+    {
+        gfxc::Character &character = characters[c];
+        const bool visible = c > ' ';
+
+        character.Size = visible ? glm::ivec2(kGlyphWidth, kGlyphHeight) : glm::ivec2(0);
+        character.Bearing = glm::ivec2(0, kGlyphHeight);
+        character.Advance = kAdvance << 6;
+        character.TexCoordMin = glm::vec2((c % 16) / 16.0f, (c / 16) / 8.0f);
+        character.TexCoordMax = character.TexCoordMin + glm::vec2(1 / 16.0f, 1 / 8.0f);
+    }
+    return characters;
+}
+
+
+static bool CheckBatch(const std::vector<gfxc::Character> &characters)
+{
+    gfxc::TextBatch batch;
+    batch.SetCharacters(characters, glm::vec2(0.5f));
+
+    // Spaces advance without a quad
+    const float end = batch.AddText("a b", 10, 20, 2, glm::vec4(1));
+    const std::vector<gfxc::TextVertex> &vertices = batch.GetVertices();
+    if (end != 10 + 3 * kAdvance * 2 || vertices.size() != 12)
+        return false;
+
+    const gfxc::Character &b = characters['b'];
+    for (unsigned int i = 6; i < 12; i++)
+    {
+        const glm::vec2 offset = (vertices[i].position - glm::vec2(10 + 2 * kAdvance * 2, 20)) / 2.0f;
+        if (offset.x < 0 || offset.x > kGlyphWidth || offset.y < 0 || offset.y > kGlyphHeight)
+            return false;
+        if (glm::any(glm::lessThan(vertices[i].texCoord, b.TexCoordMin)) || glm::any(glm::greaterThan(vertices[i].texCoord, b.TexCoordMax)))
+            return false;
+    }
+
+    batch.Clear();
+    batch.AddRect(0, 0, 4, 4, glm::vec4(1));
+    for (const gfxc::TextVertex &vertex : batch.GetVertices())
+    {
+        if (vertex.texCoord != glm::vec2(0.5f))
+            return false;
+    }
+
+    return batch.GetVertices().size() == 6;
+}
+
+
+int main(int argc, char **argv)
+{
+    const unsigned int passCount = bench::GetArg(argc, argv, "passes", 8);
+    const unsigned int iterations = bench::GetArg(argc, argv, "iterations", 10000);
+
+    const std::vector<gfxc::Character> characters = CreateCharacters();
+    if (!CheckBatch(characters))
+    {
+        printf("the text quads are wrong\n");
+        return 1;
+    }
+
+    gfxc::PerformanceHud hud;
+    for (unsigned int i = 0; i < gfxc::PerformanceHud::kHistorySize; i++)
+        hud.AddFrameTime(0.010 + (i % 40) * 0.0008);
+
+    std::vector<GpuProfiler::ScopeStats> passes(passCount);
+    for (unsigned int i = 0; i < passCount; i++)
+    {
+        passes[i].name = "Pass " + std::to_string(i);
+        passes[i].cpu.averageMs = 0.25 * i;
+        passes[i].gpu.averageMs = 1.5 * i;
+    }
+
+    RenderStats stats = RenderStats();
+    stats.drawCalls = 1234;
+    stats.triangles = 5678901;
+    stats.textureBytes = 256LL << 20;
+    stats.bufferBytes = 64LL << 20;
+    stats.shaderPrograms = 12;
+
+    gfxc::TextBatch batch;
+    batch.SetCharacters(characters, glm::vec2(0.5f));
+
+    const double ms = bench::MeasureMs([&]()
+    {
+        batch.Clear();
+        hud.Build(batch, passes, stats);
+        bench::DoNotOptimize(batch.GetVertices().data());
+    }, iterations, 100);
+
+    const unsigned int quads = static_cast<unsigned int>(batch.GetVertices().size() / 6);
+
+    // Program, screen size, atlas bind, buffer data, sub data and draw
+    const unsigned int batchedCalls = 6;
+
+    // Program and color, then a bind, a sub data and a draw per quad
+    const unsigned int perGlyphCalls = 2 + 3 * quads;
+
+    printf("%u passes, %u quads, %.1f KB of vertices\n", passCount, quads,
+           batch.GetVertices().size() * sizeof(gfxc::TextVertex) / 1024.0);
+    printf("build: %.2f us\n\n", ms * 1000);
+    printf("%12s %12s %12s\n", "submission", "draw calls", "GL calls");
+    printf("%12s %12u %12u\n", "per glyph", quads, perGlyphCalls);
+    printf("%12s %12u %12u\n", "batched", 1U, batchedCalls);
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "benchmarks/bench_utils.h"
+#include "components/transform.h"
+#include "components/transform_batch.h"
+
+
+/*
+ *  Microbenchmark for gfxc::ComposeModels, the batch kernel that builds
+ *  model matrices from world positions, rotations and scales.
+ *
+ *  Before timing, the scalar path is checked against the model matrices
+ *  built by gfxc::Transform::ComputeWorldModel, and every SIMD path is
+ *  checked against the scalar one. The process exits with an error code
+ *  if any of them diverges.
+ */
+
+
+static const float TOLERANCE = 1e-5F;
+
+
+struct Inputs
+{
+    std::vector<glm::vec3> positions;
+    std::vector<glm::quat> rotations;
+    std::vector<glm::vec3> scales;
+};
+
+
+static Inputs GenerateInputs(unsigned int count)
+{
+    std::mt19937 generator(1234U);
+    std::uniform_real_distribution<float> position(-100.0F, 100.0F);
+    std::uniform_real_distribution<float> component(-1.0F, 1.0F);
+    std::uniform_real_distribution<float> scale(0.1F, 10.0F);
+
+    Inputs inputs;
+    inputs.positions.resize(count);
+    inputs.rotations.resize(count);
+    inputs.scales.resize(count);
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        inputs.positions[i] = glm::vec3(position(generator), position(generator), position(generator));
+        inputs.rotations[i] = glm::normalize(glm::quat(component(generator), component(generator),
+                                                       component(generator), component(generator)));
+        inputs.scales[i] = glm::vec3(scale(generator), scale(generator), scale(generator));
+    }
+
+    return inputs;
+}
+
+
+static float MaxDifference(const glm::mat4 &a, const glm::mat4 &b)
+{
+    float result = 0.0F;
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            result = std::fmax(result, std::fabs(a[c][r] - b[c][r]));
+        }
+    }
+    return result;
+}
+
+
+// Compares the scalar path with the matrices built by gfxc::Transform
+static bool CheckScalarPath(const Inputs &inputs, unsigned int count)
+{
+    std::vector<glm::mat4> models(count);
+    gfxc::ComposeModels(SimdPath::SCALAR, inputs.positions.data(), inputs.rotations.data(),
+                        inputs.scales.data(), models.data(), count);
+
+    gfxc::Transform transform;
+    unsigned int exact = 0;
+    float maxDifference = 0.0F;
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        transform.SetWorldRotationAndScale(inputs.rotations[i], inputs.scales[i]);
+        transform.SetWorldPosition(inputs.positions[i]);
+
+        const float difference = MaxDifference(transform.GetModel(), models[i]);
+        maxDifference = std::fmax(maxDifference, difference);
+        exact += (difference == 0.0F) ? 1 : 0;
+    }
+
+    printf("%-8s vs Transform: %u/%u exact, max difference %g\n", "scalar", exact, count, maxDifference);
+    return maxDifference <= TOLERANCE;
+}
+
+
+// Compares a SIMD path with the scalar one
+static bool CheckPath(SimdPath path, const Inputs &inputs, unsigned int count)
+{
+    std::vector<glm::mat4> expected(count);
+    std::vector<glm::mat4> models(count);
+
+    gfxc::ComposeModels(SimdPath::SCALAR, inputs.positions.data(), inputs.rotations.data(),
+                        inputs.scales.data(), expected.data(), count);
+    gfxc::ComposeModels(path, inputs.positions.data(), inputs.rotations.data(),
+                        inputs.scales.data(), models.data(), count);
+
+    unsigned int exact = 0;
+    float maxDifference = 0.0F;
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        const float difference = MaxDifference(expected[i], models[i]);
+        maxDifference = std::fmax(maxDifference, difference);
+        exact += (difference == 0.0F) ? 1 : 0;
+    }
+
+    printf("%-8s vs scalar:    %u/%u exact, max difference %g\n", GetSimdPathName(path), exact, count, maxDifference);
+    return maxDifference <= TOLERANCE;
+}
+
+
+int main(int argc, char **argv)
+{
+    const unsigned int count = bench::GetArg(argc, argv, "count", 100000);
+    const unsigned int iterations = bench::GetArg(argc, argv, "iterations", 100);
+    const unsigned int checkCount = bench::GetArg(argc, argv, "check", 10007);
+
+    const SimdPath paths[] = { SimdPath::SCALAR, SimdPath::SSE2, SimdPath::AVX2, SimdPath::NEON };
+
+    // An odd count also covers the scalar tail of the SIMD loops
+    const Inputs checkInputs = GenerateInputs(checkCount);
+    bool valid = CheckScalarPath(checkInputs, checkCount);
+
+    for (SimdPath path : paths)
+    {
+        if (path != SimdPath::SCALAR && IsSimdPathSupported(path)) {
+            valid = CheckPath(path, checkInputs, checkCount) && valid;
+        }
+    }
+
+    if (!valid)
+    {
+        printf("ComposeModels diverges from the reference\n");
+        return 1;
+    }
+
+    const Inputs inputs = GenerateInputs(count);
+    std::vector<glm::mat4> models(count);
+
+    printf("\n%-8s %10s %12s %14s %10s\n", "path", "matrices", "ms/batch", "ns/matrix", "speedup");
+
+    double scalarMs = 0.0;
+    for (SimdPath path : paths)
+    {
+        if (!IsSimdPathSupported(path)) {
+            continue;
+        }
+
+        const double ms = bench::MeasureMs([&]()
+        {
+            gfxc::ComposeModels(path, inputs.positions.data(), inputs.rotations.data(),
+                                inputs.scales.data(), models.data(), count);
+            bench::DoNotOptimize(models[count / 2]);
+        }, iterations);
+
+        if (path == SimdPath::SCALAR) {
+            scalarMs = ms;
+        }
+
+        printf("%-8s %10u %12.4f %14.3f %9.2fx\n", GetSimdPathName(path), count, ms,
+               ms * 1e6 / count, scalarMs / ms);
+    }
+
+    printf("\nDefault path: %s\n", GetSimdPathName(GetBestSimdPath()));
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "benchmarks/bench_utils.h"
+#include "components/transform.h"
+
+
+/*
+ *  Compares the eager and the lazy update modes of gfxc::Transform.
+ *
+ *  Each simulated frame moves and rotates the root of the hierarchy, then
+ *  reads the model matrix of every node, as a renderer would. In eager mode
+ *  each setter walks the whole subtree; in lazy mode the subtree is only
+ *  marked and resolved once, by FlushHierarchy().
+ *
+ *  After the timed frames, the model matrices of the two modes are compared
+ *  node by node. The benchmark fails if they differ by more than
+ *  --tolerance, relative to the length of the columns.
+ */
+
+
+enum class Shape
+{
+    DEEP,       // a single chain, every node is the parent of the next one
+    WIDE,       // a root with all the other nodes as direct children
+    TREE,       // a tree where every node has 4 children
+};
+
+
+static const char *GetShapeName(Shape shape)
+{
+    switch (shape) {
+    case Shape::DEEP:   return "deep";
+    case Shape::WIDE:   return "wide";
+    case Shape::TREE:   return "tree";
+    }
+    return "";
+}
+
+
+static std::vector<gfxc::Transform *> BuildHierarchy(Shape shape, unsigned int nodeCount, bool lazy)
+{
+    std::vector<gfxc::Transform *> nodes;
+    nodes.reserve(nodeCount);
+
+    for (unsigned int i = 0; i < nodeCount; i++)
+    {
+        gfxc::Transform *node = new gfxc::Transform();
+        node->SetWorldRotation(glm::quat(1.0F, 0.0F, 0.0F, 0.0F));
+        nodes.push_back(node);
+    }
+
+    nodes[0]->SetLazyUpdate(lazy);
+
+    for (unsigned int i = 1; i < nodeCount; i++)
+    {
+        unsigned int parent = 0;
+        switch (shape) {
+        case Shape::DEEP:   parent = i - 1;         break;
+        case Shape::WIDE:   parent = 0;             break;
+        case Shape::TREE:   parent = (i - 1) / 4;   break;
+        }
+
+        nodes[parent]->AddChild(nodes[i]);
+        nodes[i]->SetLocalPosition(glm::vec3(0.0F, 0.1F, 0.0F));
+    }
+
+    return nodes;
+}
+
+
+static double RunFrames(std::vector<gfxc::Transform *> &nodes, unsigned int frames)
+{
+    gfxc::Transform *root = nodes[0];
+    float time = 0.0F;
+
+    return bench::MeasureMs([&]()
+    {
+        time += 0.016F;
+        root->SetWorldPosition(glm::vec3(std::sin(time), 0.0F, std::cos(time)));
+        root->SetWorldRotation(glm::quat(glm::vec3(0.0F, time, 0.0F)));
+
+        if (root->GetLazyUpdate())
+        {
+            root->FlushHierarchy();
+        }
+
+        for (gfxc::Transform *node : nodes)
+        {
+            bench::DoNotOptimize(node->GetModel());
+        }
+    }, frames);
+}
+
+
+// Largest difference between the model matrices of the same nodes
+static float GetModelError(std::vector<gfxc::Transform *> &eager, std::vector<gfxc::Transform *> &lazy)
+{
+    float error = 0.0F;
+    for (unsigned int i = 0; i < eager.size(); i++)
+    {
+        const glm::mat4 &eagerModel = eager[i]->GetModel();
+        const glm::mat4 &lazyModel = lazy[i]->GetModel();
+        for (int c = 0; c < 4; c++)
+        {
+            const glm::vec4 column = glm::abs(eagerModel[c] - lazyModel[c]) / std::max(1.0F, glm::length(eagerModel[c]));
+            error = std::max(error, std::max(std::max(column.x, column.y), std::max(column.z, column.w)));
+        }
+    }
+    return error;
+}
+
+
+int main(int argc, char **argv)
+{
+    const unsigned int frames = bench::GetArg(argc, argv, "frames", 100);
+    const unsigned int deepCount = bench::GetArg(argc, argv, "deep", 2000);
+    const unsigned int wideCount = bench::GetArg(argc, argv, "wide", 100000);
+    const unsigned int treeCount = bench::GetArg(argc, argv, "tree", 100000);
+    const float tolerance = static_cast<float>(bench::GetDoubleArg(argc, argv, "tolerance", 1e-3));
+
+    printf("%-6s %10s %14s %14s %10s %12s\n", "shape", "nodes", "eager ms/frame", "lazy ms/frame", "speedup", "model error");
+    bool matching = true;
+
+    const Shape shapes[] = { Shape::DEEP, Shape::WIDE, Shape::TREE };
+    const unsigned int counts[] = { deepCount, wideCount, treeCount };
+
+    for (unsigned int s = 0; s < 3; s++)
+    {
+        double results[2];
+        std::vector<gfxc::Transform *> nodes[2];
+
+        for (int lazy = 0; lazy < 2; lazy++)
+        {
+            nodes[lazy] = BuildHierarchy(shapes[s], counts[s], lazy != 0);
+            results[lazy] = RunFrames(nodes[lazy], frames);
+        }
+
+        // Both modes ran the same frames, so they must agree up to rounding
+        const float error = GetModelError(nodes[0], nodes[1]);
+        matching = matching && error <= tolerance;
+
+        printf("%-6s %10u %14.4f %14.4f %9.2fx %12.3g\n", GetShapeName(shapes[s]), counts[s],
+               results[0], results[1], results[0] / results[1], error);
+
+        for (int lazy = 0; lazy < 2; lazy++)
+        {
+            for (gfxc::Transform *node : nodes[lazy]) {
+                delete node;
+            }
+        }
+    }
+
+    if (!matching)
+    {
+        printf("the eager and lazy model matrices differ by more than %g\n", tolerance);
+        return 1;
+    }
+
+    return 0;
+}
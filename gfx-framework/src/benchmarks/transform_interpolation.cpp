@@ -0,0 +1,160 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "benchmarks/bench_utils.h"
+#include "components/transform.h"
+#include "components/transform_snapshots.h"
+
+
+/*
+ *  Compares a loop that simulates every rendered frame, with a variable
+ *  delta time, with one that simulates at a fixed rate and renders the
+ *  state interpolated by gfxc::TransformSnapshots, as done by World when a
+ *  fixed time step is set.
+ *
+ *  Both loops render the same number of frames at the display rate and
+ *  produce one model matrix per object and frame. Before timing, the
+ *  interpolated models are checked against GetModel() at both ends of a
+ *  step.
+ */
+
+
+static std::vector<gfxc::Transform *> BuildScene(unsigned int count)
+{
+    std::vector<gfxc::Transform *> nodes(count);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        nodes[i] = new gfxc::Transform();
+        nodes[i]->SetWorldRotation(glm::quat(glm::vec3(0.1F * i, 0.2F, 0.0F)));
+        nodes[i]->SetWorldPosition(glm::vec3(1.0F * (i % 100), 0.0F, 1.0F * (i / 100)));
+        nodes[i]->SetScale(glm::vec3(1.0F + 0.01F * (i % 10), 2.0F, 0.5F));
+    }
+    return nodes;
+}
+
+
+static void DestroyScene(std::vector<gfxc::Transform *> &nodes)
+{
+    for (gfxc::Transform *node : nodes) {
+        delete node;
+    }
+}
+
+
+static void Simulate(std::vector<gfxc::Transform *> &nodes, float deltaTime)
+{
+    for (gfxc::Transform *node : nodes)
+    {
+        node->RotateLocalOY(deltaTime);
+        node->Move(node->GetLocalOZVector(), deltaTime);
+    }
+}
+
+
+static float MaxDifference(const glm::mat4 &a, const glm::mat4 &b)
+{
+    float diff = 0.0F;
+    for (int c = 0; c < 4; c++) {
+        for (int r = 0; r < 4; r++) {
+            diff = std::fmax(diff, std::fabs(a[c][r] - b[c][r]));
+        }
+    }
+    return diff;
+}
+
+
+int main(int argc, char **argv)
+{
+    const unsigned int frames = bench::GetArg(argc, argv, "frames", 1440);
+    const unsigned int count = bench::GetArg(argc, argv, "count", 10000);
+    const double renderRate = bench::GetDoubleArg(argc, argv, "render-rate", 144.0);
+    const double tolerance = bench::GetDoubleArg(argc, argv, "tolerance", 1e-4);
+
+    const double simulationRates[] = { 20.0, 30.0, 60.0, 144.0 };
+    const double frameTime = 1.0 / renderRate;
+
+    std::vector<glm::mat4> models(count);
+
+    // Interpolation check, on a single step
+    {
+        std::vector<gfxc::Transform *> nodes = BuildScene(count);
+        gfxc::TransformSnapshots snapshots;
+        for (gfxc::Transform *node : nodes) {
+            snapshots.Add(node);
+        }
+
+        std::vector<glm::mat4> before(count);
+        for (unsigned int i = 0; i < count; i++) {
+            before[i] = nodes[i]->GetModel();
+        }
+
+        Simulate(nodes, 0.05F);
+        snapshots.Capture();
+
+        float diff = 0.0F;
+        snapshots.Interpolate(0.0F, models.data());
+        for (unsigned int i = 0; i < count; i++) {
+            diff = std::fmax(diff, MaxDifference(models[i], before[i]));
+        }
+        snapshots.Interpolate(1.0F, models.data());
+        for (unsigned int i = 0; i < count; i++)
+        {
+            diff = std::fmax(diff, MaxDifference(models[i], nodes[i]->GetModel()));
+            diff = std::fmax(diff, MaxDifference(models[i], snapshots.Interpolate(i, 1.0F)));
+        }
+
+        DestroyScene(nodes);
+        if (diff > tolerance)
+        {
+            printf("interpolated models differ from GetModel() by %g\n", diff);
+            return 1;
+        }
+    }
+
+    printf("%10s %12s %12s %18s %18s %12s\n", "objects", "render Hz", "sim Hz", "lockstep ms/frame", "fixed ms/frame", "steps");
+
+    for (double simulationRate : simulationRates)
+    {
+        const double step = 1.0 / simulationRate;
+
+        std::vector<gfxc::Transform *> nodes = BuildScene(count);
+        const double lockstepMs = bench::MeasureMs([&]()
+        {
+            Simulate(nodes, static_cast<float>(frameTime));
+            for (unsigned int i = 0; i < count; i++) {
+                models[i] = nodes[i]->GetModel();
+            }
+            bench::DoNotOptimize(models.data());
+        }, frames);
+        DestroyScene(nodes);
+
+        nodes = BuildScene(count);
+        gfxc::TransformSnapshots snapshots;
+        for (gfxc::Transform *node : nodes) {
+            snapshots.Add(node);
+        }
+
+        // Same accumulator as World::FixedStepUpdate
+        double accumulator = 0.0;
+        unsigned int steps = 0;
+        const double fixedMs = bench::MeasureMs([&]()
+        {
+            accumulator += frameTime;
+            while (accumulator >= step)
+            {
+                Simulate(nodes, static_cast<float>(step));
+                snapshots.Capture();
+                accumulator -= step;
+                steps++;
+            }
+            snapshots.Interpolate(static_cast<float>(accumulator / step), models.data());
+            bench::DoNotOptimize(models.data());
+        }, frames, 0);
+        DestroyScene(nodes);
+
+        printf("%10u %12.0f %12.0f %18.3f %18.3f %12u\n", count, renderRate, simulationRate, lockstepMs, fixedMs, steps);
+    }
+
+    return 0;
+}
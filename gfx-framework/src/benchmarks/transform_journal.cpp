@@ -0,0 +1,150 @@
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "benchmarks/bench_utils.h"
+#include "components/transform.h"
+#include "components/transform_journal.h"
+
+
+/*
+ *  Compares uploading the model matrix of every object each frame with
+ *  uploading only the ranges recorded in a gfxc::TransformJournal, as done
+ *  by ModelMatrixBuffer::Upload.
+ *
+ *  There is no OpenGL context here, so the GPU buffer is a plain array and
+ *  every glBufferSubData call is a memcpy. Each frame moves a fixed
+ *  fraction of the objects. The journal path is checked against the full
+ *  upload before timing.
+ */
+
+
+struct Scene
+{
+    std::vector<gfxc::Transform *>  nodes;
+    std::vector<glm::mat4>          gpuMatrices;
+    std::vector<glm::mat4>          localMatrices;
+    std::vector<gfxc::IdRange>      ranges;
+    gfxc::TransformJournal          journal;
+};
+
+
+static void BuildScene(Scene &scene, unsigned int count)
+{
+    scene.gpuMatrices.resize(count);
+    scene.localMatrices.resize(count);
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        gfxc::Transform *node = new gfxc::Transform();
+        node->SetWorldRotation(glm::quat(1.0F, 0.0F, 0.0F, 0.0F));
+        node->SetWorldPosition(glm::vec3(1.0F * (i % 100), 0.0F, 1.0F * (i / 100)));
+        node->SetJournal(&scene.journal, i);
+        scene.nodes.push_back(node);
+    }
+}
+
+
+static void DestroyScene(Scene &scene)
+{
+    for (gfxc::Transform *node : scene.nodes) {
+        delete node;
+    }
+}
+
+
+// Moves `moving` objects spread over the scene, a different set every frame
+static void MoveSome(Scene &scene, unsigned int frame, unsigned int moving)
+{
+    const unsigned int count = static_cast<unsigned int>(scene.nodes.size());
+    const unsigned int stride = count / moving;
+    for (unsigned int i = frame % stride; i < count; i += stride) {
+        scene.nodes[i]->RotateLocalOY(0.016F);
+    }
+}
+
+
+static unsigned int UploadAll(Scene &scene)
+{
+    for (unsigned int i = 0; i < scene.nodes.size(); i++) {
+        scene.gpuMatrices[i] = scene.nodes[i]->GetModel();
+    }
+    scene.journal.Clear();
+    return static_cast<unsigned int>(scene.nodes.size());
+}
+
+
+static unsigned int UploadChanges(Scene &scene)
+{
+    for (gfxc::Transform *node : scene.journal.GetChanges()) {
+        scene.localMatrices[node->GetObjectId()] = node->GetModel();
+    }
+
+    unsigned int uploaded = 0;
+    scene.journal.GetChangedRanges(scene.ranges, 4);
+    for (const gfxc::IdRange &range : scene.ranges)
+    {
+        std::memcpy(&scene.gpuMatrices[range.begin], &scene.localMatrices[range.begin],
+                    (range.end - range.begin) * sizeof(glm::mat4));
+        uploaded += range.end - range.begin;
+    }
+
+    scene.journal.Clear();
+    return uploaded;
+}
+
+
+int main(int argc, char **argv)
+{
+    const unsigned int frames = bench::GetArg(argc, argv, "frames", 100);
+    const unsigned int count = bench::GetArg(argc, argv, "count", 100000);
+
+    const unsigned int movingCounts[] = { count, count / 10, count / 100, count / 1000 };
+
+    printf("%10s %10s %16s %16s %16s %10s\n", "objects", "moving", "all ms/frame", "journal ms/frame", "uploaded/frame", "ranges");
+
+    for (unsigned int moving : movingCounts)
+    {
+        Scene scene;
+        BuildScene(scene, count);
+
+        // The first upload sends everything, since every object was recorded
+        // when it was attached to the journal
+        UploadChanges(scene);
+        scene.localMatrices = scene.gpuMatrices;
+
+        MoveSome(scene, 0, moving);
+        UploadChanges(scene);
+        bool matches = true;
+        for (unsigned int i = 0; i < count; i++) {
+            matches = matches and (scene.gpuMatrices[i] == scene.nodes[i]->GetModel());
+        }
+        if (!matches) {
+            printf("journal upload does not match the scene\n");
+            return 1;
+        }
+
+        unsigned int frame = 1;
+        const double allMs = bench::MeasureMs([&]()
+        {
+            MoveSome(scene, frame++, moving);
+            bench::DoNotOptimize(UploadAll(scene));
+        }, frames);
+
+        unsigned long long uploaded = 0;
+        unsigned long long ranges = 0;
+        const double journalMs = bench::MeasureMs([&]()
+        {
+            MoveSome(scene, frame++, moving);
+            uploaded += UploadChanges(scene);
+            ranges += scene.ranges.size();
+        }, frames, 0);
+
+        printf("%10u %10u %16.3f %16.3f %16llu %10llu\n", count, moving, allMs, journalMs,
+               uploaded / frames, ranges / frames);
+
+        DestroyScene(scene);
+    }
+
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "benchmarks/bench_utils.h"
+#include "components/transform.h"
+
+#include "glm/gtc/matrix_inverse.hpp"
+
+
+/*
+ *  Compares a renderer that rebuilds the normal matrix of every transform
+ *  each frame with one that uses the cached Transform::GetNormalMatrix and
+ *  skips the transforms whose model version did not change.
+ *
+ *  Each frame moves a fixed fraction of the transforms. Before timing, the
+ *  cached matrices are checked against the ones computed from GetModel().
+ */
+
+
+static std::vector<gfxc::Transform *> BuildScene(unsigned int count)
+{
+    std::vector<gfxc::Transform *> nodes(count);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        nodes[i] = new gfxc::Transform();
+        nodes[i]->SetWorldRotation(glm::quat(glm::vec3(0.1F * i, 0.2F, 0.0F)));
+        nodes[i]->SetWorldPosition(glm::vec3(1.0F * (i % 100), 0.0F, 1.0F * (i / 100)));
+        nodes[i]->SetScale(glm::vec3(1.0F + 0.01F * (i % 10), 2.0F, 0.5F));
+    }
+    return nodes;
+}
+
+
+static void MoveSome(std::vector<gfxc::Transform *> &nodes, unsigned int frame, unsigned int stride)
+{
+    for (unsigned int i = frame % stride; i < nodes.size(); i += stride) {
+        nodes[i]->RotateLocalOY(0.016F);
+    }
+}
+
+
+static float CheckCache(std::vector<gfxc::Transform *> &nodes)
+{
+    float difference = 0.0F;
+    for (gfxc::Transform *node : nodes)
+    {
+        const glm::mat4 &model = node->GetModel();
+        const glm::mat4 inverse = glm::inverse(model);
+        const glm::mat3 normal = glm::inverseTranspose(glm::mat3(model));
+
+        for (int c = 0; c < 4; c++)
+        {
+            const glm::vec4 column = glm::abs(inverse[c] - node->GetInverseModel()[c]);
+            difference = glm::max(difference, glm::max(glm::max(column.x, column.y), glm::max(column.z, column.w)));
+        }
+        for (int c = 0; c < 3; c++)
+        {
+            const glm::vec3 column = glm::abs(normal[c] - node->GetNormalMatrix()[c]);
+            difference = glm::max(difference, glm::max(column.x, glm::max(column.y, column.z)));
+        }
+    }
+    return difference;
+}
+
+
+int main(int argc, char **argv)
+{
+    const unsigned int frames = bench::GetArg(argc, argv, "frames", 100);
+    const unsigned int count = bench::GetArg(argc, argv, "count", 100000);
+
+    // One in `stride` transforms moves every frame
+    const unsigned int strides[] = { 1, 10, 100 };
+
+    printf("%10s %10s %18s %18s %10s %12s\n", "transforms", "moving", "rebuild ms/frame", "cached ms/frame", "uploads", "max diff");
+
+    for (unsigned int stride : strides)
+    {
+        std::vector<gfxc::Transform *> nodes = BuildScene(count);
+
+        MoveSome(nodes, 0, stride);
+        const float difference = CheckCache(nodes);
+
+        // Stand-in for the GPU upload of the model and normal matrices
+        std::vector<glm::mat4> models(count);
+        std::vector<glm::mat3> normals(count);
+        std::vector<std::uint64_t> versions(count);
+        unsigned int frame = 1;
+        unsigned long long uploads = 0;
+
+        const double rebuildMs = bench::MeasureMs([&]()
+        {
+            MoveSome(nodes, frame++, stride);
+            for (unsigned int i = 0; i < count; i++)
+            {
+                models[i] = nodes[i]->GetModel();
+                normals[i] = glm::inverseTranspose(glm::mat3(models[i]));
+            }
+            bench::DoNotOptimize(normals);
+        }, frames);
+
+        for (unsigned int i = 0; i < count; i++) {
+            versions[i] = nodes[i]->GetModelVersion();
+        }
+
+        const double cachedMs = bench::MeasureMs([&]()
+        {
+            MoveSome(nodes, frame++, stride);
+            for (unsigned int i = 0; i < count; i++)
+            {
+                const std::uint64_t version = nodes[i]->GetModelVersion();
+                if (version != versions[i])
+                {
+                    models[i] = nodes[i]->GetModel();
+                    normals[i] = nodes[i]->GetNormalMatrix();
+                    versions[i] = version;
+                    uploads++;
+                }
+            }
+            bench::DoNotOptimize(normals);
+        }, frames, 0);
+
+        printf("%10u %10u %18.3f %18.3f %10llu %12.3g\n", count, count / stride,
+               rebuildMs, cachedMs, uploads / frames, difference);
+
+        for (gfxc::Transform *node : nodes) {
+            delete node;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,201 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "benchmarks/bench_utils.h"
+#include "components/transform.h"
+
+
+/*
+ *  Compares the single element setters of gfxc::Transform, called once per
+ *  transform, with the batched Transform::SetWorldPositions,
+ *  SetWorldRotations and MoveAll.
+ *
+ *  Each frame changes every transform of the batch. Three scene shapes are
+ *  used: transforms without children, groups where only the parents are in
+ *  the batch, and a 4-ary tree where every node is in the batch. Before
+ *  timing, both paths are run on copies of the scene and their results are
+ *  compared.
+ */
+
+
+enum class Shape
+{
+    FLAT,       // transforms without children
+    GROUPS,     // parents with 8 children each, only the parents are changed
+    TREE,       // a tree where every node has 4 children, all are changed
+};
+
+
+static const char *GetShapeName(Shape shape)
+{
+    switch (shape) {
+    case Shape::FLAT:   return "flat";
+    case Shape::GROUPS: return "groups";
+    case Shape::TREE:   return "tree";
+    }
+    return "";
+}
+
+
+struct Scene
+{
+    std::vector<gfxc::Transform *>  nodes;
+    std::vector<gfxc::Transform *>  batch;
+};
+
+
+static void BuildScene(Scene &scene, Shape shape, unsigned int batchSize)
+{
+    const unsigned int nodeCount = (shape == Shape::GROUPS) ? batchSize * 9 : batchSize;
+
+    for (unsigned int i = 0; i < nodeCount; i++)
+    {
+        gfxc::Transform *node = new gfxc::Transform();
+        node->SetWorldRotation(glm::quat(1.0F, 0.0F, 0.0F, 0.0F));
+
+        switch (shape) {
+        case Shape::FLAT:
+            scene.batch.push_back(node);
+            break;
+        case Shape::GROUPS:
+            if (i < batchSize) {
+                scene.batch.push_back(node);
+            } else {
+                scene.nodes[(i - batchSize) / 8]->AddChild(node);
+            }
+            break;
+        case Shape::TREE:
+            if (i > 0) {
+                scene.nodes[(i - 1) / 4]->AddChild(node);
+            }
+            scene.batch.push_back(node);
+            break;
+        }
+
+        node->SetLocalPosition(glm::vec3(0.1F * (i % 7), 0.2F, 0.1F * (i % 5)));
+        scene.nodes.push_back(node);
+    }
+}
+
+
+static void DestroyScene(Scene &scene)
+{
+    for (gfxc::Transform *node : scene.nodes) {
+        delete node;
+    }
+}
+
+
+static void FillFrame(unsigned int frame, unsigned int count, std::vector<glm::vec3> &positions, std::vector<glm::quat> &rotations)
+{
+    const float time = 0.016F * frame;
+    for (unsigned int i = 0; i < count; i++)
+    {
+        positions[i] = glm::vec3(std::sin(time + i), 0.5F * (i % 3), std::cos(time + i));
+        rotations[i] = glm::quat(glm::vec3(0.0F, time + 0.01F * i, 0.0F));
+    }
+}
+
+
+static void RunSingle(Scene &scene, const std::vector<glm::vec3> &positions, const std::vector<glm::quat> &rotations)
+{
+    const unsigned int count = static_cast<unsigned int>(scene.batch.size());
+    for (unsigned int i = 0; i < count; i++) {
+        scene.batch[i]->SetWorldPosition(positions[i]);
+    }
+    for (unsigned int i = 0; i < count; i++) {
+        scene.batch[i]->SetWorldRotation(rotations[i]);
+    }
+    for (unsigned int i = 0; i < count; i++) {
+        scene.batch[i]->Move(glm::vec3(1.0F, 0.0F, 1.0F), 0.016F);
+    }
+}
+
+
+static void RunBatched(Scene &scene, const std::vector<glm::vec3> &positions, const std::vector<glm::quat> &rotations)
+{
+    const unsigned int count = static_cast<unsigned int>(scene.batch.size());
+    gfxc::Transform::SetWorldPositions(scene.batch.data(), positions.data(), count);
+    gfxc::Transform::SetWorldRotations(scene.batch.data(), rotations.data(), count);
+    gfxc::Transform::MoveAll(scene.batch.data(), count, glm::vec3(1.0F, 0.0F, 1.0F), 0.016F);
+}
+
+
+static float GetMaxDifference(Scene &a, Scene &b)
+{
+    float difference = 0.0F;
+    for (unsigned int i = 0; i < a.nodes.size(); i++)
+    {
+        const glm::mat4 &modelA = a.nodes[i]->GetModel();
+        const glm::mat4 &modelB = b.nodes[i]->GetModel();
+        for (int c = 0; c < 4; c++)
+        {
+            const glm::vec4 column = glm::abs(modelA[c] - modelB[c]);
+            difference = glm::max(difference, glm::max(glm::max(column.x, column.y), glm::max(column.z, column.w)));
+        }
+    }
+    return difference;
+}
+
+
+int main(int argc, char **argv)
+{
+    const unsigned int frames = bench::GetArg(argc, argv, "frames", 50);
+    const unsigned int batchSize = bench::GetArg(argc, argv, "count", 10000);
+
+    const Shape shapes[] = { Shape::FLAT, Shape::GROUPS, Shape::TREE };
+
+#if defined(GFXC_TRANSFORM_FINAL)
+    printf("gfxc::Transform is final\n");
+#endif
+    printf("%8s %10s %16s %16s %10s %12s\n", "shape", "batch", "single ns/elem", "batched ns/elem", "speedup", "max diff");
+
+    for (Shape shape : shapes)
+    {
+        std::vector<glm::vec3> positions(batchSize);
+        std::vector<glm::quat> rotations(batchSize);
+
+        // Check that both paths place the transforms at the same spot
+        float difference = 0.0F;
+        {
+            Scene single, batched;
+            BuildScene(single, shape, batchSize);
+            BuildScene(batched, shape, batchSize);
+
+            for (unsigned int frame = 0; frame < 3; frame++)
+            {
+                FillFrame(frame, batchSize, positions, rotations);
+                RunSingle(single, positions, rotations);
+                RunBatched(batched, positions, rotations);
+            }
+            difference = GetMaxDifference(single, batched);
+
+            DestroyScene(single);
+            DestroyScene(batched);
+        }
+
+        Scene scene;
+        BuildScene(scene, shape, batchSize);
+        FillFrame(0, batchSize, positions, rotations);
+
+        const double singleMs = bench::MeasureMs([&]()
+        {
+            RunSingle(scene, positions, rotations);
+        }, frames);
+
+        const double batchedMs = bench::MeasureMs([&]()
+        {
+            RunBatched(scene, positions, rotations);
+        }, frames);
+
+        // Three operations per transform and frame
+        const double elements = 3.0 * batchSize;
+        printf("%8s %10u %16.1f %16.1f %9.2fx %12.3g\n", GetShapeName(shape), batchSize,
+               singleMs * 1e6 / elements, batchedMs * 1e6 / elements, singleMs / batchedMs, difference);
+
+        DestroyScene(scene);
+    }
+
+    return 0;
+}
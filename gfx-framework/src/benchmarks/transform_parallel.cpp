@@ -0,0 +1,206 @@
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "benchmarks/bench_utils.h"
+#include "components/transform.h"
+#include "components/transform_system.h"
+#include "components/worker_pool.h"
+#include "utils/math_utils.h"
+
+
+/*
+ *  Compares the recursive update of a gfxc::Transform tree with the update
+ *  of the same tree stored in a gfxc::TransformSystem, on 1 to N threads.
+ *
+ *  Each simulated frame rotates the root of the hierarchy, then gets the
+ *  model matrix of every node. Before timing, the parallel update is checked
+ *  against the single threaded TransformSystem::Update().
+ */
+
+
+enum class Shape
+{
+    WIDE,       // a root with all the other nodes as direct children
+    TREE,       // a tree where every node has 4 children
+    RANDOM,     // every node is the child of a random earlier node
+};
+
+
+static const char *GetShapeName(Shape shape)
+{
+    switch (shape) {
+    case Shape::WIDE:   return "wide";
+    case Shape::TREE:   return "tree";
+    case Shape::RANDOM: return "random";
+    }
+    return "";
+}
+
+
+// Parent of every node, the root comes first and has no parent
+static std::vector<unsigned int> BuildParents(Shape shape, unsigned int nodeCount)
+{
+    std::mt19937 generator(1234U);
+    std::vector<unsigned int> parents(nodeCount, 0U);
+
+    for (unsigned int i = 1; i < nodeCount; i++)
+    {
+        switch (shape) {
+        case Shape::WIDE:   parents[i] = 0;                     break;
+        case Shape::TREE:   parents[i] = (i - 1) / 4;           break;
+        case Shape::RANDOM: parents[i] = generator() % i;       break;
+        }
+    }
+
+    return parents;
+}
+
+
+static glm::vec3 GetLocalPosition(unsigned int index)
+{
+    return glm::vec3(0.1F * (index % 7), 0.2F, 0.1F * (index % 5));
+}
+
+
+static double RunRecursive(const std::vector<unsigned int> &parents, unsigned int frames)
+{
+    const unsigned int nodeCount = static_cast<unsigned int>(parents.size());
+    std::vector<gfxc::Transform *> nodes(nodeCount);
+
+    for (unsigned int i = 0; i < nodeCount; i++)
+    {
+        nodes[i] = new gfxc::Transform();
+        nodes[i]->SetWorldRotation(glm::quat(1.0F, 0.0F, 0.0F, 0.0F));
+        if (i > 0)
+        {
+            nodes[parents[i]]->AddChild(nodes[i]);
+            nodes[i]->SetLocalPosition(GetLocalPosition(i));
+        }
+    }
+
+    float time = 0.0F;
+    const double ms = bench::MeasureMs([&]()
+    {
+        time += 0.016F;
+        nodes[0]->SetWorldRotation(glm::quat(glm::vec3(0.0F, time, 0.0F)));
+
+        for (gfxc::Transform *node : nodes)
+        {
+            bench::DoNotOptimize(node->GetModel());
+        }
+    }, frames);
+
+    for (gfxc::Transform *node : nodes)
+    {
+        delete node;
+    }
+
+    return ms;
+}
+
+
+static void BuildSystem(gfxc::TransformSystem &system, const std::vector<unsigned int> &parents)
+{
+    const unsigned int nodeCount = static_cast<unsigned int>(parents.size());
+    std::vector<gfxc::TransformHandle> handles(nodeCount);
+
+    system.Reserve(nodeCount);
+    for (unsigned int i = 0; i < nodeCount; i++)
+    {
+        handles[i] = system.Create(i > 0 ? handles[parents[i]] : gfxc::INVALID_TRANSFORM);
+        if (i > 0)
+        {
+            system.SetLocalPosition(handles[i], GetLocalPosition(i));
+        }
+    }
+}
+
+
+// Moves the root, then updates with and without the pool. The two systems
+// must end up with exactly the same matrices.
+static bool CheckParallel(const std::vector<unsigned int> &parents, gfxc::WorkerPool &pool)
+{
+    gfxc::TransformSystem single, parallel;
+    BuildSystem(single, parents);
+    BuildSystem(parallel, parents);
+
+    for (unsigned int frame = 0; frame < 3; frame++)
+    {
+        const glm::quat rotation = glm::quat(glm::vec3(0.1F * frame, 0.3F * frame, 0.0F));
+        single.SetRelativeRotation(0, rotation);
+        parallel.SetRelativeRotation(0, rotation);
+
+        const unsigned int expected = single.Update();
+        if (parallel.Update(pool) != expected)
+        {
+            return false;
+        }
+
+        for (gfxc::TransformHandle handle = 0; handle < parents.size(); handle++)
+        {
+            if (single.GetModel(handle) != parallel.GetModel(handle))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+static double RunSystem(const std::vector<unsigned int> &parents, gfxc::WorkerPool &pool, unsigned int frames)
+{
+    gfxc::TransformSystem system;
+    BuildSystem(system, parents);
+    system.Update(pool);
+
+    float time = 0.0F;
+    return bench::MeasureMs([&]()
+    {
+        time += 0.016F;
+        system.SetRelativeRotation(0, glm::quat(glm::vec3(0.0F, time, 0.0F)));
+        system.Update(pool);
+        bench::DoNotOptimize(system.GetModels()[parents.size() - 1]);
+    }, frames);
+}
+
+
+int main(int argc, char **argv)
+{
+    const unsigned int frames = bench::GetArg(argc, argv, "frames", 10);
+    const unsigned int maxNodes = bench::GetArg(argc, argv, "max", 1000000);
+    const unsigned int maxThreads = bench::GetArg(argc, argv, "threads", MAX(1U, std::thread::hardware_concurrency()));
+
+    const Shape shapes[] = { Shape::WIDE, Shape::TREE, Shape::RANDOM };
+
+    printf("%-7s %8s %8s %14s %14s %10s\n", "shape", "nodes", "threads", "recursive ms", "system ms", "speedup");
+
+    for (Shape shape : shapes)
+    {
+        for (unsigned int nodeCount = 10000; nodeCount <= maxNodes; nodeCount *= 10)
+        {
+            const std::vector<unsigned int> parents = BuildParents(shape, nodeCount);
+            const double recursiveMs = RunRecursive(parents, frames);
+
+            for (unsigned int threads = 1; threads <= maxThreads; threads++)
+            {
+                gfxc::WorkerPool pool(threads);
+
+                if (!CheckParallel(parents, pool))
+                {
+                    printf("The parallel update diverges on %s/%u with %u threads\n", GetShapeName(shape), nodeCount, threads);
+                    return 1;
+                }
+
+                const double systemMs = RunSystem(parents, pool, frames);
+                printf("%-7s %8u %8u %14.3f %14.3f %9.2fx\n", GetShapeName(shape), nodeCount, threads,
+                       recursiveMs, systemMs, recursiveMs / systemMs);
+            }
+        }
+    }
+
+    return 0;
+}
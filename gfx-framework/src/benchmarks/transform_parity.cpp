@@ -0,0 +1,615 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <dlfcn.h>
+
+#include "benchmarks/bench_utils.h"
+#include "components/transform.h"
+
+
+/*
+ *  Compares the in-tree gfxc::Transform with the one from the prebuilt
+ *  GFXComponents library, which is loaded at run time with dlopen.
+ *
+ *  Both implementations are driven through the same randomized stream of
+ *  operations: setters, rotations, AddChild/RemoveChild and GetModel. The
+ *  stream is run twice. The first run measures the latency of every kind
+ *  of operation, the second one compares the world position, the world
+ *  rotation and the model matrix of every node after each operation.
+ *
+ *  The memory layout of the prebuilt class is not the one of our header,
+ *  so its objects live in opaque storage and its methods are called
+ *  through their mangled names, with the object as the first argument.
+ */
+
+
+#ifndef GFXF_REFERENCE_LIBRARY
+#   define GFXF_REFERENCE_LIBRARY "GFXComponents.so"
+#endif
+
+
+// The prebuilt methods take and return these by value, so they must be
+// passed in registers exactly like in the library
+static_assert(std::is_trivially_copyable<glm::vec3>::value, "glm::vec3 must be trivially copyable");
+static_assert(std::is_trivially_copyable<glm::quat>::value, "glm::quat must be trivially copyable");
+
+
+enum class OpKind
+{
+    SET_LOCAL_POSITION,
+    SET_WORLD_POSITION,
+    SET_WORLD_ROTATION,
+    SET_WORLD_ROTATION_EULER,
+    SET_RELATIVE_ROTATION,
+    SET_SCALE,
+    MOVE,
+    ROTATE_WORLD_OX,
+    ROTATE_WORLD_OY,
+    ROTATE_WORLD_OZ,
+    ROTATE_LOCAL_OX,
+    ROTATE_LOCAL_OY,
+    ROTATE_LOCAL_OZ,
+    ADD_CHILD,
+    REMOVE_CHILD,
+    GET_MODEL,
+    COUNT
+};
+
+
+static const unsigned int kOpKindCount = static_cast<unsigned int>(OpKind::COUNT);
+
+
+static const char *GetOpName(OpKind kind)
+{
+    switch (kind) {
+    case OpKind::SET_LOCAL_POSITION:        return "SetLocalPosition";
+    case OpKind::SET_WORLD_POSITION:        return "SetWorldPosition";
+    case OpKind::SET_WORLD_ROTATION:        return "SetWorldRotation";
+    case OpKind::SET_WORLD_ROTATION_EULER:  return "SetWorldRotation(euler)";
+    case OpKind::SET_RELATIVE_ROTATION:     return "SetReleativeRotation";
+    case OpKind::SET_SCALE:                 return "SetScale";
+    case OpKind::MOVE:                      return "Move";
+    case OpKind::ROTATE_WORLD_OX:           return "RotateWorldOX";
+    case OpKind::ROTATE_WORLD_OY:           return "RotateWorldOY";
+    case OpKind::ROTATE_WORLD_OZ:           return "RotateWorldOZ";
+    case OpKind::ROTATE_LOCAL_OX:           return "RotateLocalOX";
+    case OpKind::ROTATE_LOCAL_OY:           return "RotateLocalOY";
+    case OpKind::ROTATE_LOCAL_OZ:           return "RotateLocalOZ";
+    case OpKind::ADD_CHILD:                 return "AddChild";
+    case OpKind::REMOVE_CHILD:              return "RemoveChild";
+    case OpKind::GET_MODEL:                 return "GetModel";
+    case OpKind::COUNT:                     break;
+    }
+    return "";
+}
+
+
+struct Op
+{
+    OpKind          kind;
+    unsigned int    node;
+    unsigned int    parent;     // only used by AddChild and RemoveChild
+    glm::vec3       vector;
+    glm::quat       rotation;
+    float           value;
+};
+
+
+/*
+ *  Operation stream
+ */
+
+
+static glm::vec3 RandomVector(std::mt19937 &generator, float range)
+{
+    std::uniform_real_distribution<float> distribution(-range, range);
+    return glm::vec3(distribution(generator), distribution(generator), distribution(generator));
+}
+
+
+static glm::quat RandomRotation(std::mt19937 &generator)
+{
+    return glm::normalize(glm::quat(RandomVector(generator, glm::pi<float>())));
+}
+
+
+static bool IsInSubtree(const std::vector<int> &parents, unsigned int node, unsigned int root)
+{
+    for (int current = static_cast<int>(node); current >= 0; current = parents[current])
+    {
+        if (current == static_cast<int>(root)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+// Node 0 is the root and is never reparented. Every other node starts as the
+// child of a random earlier node. The parent of detached nodes is -1.
+static std::vector<int> BuildParents(std::mt19937 &generator, unsigned int nodeCount)
+{
+    std::vector<int> parents(nodeCount, -1);
+    for (unsigned int i = 1; i < nodeCount; i++) {
+        parents[i] = static_cast<int>(generator() % i);
+    }
+    return parents;
+}
+
+
+// Scales stay positive and away from zero, since the rotation of a node with
+// a degenerate scale is not meaningful and the implementations may disagree
+static std::vector<Op> BuildStream(std::mt19937 &generator, std::vector<int> parents, unsigned int opCount)
+{
+    const unsigned int nodeCount = static_cast<unsigned int>(parents.size());
+    std::uniform_real_distribution<float> scales(0.5F, 2.0F);
+    std::uniform_real_distribution<float> deltas(0.0F, 0.05F);
+
+    std::vector<Op> ops;
+    ops.reserve(opCount + opCount / 4);
+
+    while (ops.size() < opCount)
+    {
+        Op op;
+        op.kind = static_cast<OpKind>(generator() % kOpKindCount);
+        op.node = generator() % nodeCount;
+        op.parent = 0;
+        op.vector = glm::vec3(0.0F);
+        op.rotation = glm::quat(1.0F, 0.0F, 0.0F, 0.0F);
+        op.value = deltas(generator);
+
+        switch (op.kind) {
+        case OpKind::SET_LOCAL_POSITION:
+        case OpKind::SET_WORLD_POSITION:
+            op.vector = RandomVector(generator, 10.0F);
+            break;
+        case OpKind::SET_WORLD_ROTATION:
+        case OpKind::SET_RELATIVE_ROTATION:
+            op.rotation = RandomRotation(generator);
+            break;
+        case OpKind::SET_WORLD_ROTATION_EULER:
+            op.vector = RandomVector(generator, 180.0F);
+            break;
+        case OpKind::SET_SCALE:
+            op.vector = glm::vec3(scales(generator), scales(generator), scales(generator));
+            break;
+        case OpKind::MOVE:
+            op.vector = glm::normalize(RandomVector(generator, 1.0F) + glm::vec3(0.0F, 0.0F, 1e-3F));
+            break;
+        case OpKind::ADD_CHILD:
+        {
+            // Attach to a node outside of the subtree of the child, detaching
+            // it first so both implementations see the same children lists
+            if (op.node == 0) {
+                continue;
+            }
+            op.parent = generator() % nodeCount;
+            if (IsInSubtree(parents, op.parent, op.node)) {
+                continue;
+            }
+            if (parents[op.node] >= 0)
+            {
+                Op detach = op;
+                detach.kind = OpKind::REMOVE_CHILD;
+                detach.parent = static_cast<unsigned int>(parents[op.node]);
+                ops.push_back(detach);
+            }
+            parents[op.node] = static_cast<int>(op.parent);
+            break;
+        }
+        case OpKind::REMOVE_CHILD:
+            if (parents[op.node] < 0) {
+                continue;
+            }
+            op.parent = static_cast<unsigned int>(parents[op.node]);
+            parents[op.node] = -1;
+            break;
+        default:
+            break;
+        }
+
+        ops.push_back(op);
+    }
+
+    return ops;
+}
+
+
+/*
+ *  Implementations under test. Both expose the same methods on node indices.
+ */
+
+
+class LocalTransforms
+{
+ public:
+    LocalTransforms(const std::vector<int> &parents, bool lazyUpdate)
+        : nodes(parents.size())
+    {
+        for (unsigned int i = 0; i < nodes.size(); i++)
+        {
+            nodes[i] = new gfxc::Transform();
+            nodes[i]->SetLazyUpdate(lazyUpdate);
+            nodes[i]->SetWorldRotation(glm::quat(1.0F, 0.0F, 0.0F, 0.0F));
+        }
+        for (unsigned int i = 0; i < nodes.size(); i++)
+        {
+            if (parents[i] >= 0) {
+                nodes[parents[i]]->AddChild(nodes[i]);
+            }
+        }
+    }
+
+    ~LocalTransforms()
+    {
+        for (gfxc::Transform *node : nodes) {
+            delete node;
+        }
+    }
+
+    void Apply(const Op &op)
+    {
+        gfxc::Transform *node = nodes[op.node];
+
+        switch (op.kind) {
+        case OpKind::SET_LOCAL_POSITION:        node->SetLocalPosition(op.vector);              break;
+        case OpKind::SET_WORLD_POSITION:        node->SetWorldPosition(op.vector);              break;
+        case OpKind::SET_WORLD_ROTATION:        node->SetWorldRotation(op.rotation);            break;
+        case OpKind::SET_WORLD_ROTATION_EULER:  node->SetWorldRotation(op.vector);              break;
+        case OpKind::SET_RELATIVE_ROTATION:     node->SetReleativeRotation(op.rotation);        break;
+        case OpKind::SET_SCALE:                 node->SetScale(op.vector);                      break;
+        case OpKind::MOVE:                      node->Move(op.vector, op.value);                break;
+        case OpKind::ROTATE_WORLD_OX:           node->RotateWorldOX(op.value);                  break;
+        case OpKind::ROTATE_WORLD_OY:           node->RotateWorldOY(op.value);                  break;
+        case OpKind::ROTATE_WORLD_OZ:           node->RotateWorldOZ(op.value);                  break;
+        case OpKind::ROTATE_LOCAL_OX:           node->RotateLocalOX(op.value);                  break;
+        case OpKind::ROTATE_LOCAL_OY:           node->RotateLocalOY(op.value);                  break;
+        case OpKind::ROTATE_LOCAL_OZ:           node->RotateLocalOZ(op.value);                  break;
+        case OpKind::ADD_CHILD:                 nodes[op.parent]->AddChild(node);               break;
+        case OpKind::REMOVE_CHILD:              nodes[op.parent]->RemoveChild(node);            break;
+        case OpKind::GET_MODEL:                 bench::DoNotOptimize(node->GetModel());         break;
+        case OpKind::COUNT:                     break;
+        }
+    }
+
+    glm::vec3 GetWorldPosition(unsigned int index) const     { return nodes[index]->GetWorldPosition(); }
+    glm::quat GetWorldRotation(unsigned int index) const     { return nodes[index]->GetWorldRotation(); }
+    glm::mat4 GetModel(unsigned int index)                   { return nodes[index]->GetModel(); }
+
+ private:
+    std::vector<gfxc::Transform *> nodes;
+};
+
+
+// Entry points of the prebuilt gfxc::Transform, with the Itanium C++ ABI
+struct ReferenceLibrary
+{
+    void *handle;
+
+    void (*construct)(void *self);
+    void (*destruct)(void *self);
+
+    void (*setLocalPosition)(void *self, glm::vec3 position);
+    void (*setWorldPosition)(void *self, glm::vec3 position);
+    void (*setWorldRotation)(void *self, glm::quat rotation);
+    void (*setWorldRotationEuler)(void *self, const glm::vec3 &eulerAngles360);
+    void (*setRelativeRotation)(void *self, const glm::quat &rotation);
+    void (*setScale)(void *self, glm::vec3 scale);
+    void (*move)(void *self, const glm::vec3 &dir, float deltaTime);
+    void (*rotateWorldOX)(void *self, float deltaTime);
+    void (*rotateWorldOY)(void *self, float deltaTime);
+    void (*rotateWorldOZ)(void *self, float deltaTime);
+    void (*rotateLocalOX)(void *self, float deltaTime);
+    void (*rotateLocalOY)(void *self, float deltaTime);
+    void (*rotateLocalOZ)(void *self, float deltaTime);
+    void (*addChild)(void *self, void *child);
+    void (*removeChild)(void *self, void *child);
+    const glm::mat4 &(*getModel)(void *self);
+    glm::vec3 (*getWorldPosition)(const void *self);
+    glm::quat (*getWorldRotation)(const void *self);
+};
+
+
+template <class Function>
+static bool LoadSymbol(void *handle, const char *name, Function &function)
+{
+    void *symbol = dlsym(handle, name);
+    if (symbol == nullptr)
+    {
+        fprintf(stderr, "Missing symbol %s in the reference library\n", name);
+        return false;
+    }
+    function = reinterpret_cast<Function>(symbol);
+    return true;
+}
+
+
+static bool LoadReferenceLibrary(const std::string &path, ReferenceLibrary &library)
+{
+    // Prefer the symbols of the library itself over ours, since both define
+    // the same gfxc::Transform methods
+    int flags = RTLD_NOW | RTLD_LOCAL;
+#ifdef RTLD_DEEPBIND
+    flags |= RTLD_DEEPBIND;
+#endif
+
+    library.handle = dlopen(path.c_str(), flags);
+    if (library.handle == nullptr)
+    {
+        fprintf(stderr, "Cannot load the reference library: %s\n", dlerror());
+        return false;
+    }
+
+    void *handle = library.handle;
+    bool loaded = true;
+    loaded &= LoadSymbol(handle, "_ZN4gfxc9TransformC1Ev", library.construct);
+    loaded &= LoadSymbol(handle, "_ZN4gfxc9TransformD1Ev", library.destruct);
+    loaded &= LoadSymbol(handle, "_ZN4gfxc9Transform16SetLocalPositionEN3glm3vecILi3EfLNS1_9qualifierE0EEE", library.setLocalPosition);
+    loaded &= LoadSymbol(handle, "_ZN4gfxc9Transform16SetWorldPositionEN3glm3vecILi3EfLNS1_9qualifierE0EEE", library.setWorldPosition);
+    loaded &= LoadSymbol(handle, "_ZN4gfxc9Transform16SetWorldRotationEN3glm3quaIfLNS1_9qualifierE0EEE", library.setWorldRotation);
+    loaded &= LoadSymbol(handle, "_ZN4gfxc9Transform16SetWorldRotationERKN3glm3vecILi3EfLNS1_9qualifierE0EEE", library.setWorldRotationEuler);
+    loaded &= LoadSymbol(handle, "_ZN4gfxc9Transform20SetReleativeRotationERKN3glm3quaIfLNS1_9qualifierE0EEE", library.setRelativeRotation);
+    loaded &= LoadSymbol(handle, "_ZN4gfxc9Transform8SetScaleEN3glm3vecILi3EfLNS1_9qualifierE0EEE", library.setScale);
+    loaded &= LoadSymbol(handle, "_ZN4gfxc9Transform4MoveERKN3glm3vecILi3EfLNS1_9qualifierE0EEEf", library.move);
+    loaded &= LoadSymbol(handle, "_ZN4gfxc9Transform13RotateWorldOXEf", library.rotateWorldOX);
+    loaded &= LoadSymbol(handle, "_ZN4gfxc9Transform13RotateWorldOYEf", library.rotateWorldOY);
+    loaded &= LoadSymbol(handle, "_ZN4gfxc9Transform13RotateWorldOZEf", library.rotateWorldOZ);
+    loaded &= LoadSymbol(handle, "_ZN4gfxc9Transform13RotateLocalOXEf", library.rotateLocalOX);
+    loaded &= LoadSymbol(handle, "_ZN4gfxc9Transform13RotateLocalOYEf", library.rotateLocalOY);
+    loaded &= LoadSymbol(handle, "_ZN4gfxc9Transform13RotateLocalOZEf", library.rotateLocalOZ);
+    loaded &= LoadSymbol(handle, "_ZN4gfxc9Transform8AddChildEPS0_", library.addChild);
+    loaded &= LoadSymbol(handle, "_ZN4gfxc9Transform11RemoveChildEPS0_", library.removeChild);
+    loaded &= LoadSymbol(handle, "_ZN4gfxc9Transform8GetModelEv", library.getModel);
+    loaded &= LoadSymbol(handle, "_ZNK4gfxc9Transform16GetWorldPositionEv", library.getWorldPosition);
+    loaded &= LoadSymbol(handle, "_ZNK4gfxc9Transform16GetWorldRotationEv", library.getWorldRotation);
+
+    return loaded;
+}
+
+
+class ReferenceTransforms
+{
+ public:
+    // Larger than the prebuilt class, which is 208 bytes on x86_64
+    struct alignas(16) Storage
+    {
+        unsigned char bytes[512];
+    };
+
+    ReferenceTransforms(const ReferenceLibrary &library, const std::vector<int> &parents)
+        : lib(library), nodes(parents.size())
+    {
+        for (unsigned int i = 0; i < nodes.size(); i++)
+        {
+            lib.construct(&nodes[i]);
+            lib.setWorldRotation(&nodes[i], glm::quat(1.0F, 0.0F, 0.0F, 0.0F));
+        }
+        for (unsigned int i = 0; i < nodes.size(); i++)
+        {
+            if (parents[i] >= 0) {
+                lib.addChild(&nodes[parents[i]], &nodes[i]);
+            }
+        }
+    }
+
+    ~ReferenceTransforms()
+    {
+        for (Storage &node : nodes) {
+            lib.destruct(&node);
+        }
+    }
+
+    void Apply(const Op &op)
+    {
+        void *node = &nodes[op.node];
+
+        switch (op.kind) {
+        case OpKind::SET_LOCAL_POSITION:        lib.setLocalPosition(node, op.vector);              break;
+        case OpKind::SET_WORLD_POSITION:        lib.setWorldPosition(node, op.vector);              break;
+        case OpKind::SET_WORLD_ROTATION:        lib.setWorldRotation(node, op.rotation);            break;
+        case OpKind::SET_WORLD_ROTATION_EULER:  lib.setWorldRotationEuler(node, op.vector);         break;
+        case OpKind::SET_RELATIVE_ROTATION:     lib.setRelativeRotation(node, op.rotation);         break;
+        case OpKind::SET_SCALE:                 lib.setScale(node, op.vector);                      break;
+        case OpKind::MOVE:                      lib.move(node, op.vector, op.value);                break;
+        case OpKind::ROTATE_WORLD_OX:           lib.rotateWorldOX(node, op.value);                  break;
+        case OpKind::ROTATE_WORLD_OY:           lib.rotateWorldOY(node, op.value);                  break;
+        case OpKind::ROTATE_WORLD_OZ:           lib.rotateWorldOZ(node, op.value);                  break;
+        case OpKind::ROTATE_LOCAL_OX:           lib.rotateLocalOX(node, op.value);                  break;
+        case OpKind::ROTATE_LOCAL_OY:           lib.rotateLocalOY(node, op.value);                  break;
+        case OpKind::ROTATE_LOCAL_OZ:           lib.rotateLocalOZ(node, op.value);                  break;
+        case OpKind::ADD_CHILD:                 lib.addChild(&nodes[op.parent], node);              break;
+        case OpKind::REMOVE_CHILD:              lib.removeChild(&nodes[op.parent], node);           break;
+        case OpKind::GET_MODEL:                 bench::DoNotOptimize(lib.getModel(node));           break;
+        case OpKind::COUNT:                     break;
+        }
+    }
+
+    glm::vec3 GetWorldPosition(unsigned int index) const     { return lib.getWorldPosition(&nodes[index]); }
+    glm::quat GetWorldRotation(unsigned int index) const     { return lib.getWorldRotation(&nodes[index]); }
+    glm::mat4 GetModel(unsigned int index)                   { return lib.getModel(&nodes[index]); }
+
+ private:
+    const ReferenceLibrary &lib;
+    std::vector<Storage> nodes;
+};
+
+
+/*
+ *  Latency
+ */
+
+
+// Average cost of an empty timed region, subtracted from every measurement
+static double GetTimerOverheadNs()
+{
+    const unsigned int samples = 100000;
+    bench::Timer total;
+    for (unsigned int i = 0; i < samples; i++)
+    {
+        bench::Timer timer;
+        bench::DoNotOptimize(timer.ElapsedMs());
+    }
+    return total.ElapsedMs() * 1e6 / samples;
+}
+
+
+template <class Transforms>
+static void MeasureLatency(Transforms &transforms, const std::vector<Op> &ops, double timerOverheadNs,
+                           std::vector<double> &totalNs, std::vector<unsigned int> &counts)
+{
+    totalNs.assign(kOpKindCount, 0.0);
+    counts.assign(kOpKindCount, 0U);
+
+    for (const Op &op : ops)
+    {
+        bench::Timer timer;
+        transforms.Apply(op);
+        const double elapsedNs = timer.ElapsedMs() * 1e6 - timerOverheadNs;
+
+        const unsigned int kind = static_cast<unsigned int>(op.kind);
+        totalNs[kind] += std::max(elapsedNs, 0.0);
+        counts[kind]++;
+    }
+}
+
+
+/*
+ *  Divergence
+ */
+
+
+static float GetRotationError(const glm::quat &a, const glm::quat &b)
+{
+    // q and -q describe the same rotation
+    const glm::vec4 va(a.x, a.y, a.z, a.w);
+    const glm::vec4 vb(b.x, b.y, b.z, b.w);
+    const glm::vec4 diff = glm::abs(va - vb);
+    const glm::vec4 sum = glm::abs(va + vb);
+    return std::min(glm::max(glm::max(diff.x, diff.y), glm::max(diff.z, diff.w)),
+                    glm::max(glm::max(sum.x, sum.y), glm::max(sum.z, sum.w)));
+}
+
+
+static float GetSceneError(LocalTransforms &local, ReferenceTransforms &reference, unsigned int nodeCount)
+{
+    float error = 0.0F;
+    for (unsigned int i = 0; i < nodeCount; i++)
+    {
+        const glm::vec3 position = glm::abs(local.GetWorldPosition(i) - reference.GetWorldPosition(i));
+        error = glm::max(error, glm::max(position.x, glm::max(position.y, position.z)));
+        error = glm::max(error, GetRotationError(local.GetWorldRotation(i), reference.GetWorldRotation(i)));
+
+        const glm::mat4 localModel = local.GetModel(i);
+        const glm::mat4 referenceModel = reference.GetModel(i);
+        for (int c = 0; c < 4; c++)
+        {
+            const glm::vec4 column = glm::abs(localModel[c] - referenceModel[c]);
+            error = glm::max(error, glm::max(glm::max(column.x, column.y), glm::max(column.z, column.w)));
+        }
+    }
+    return error;
+}
+
+
+int main(int argc, char **argv)
+{
+    const std::string libraryPath = bench::GetStringArg(argc, argv, "lib", GFXF_REFERENCE_LIBRARY);
+    const unsigned int nodeCount = std::max(bench::GetArg(argc, argv, "nodes", 64), 2U);
+    const unsigned int opCount = bench::GetArg(argc, argv, "ops", 100000);
+    const unsigned int seed = bench::GetArg(argc, argv, "seed", 1234);
+    const bool lazyUpdate = bench::GetArg(argc, argv, "lazy", 0) != 0;
+    const float tolerance = static_cast<float>(bench::GetDoubleArg(argc, argv, "tolerance", 1e-3));
+
+    ReferenceLibrary library;
+    if (!LoadReferenceLibrary(libraryPath, library)) {
+        return 2;
+    }
+
+    std::mt19937 generator(seed);
+    const std::vector<int> parents = BuildParents(generator, nodeCount);
+    const std::vector<Op> ops = BuildStream(generator, parents, opCount);
+
+    printf("reference: %s\n", libraryPath.c_str());
+    printf("%u nodes, %u operations, seed %u, %s update\n\n", nodeCount, static_cast<unsigned int>(ops.size()),
+           seed, lazyUpdate ? "lazy" : "eager");
+
+    // Latency, each implementation on a fresh copy of the scene
+    const double timerOverheadNs = GetTimerOverheadNs();
+    std::vector<double> localNs, referenceNs;
+    std::vector<unsigned int> counts;
+    {
+        LocalTransforms local(parents, lazyUpdate);
+        MeasureLatency(local, ops, timerOverheadNs, localNs, counts);
+    }
+    {
+        ReferenceTransforms reference(library, parents);
+        MeasureLatency(reference, ops, timerOverheadNs, referenceNs, counts);
+    }
+
+    // Divergence, checked on every node after every operation. An operation
+    // is blamed for the error it adds to the one already in the scene.
+    std::vector<float> maxErrors(kOpKindCount, 0.0F);
+    float sceneError = 0.0F;
+    float maxSceneError = 0.0F;
+    unsigned int firstDivergence = 0;
+    bool diverged = false;
+    {
+        LocalTransforms local(parents, lazyUpdate);
+        ReferenceTransforms reference(library, parents);
+
+        sceneError = GetSceneError(local, reference, nodeCount);
+        maxSceneError = sceneError;
+
+        for (unsigned int i = 0; i < ops.size(); i++)
+        {
+            local.Apply(ops[i]);
+            reference.Apply(ops[i]);
+
+            const float error = GetSceneError(local, reference, nodeCount);
+            const unsigned int kind = static_cast<unsigned int>(ops[i].kind);
+            maxErrors[kind] = std::max(maxErrors[kind], error - sceneError);
+            sceneError = error;
+            maxSceneError = std::max(maxSceneError, error);
+
+            if (!diverged && error > tolerance)
+            {
+                diverged = true;
+                firstDivergence = i;
+            }
+        }
+    }
+
+    printf("%-24s %8s %12s %12s %8s %12s\n", "operation", "count", "local ns", "reference ns", "ratio", "added error");
+    double localTotalNs = 0.0;
+    double referenceTotalNs = 0.0;
+    for (unsigned int kind = 0; kind < kOpKindCount; kind++)
+    {
+        if (counts[kind] == 0) {
+            continue;
+        }
+        const double localAvg = localNs[kind] / counts[kind];
+        const double referenceAvg = referenceNs[kind] / counts[kind];
+        printf("%-24s %8u %12.1f %12.1f %8.2f %12.3g\n", GetOpName(static_cast<OpKind>(kind)), counts[kind],
+               localAvg, referenceAvg, referenceAvg > 0.0 ? localAvg / referenceAvg : 0.0, maxErrors[kind]);
+        localTotalNs += localNs[kind];
+        referenceTotalNs += referenceNs[kind];
+    }
+    printf("%-24s %8u %12.1f %12.1f %8.2f\n\n", "all", static_cast<unsigned int>(ops.size()),
+           localTotalNs / ops.size(), referenceTotalNs / ops.size(),
+           referenceTotalNs > 0.0 ? localTotalNs / referenceTotalNs : 0.0);
+
+    printf("max divergence %.3g, tolerance %.3g\n", maxSceneError, tolerance);
+    if (diverged)
+    {
+        printf("diverged first after operation %u (%s on node %u)\n", firstDivergence,
+               GetOpName(ops[firstDivergence].kind), ops[firstDivergence].node);
+    }
+
+    dlclose(library.handle);
+    return diverged ? 1 : 0;
+}
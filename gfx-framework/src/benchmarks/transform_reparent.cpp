@@ -0,0 +1,115 @@
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "benchmarks/bench_utils.h"
+#include "components/transform.h"
+
+
+/*
+ *  Reparent heavy workload, similar to picking up and dropping items.
+ *
+ *  A root holds a number of containers, and every container starts with
+ *  the same number of items. Each frame moves random items from their
+ *  container to another one, then moves the root, which walks all the
+ *  children lists of the hierarchy.
+ */
+
+
+struct Scene
+{
+    gfxc::Transform                 root;
+    std::vector<gfxc::Transform *>  containers;
+    std::vector<gfxc::Transform *>  items;
+    std::vector<unsigned int>       itemContainers;
+};
+
+
+static void BuildScene(Scene &scene, unsigned int containerCount, unsigned int itemsPerContainer)
+{
+    scene.root.SetWorldRotation(glm::quat(1.0F, 0.0F, 0.0F, 0.0F));
+
+    for (unsigned int c = 0; c < containerCount; c++)
+    {
+        gfxc::Transform *container = new gfxc::Transform();
+        container->SetWorldRotation(glm::quat(1.0F, 0.0F, 0.0F, 0.0F));
+        scene.root.AddChild(container);
+        container->SetLocalPosition(glm::vec3(1.0F * c, 0.0F, 0.0F));
+        scene.containers.push_back(container);
+
+        for (unsigned int i = 0; i < itemsPerContainer; i++)
+        {
+            gfxc::Transform *item = new gfxc::Transform();
+            item->SetWorldRotation(glm::quat(1.0F, 0.0F, 0.0F, 0.0F));
+            container->AddChild(item);
+            item->SetLocalPosition(glm::vec3(0.0F, 0.1F * i, 0.0F));
+            scene.items.push_back(item);
+            scene.itemContainers.push_back(c);
+        }
+    }
+}
+
+
+static void DestroyScene(Scene &scene)
+{
+    for (gfxc::Transform *item : scene.items) {
+        delete item;
+    }
+    for (gfxc::Transform *container : scene.containers) {
+        delete container;
+    }
+}
+
+
+int main(int argc, char **argv)
+{
+    const unsigned int frames = bench::GetArg(argc, argv, "frames", 100);
+    const unsigned int containerCount = bench::GetArg(argc, argv, "containers", 100);
+    const unsigned int reparentsPerFrame = bench::GetArg(argc, argv, "reparents", 1000);
+
+    const unsigned int itemCounts[] = { 4, 16, 64, 256 };
+
+    printf("%10s %10s %16s %16s %14s\n", "items/cont", "items", "reparent ns/op", "move ms/frame", "total ms/frame");
+
+    for (unsigned int itemsPerContainer : itemCounts)
+    {
+        Scene scene;
+        BuildScene(scene, containerCount, itemsPerContainer);
+
+        std::mt19937 generator(1234U);
+        const unsigned int itemCount = static_cast<unsigned int>(scene.items.size());
+
+        double reparentMs = 0.0;
+        double moveMs = 0.0;
+        float time = 0.0F;
+
+        const double totalMs = bench::MeasureMs([&]()
+        {
+            bench::Timer timer;
+            for (unsigned int r = 0; r < reparentsPerFrame; r++)
+            {
+                const unsigned int item = generator() % itemCount;
+                const unsigned int target = generator() % containerCount;
+
+                scene.containers[scene.itemContainers[item]]->RemoveChild(scene.items[item]);
+                scene.containers[target]->AddChild(scene.items[item]);
+                scene.itemContainers[item] = target;
+            }
+            reparentMs += timer.ElapsedMs();
+
+            timer.Start();
+            time += 0.016F;
+            scene.root.SetWorldPosition(glm::vec3(std::sin(time), 0.0F, 0.0F));
+            scene.root.SetWorldRotation(glm::quat(glm::vec3(0.0F, time, 0.0F)));
+            moveMs += timer.ElapsedMs();
+        }, frames, 0);
+
+        printf("%10u %10u %16.1f %16.4f %14.4f\n", itemsPerContainer, itemCount,
+               reparentMs * 1e6 / (1.0 * frames * reparentsPerFrame), moveMs / frames, totalMs);
+
+        DestroyScene(scene);
+    }
+
+    return 0;
+}
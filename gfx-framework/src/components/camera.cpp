@@ -58,6 +58,7 @@ namespace gfxc
             const glm::vec3 up = m_transform->GetLocalOYVector();
 
             m_view = glm::lookAt(eye, center, up);
+            UpdateFrustum();
         }
     }
     
@@ -71,6 +72,16 @@ namespace gfxc
     {
         return m_projection;
     }
+
+    const Frustum& Camera::GetFrustum() const
+    {
+        return m_frustum;
+    }
+
+    void Camera::UpdateFrustum()
+    {
+        m_frustum.Extract(m_projection * m_view);
+    }
     
 
     // Rotation
@@ -175,6 +186,7 @@ namespace gfxc
         m_zFar = zFar;
 
         m_projection = glm::perspective(RADIANS(FoVy), aspectRatio, zNear, zFar);
+        UpdateFrustum();
     }
     
     void Camera::SetOrthographic(float width, float height, float zNear, float zFar)
@@ -186,6 +198,7 @@ namespace gfxc
         m_aspectRatio = width / height;
 
         m_projection = glm::ortho(-width / 2, width / 2, -height / 2, height / 2, zNear, zFar);
+        UpdateFrustum();
     }
     
     void Camera::SetOrthographic(float left, float right, float bottom, float top, float zNear, float zFar)
@@ -197,6 +210,7 @@ namespace gfxc
         m_aspectRatio = (right - left) / (top - bottom);
 
         m_projection = glm::ortho(left, right, bottom, top, zNear, zFar);
+        UpdateFrustum();
     }
     
 
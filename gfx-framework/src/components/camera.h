@@ -2,6 +2,7 @@
 #define GFXC_CAMERA_H
 
 #include "components/exports.h"
+#include "components/frustum.h"
 
 #include "glm/glm.hpp"
 #include "glm/gtc/type_ptr.hpp"
@@ -45,6 +46,12 @@ namespace gfxc
         const glm::mat4& GetViewMatrix() const;
         const glm::mat4& GetProjectionMatrix() const;
 
+        // World space planes of the view volume. They are extracted again
+        // whenever the camera updates its view or projection matrix. Call
+        // UpdateFrustum() after writing m_view or m_projection directly.
+        const Frustum& GetFrustum() const;
+        void UpdateFrustum();
+
         // Rotation
         void RotateOX(float deltaTime);
         void RotateOY(float deltaTime);
@@ -111,6 +118,10 @@ namespace gfxc
         float           m_aspectRatio;
         bool            m_isPerspective;
         float           m_ortographicWidth;
+
+        // Added after the fields of the prebuilt component, so that their
+        // offsets do not change
+        Frustum         m_frustum;
     };
 }
 
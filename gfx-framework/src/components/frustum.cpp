@@ -0,0 +1,480 @@
+#include "components/frustum.h"
+
+#include <cassert>
+
+
+namespace gfxc
+{
+    // Signed distance from a plane, with the operations in the same order
+    // as the SIMD kernels, so that every path classifies volumes the same way
+    static inline float PlaneDistance(const glm::vec4 &plane, float x, float y, float z)
+    {
+        return ((plane.x * x + plane.y * y) + plane.z * z) + plane.w;
+    }
+
+
+    Frustum::Frustum()
+    {
+        for (glm::vec4 &plane : m_planes)
+        {
+            plane = glm::vec4(0.0F, 0.0F, 0.0F, 1.0F);
+        }
+    }
+
+    void Frustum::Extract(const glm::mat4 &viewProjection)
+    {
+        const glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+        const glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+        const glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+        const glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+        m_planes[0] = row3 + row0;
+        m_planes[1] = row3 - row0;
+        m_planes[2] = row3 + row1;
+        m_planes[3] = row3 - row1;
+        m_planes[4] = row3 + row2;
+        m_planes[5] = row3 - row2;
+
+        for (glm::vec4 &plane : m_planes)
+        {
+            const float length = glm::length(glm::vec3(plane));
+            if (length > 0.0F)
+            {
+                plane /= length;
+            }
+        }
+    }
+
+    const glm::vec4& Frustum::GetPlane(unsigned int index) const
+    {
+        assert(index < PLANE_COUNT);
+        return m_planes[index];
+    }
+
+    bool Frustum::IsSphereVisible(const glm::vec3 &center, float radius) const
+    {
+        for (const glm::vec4 &plane : m_planes)
+        {
+            if (PlaneDistance(plane, center.x, center.y, center.z) < -radius)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Frustum::IsBoxVisible(const glm::vec3 &min, const glm::vec3 &max) const
+    {
+        // Only the corner furthest along the normal needs to be tested
+        for (const glm::vec4 &plane : m_planes)
+        {
+            const float x = plane.x >= 0.0F ? max.x : min.x;
+            const float y = plane.y >= 0.0F ? max.y : min.y;
+            const float z = plane.z >= 0.0F ? max.z : min.z;
+            if (PlaneDistance(plane, x, y, z) < 0.0F)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+
+    // ****************************
+    // Shared by all paths
+
+    // The corner of each box furthest along each plane normal, as arrays
+    struct BoxCorners
+    {
+        const float *x[Frustum::PLANE_COUNT];
+        const float *y[Frustum::PLANE_COUNT];
+        const float *z[Frustum::PLANE_COUNT];
+    };
+
+    static BoxCorners SelectBoxCorners(const Frustum &frustum, const BoxBounds &boxes)
+    {
+        BoxCorners corners;
+        for (unsigned int p = 0U; p < Frustum::PLANE_COUNT; ++p)
+        {
+            const glm::vec4 &plane = frustum.GetPlane(p);
+            corners.x[p] = plane.x >= 0.0F ? boxes.maxX : boxes.minX;
+            corners.y[p] = plane.y >= 0.0F ? boxes.maxY : boxes.minY;
+            corners.z[p] = plane.z >= 0.0F ? boxes.maxZ : boxes.minZ;
+        }
+        return corners;
+    }
+
+    // Appends the indices of the lanes set in `mask` without branches. The
+    // slot after the last visible index may be written, but it is always
+    // below first + lanes.
+    static inline unsigned int AppendVisible(unsigned int mask, unsigned int first, unsigned int lanes,
+                                             unsigned int *visible, unsigned int visibleCount)
+    {
+        for (unsigned int k = 0U; k < lanes; ++k)
+        {
+            visible[visibleCount] = first + k;
+            visibleCount += (mask >> k) & 1U;
+        }
+        return visibleCount;
+    }
+
+
+    // ****************************
+    // Scalar path
+
+    static unsigned int CullSpheresScalar(const Frustum &frustum, const SphereBounds &spheres, unsigned int first,
+                                          unsigned int count, unsigned int *visible, unsigned int visibleCount)
+    {
+        for (unsigned int i = first; i < count; ++i)
+        {
+            const glm::vec3 center(spheres.centerX[i], spheres.centerY[i], spheres.centerZ[i]);
+            visible[visibleCount] = i;
+            visibleCount += frustum.IsSphereVisible(center, spheres.radius[i]) ? 1U : 0U;
+        }
+        return visibleCount;
+    }
+
+    static unsigned int CullBoxesScalar(const Frustum &frustum, const BoxBounds &boxes, unsigned int first,
+                                        unsigned int count, unsigned int *visible, unsigned int visibleCount)
+    {
+        for (unsigned int i = first; i < count; ++i)
+        {
+            const glm::vec3 min(boxes.minX[i], boxes.minY[i], boxes.minZ[i]);
+            const glm::vec3 max(boxes.maxX[i], boxes.maxY[i], boxes.maxZ[i]);
+            visible[visibleCount] = i;
+            visibleCount += frustum.IsBoxVisible(min, max) ? 1U : 0U;
+        }
+        return visibleCount;
+    }
+
+
+#if defined(GFXF_SIMD_X64)
+    // ****************************
+    // SSE2 path, 4 volumes per iteration
+
+    // Plane components, broadcast to every lane
+    struct PlanesSSE2
+    {
+        __m128 x[Frustum::PLANE_COUNT];
+        __m128 y[Frustum::PLANE_COUNT];
+        __m128 z[Frustum::PLANE_COUNT];
+        __m128 w[Frustum::PLANE_COUNT];
+    };
+
+    static inline PlanesSSE2 BroadcastPlanesSSE2(const Frustum &frustum)
+    {
+        PlanesSSE2 planes;
+        for (unsigned int p = 0U; p < Frustum::PLANE_COUNT; ++p)
+        {
+            const glm::vec4 &plane = frustum.GetPlane(p);
+            planes.x[p] = _mm_set1_ps(plane.x);
+            planes.y[p] = _mm_set1_ps(plane.y);
+            planes.z[p] = _mm_set1_ps(plane.z);
+            planes.w[p] = _mm_set1_ps(plane.w);
+        }
+        return planes;
+    }
+
+    static inline __m128 PlaneDistanceSSE2(const PlanesSSE2 &planes, unsigned int p, __m128 x, __m128 y, __m128 z)
+    {
+        const __m128 dx = _mm_mul_ps(planes.x[p], x);
+        const __m128 dy = _mm_mul_ps(planes.y[p], y);
+        const __m128 dz = _mm_mul_ps(planes.z[p], z);
+        return _mm_add_ps(_mm_add_ps(_mm_add_ps(dx, dy), dz), planes.w[p]);
+    }
+
+    static unsigned int CullSpheresSSE2(const Frustum &frustum, const SphereBounds &spheres,
+                                        unsigned int count, unsigned int *visible)
+    {
+        const PlanesSSE2 planes = BroadcastPlanesSSE2(frustum);
+        const __m128 signBit = _mm_set1_ps(-0.0F);
+
+        unsigned int visibleCount = 0U;
+        unsigned int i = 0U;
+        for (; i + 4U <= count; i += 4U)
+        {
+            const __m128 x = _mm_loadu_ps(spheres.centerX + i);
+            const __m128 y = _mm_loadu_ps(spheres.centerY + i);
+            const __m128 z = _mm_loadu_ps(spheres.centerZ + i);
+            const __m128 negRadius = _mm_xor_ps(_mm_loadu_ps(spheres.radius + i), signBit);
+
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (unsigned int p = 0U; p < Frustum::PLANE_COUNT; ++p)
+            {
+                const __m128 distance = PlaneDistanceSSE2(planes, p, x, y, z);
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+            }
+
+            visibleCount = AppendVisible(static_cast<unsigned int>(_mm_movemask_ps(inside)), i, 4U, visible, visibleCount);
+        }
+
+        return CullSpheresScalar(frustum, spheres, i, count, visible, visibleCount);
+    }
+
+    static unsigned int CullBoxesSSE2(const Frustum &frustum, const BoxBounds &boxes,
+                                      unsigned int count, unsigned int *visible)
+    {
+        const PlanesSSE2 planes = BroadcastPlanesSSE2(frustum);
+        const BoxCorners corners = SelectBoxCorners(frustum, boxes);
+        const __m128 zero = _mm_setzero_ps();
+
+        unsigned int visibleCount = 0U;
+        unsigned int i = 0U;
+        for (; i + 4U <= count; i += 4U)
+        {
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (unsigned int p = 0U; p < Frustum::PLANE_COUNT; ++p)
+            {
+                const __m128 distance = PlaneDistanceSSE2(planes, p, _mm_loadu_ps(corners.x[p] + i),
+                                                          _mm_loadu_ps(corners.y[p] + i), _mm_loadu_ps(corners.z[p] + i));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, zero));
+            }
+
+            visibleCount = AppendVisible(static_cast<unsigned int>(_mm_movemask_ps(inside)), i, 4U, visible, visibleCount);
+        }
+
+        return CullBoxesScalar(frustum, boxes, i, count, visible, visibleCount);
+    }
+
+
+    // ****************************
+    // AVX2 path, 8 volumes per iteration
+
+    struct PlanesAVX2
+    {
+        __m256 x[Frustum::PLANE_COUNT];
+        __m256 y[Frustum::PLANE_COUNT];
+        __m256 z[Frustum::PLANE_COUNT];
+        __m256 w[Frustum::PLANE_COUNT];
+    };
+
+    GFXF_TARGET_AVX2
+    static inline void BroadcastPlanesAVX2(const Frustum &frustum, PlanesAVX2 &planes)
+    {
+        for (unsigned int p = 0U; p < Frustum::PLANE_COUNT; ++p)
+        {
+            const glm::vec4 &plane = frustum.GetPlane(p);
+            planes.x[p] = _mm256_set1_ps(plane.x);
+            planes.y[p] = _mm256_set1_ps(plane.y);
+            planes.z[p] = _mm256_set1_ps(plane.z);
+            planes.w[p] = _mm256_set1_ps(plane.w);
+        }
+    }
+
+    GFXF_TARGET_AVX2
+    static inline __m256 PlaneDistanceAVX2(const PlanesAVX2 &planes, unsigned int p, __m256 x, __m256 y, __m256 z)
+    {
+        const __m256 dx = _mm256_mul_ps(planes.x[p], x);
+        const __m256 dy = _mm256_mul_ps(planes.y[p], y);
+        const __m256 dz = _mm256_mul_ps(planes.z[p], z);
+        return _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(dx, dy), dz), planes.w[p]);
+    }
+
+    GFXF_TARGET_AVX2
+    static unsigned int CullSpheresAVX2(const Frustum &frustum, const SphereBounds &spheres,
+                                        unsigned int count, unsigned int *visible)
+    {
+        PlanesAVX2 planes;
+        BroadcastPlanesAVX2(frustum, planes);
+        const __m256 signBit = _mm256_set1_ps(-0.0F);
+
+        unsigned int visibleCount = 0U;
+        unsigned int i = 0U;
+        for (; i + 8U <= count; i += 8U)
+        {
+            const __m256 x = _mm256_loadu_ps(spheres.centerX + i);
+            const __m256 y = _mm256_loadu_ps(spheres.centerY + i);
+            const __m256 z = _mm256_loadu_ps(spheres.centerZ + i);
+            const __m256 negRadius = _mm256_xor_ps(_mm256_loadu_ps(spheres.radius + i), signBit);
+
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (unsigned int p = 0U; p < Frustum::PLANE_COUNT; ++p)
+            {
+                const __m256 distance = PlaneDistanceAVX2(planes, p, x, y, z);
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+            }
+
+            visibleCount = AppendVisible(static_cast<unsigned int>(_mm256_movemask_ps(inside)), i, 8U, visible, visibleCount);
+        }
+
+        return CullSpheresScalar(frustum, spheres, i, count, visible, visibleCount);
+    }
+
+    GFXF_TARGET_AVX2
+    static unsigned int CullBoxesAVX2(const Frustum &frustum, const BoxBounds &boxes,
+                                      unsigned int count, unsigned int *visible)
+    {
+        PlanesAVX2 planes;
+        BroadcastPlanesAVX2(frustum, planes);
+        const BoxCorners corners = SelectBoxCorners(frustum, boxes);
+        const __m256 zero = _mm256_setzero_ps();
+
+        unsigned int visibleCount = 0U;
+        unsigned int i = 0U;
+        for (; i + 8U <= count; i += 8U)
+        {
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (unsigned int p = 0U; p < Frustum::PLANE_COUNT; ++p)
+            {
+                const __m256 distance = PlaneDistanceAVX2(planes, p, _mm256_loadu_ps(corners.x[p] + i),
+                                                          _mm256_loadu_ps(corners.y[p] + i), _mm256_loadu_ps(corners.z[p] + i));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, zero, _CMP_GE_OQ));
+            }
+
+            visibleCount = AppendVisible(static_cast<unsigned int>(_mm256_movemask_ps(inside)), i, 8U, visible, visibleCount);
+        }
+
+        return CullBoxesScalar(frustum, boxes, i, count, visible, visibleCount);
+    }
+#endif
+
+
+#if defined(GFXF_SIMD_NEON)
+    // ****************************
+    // NEON path, 4 volumes per iteration
+
+    static inline float32x4_t PlaneDistanceNEON(const glm::vec4 &plane, float32x4_t x, float32x4_t y, float32x4_t z)
+    {
+        const float32x4_t dx = vmulq_n_f32(x, plane.x);
+        const float32x4_t dy = vmulq_n_f32(y, plane.y);
+        const float32x4_t dz = vmulq_n_f32(z, plane.z);
+        return vaddq_f32(vaddq_f32(vaddq_f32(dx, dy), dz), vdupq_n_f32(plane.w));
+    }
+
+    // Local copy, so that the planes stay in registers inside the loops
+    static inline void CopyPlanes(const Frustum &frustum, glm::vec4 *planes)
+    {
+        for (unsigned int p = 0U; p < Frustum::PLANE_COUNT; ++p)
+        {
+            planes[p] = frustum.GetPlane(p);
+        }
+    }
+
+    // Equivalent of _mm_movemask_ps for comparison results
+    static inline unsigned int MoveMaskNEON(uint32x4_t mask)
+    {
+        static const uint32_t bits[4] = { 1U, 2U, 4U, 8U };
+        return vaddvq_u32(vandq_u32(mask, vld1q_u32(bits)));
+    }
+
+    static unsigned int CullSpheresNEON(const Frustum &frustum, const SphereBounds &spheres,
+                                        unsigned int count, unsigned int *visible)
+    {
+        glm::vec4 planes[Frustum::PLANE_COUNT];
+        CopyPlanes(frustum, planes);
+
+        unsigned int visibleCount = 0U;
+        unsigned int i = 0U;
+        for (; i + 4U <= count; i += 4U)
+        {
+            const float32x4_t x = vld1q_f32(spheres.centerX + i);
+            const float32x4_t y = vld1q_f32(spheres.centerY + i);
+            const float32x4_t z = vld1q_f32(spheres.centerZ + i);
+            const float32x4_t negRadius = vnegq_f32(vld1q_f32(spheres.radius + i));
+
+            uint32x4_t inside = vdupq_n_u32(0xFFFFFFFFU);
+            for (unsigned int p = 0U; p < Frustum::PLANE_COUNT; ++p)
+            {
+                const float32x4_t distance = PlaneDistanceNEON(planes[p], x, y, z);
+                inside = vandq_u32(inside, vcgeq_f32(distance, negRadius));
+            }
+
+            visibleCount = AppendVisible(MoveMaskNEON(inside), i, 4U, visible, visibleCount);
+        }
+
+        return CullSpheresScalar(frustum, spheres, i, count, visible, visibleCount);
+    }
+
+    static unsigned int CullBoxesNEON(const Frustum &frustum, const BoxBounds &boxes,
+                                      unsigned int count, unsigned int *visible)
+    {
+        glm::vec4 planes[Frustum::PLANE_COUNT];
+        CopyPlanes(frustum, planes);
+        const BoxCorners corners = SelectBoxCorners(frustum, boxes);
+        const float32x4_t zero = vdupq_n_f32(0.0F);
+
+        unsigned int visibleCount = 0U;
+        unsigned int i = 0U;
+        for (; i + 4U <= count; i += 4U)
+        {
+            uint32x4_t inside = vdupq_n_u32(0xFFFFFFFFU);
+            for (unsigned int p = 0U; p < Frustum::PLANE_COUNT; ++p)
+            {
+                const float32x4_t distance = PlaneDistanceNEON(planes[p], vld1q_f32(corners.x[p] + i),
+                                                               vld1q_f32(corners.y[p] + i), vld1q_f32(corners.z[p] + i));
+                inside = vandq_u32(inside, vcgeq_f32(distance, zero));
+            }
+
+            visibleCount = AppendVisible(MoveMaskNEON(inside), i, 4U, visible, visibleCount);
+        }
+
+        return CullBoxesScalar(frustum, boxes, i, count, visible, visibleCount);
+    }
+#endif
+
+
+    // ****************************
+    // Dispatch
+
+    unsigned int CullSpheres(const Frustum &frustum, const SphereBounds &spheres,
+                             unsigned int count, unsigned int *visible)
+    {
+        static const SimdPath path = GetBestSimdPath();
+        return CullSpheres(path, frustum, spheres, count, visible);
+    }
+
+    unsigned int CullBoxes(const Frustum &frustum, const BoxBounds &boxes,
+                           unsigned int count, unsigned int *visible)
+    {
+        static const SimdPath path = GetBestSimdPath();
+        return CullBoxes(path, frustum, boxes, count, visible);
+    }
+
+    unsigned int CullSpheres(SimdPath path, const Frustum &frustum, const SphereBounds &spheres,
+                             unsigned int count, unsigned int *visible)
+    {
+        assert(IsSimdPathSupported(path));
+
+        switch (path) {
+#if defined(GFXF_SIMD_X64)
+        case SimdPath::SSE2:
+            return CullSpheresSSE2(frustum, spheres, count, visible);
+
+        case SimdPath::AVX2:
+            return CullSpheresAVX2(frustum, spheres, count, visible);
+#endif
+
+#if defined(GFXF_SIMD_NEON)
+        case SimdPath::NEON:
+            return CullSpheresNEON(frustum, spheres, count, visible);
+#endif
+
+        default:
+            return CullSpheresScalar(frustum, spheres, 0U, count, visible, 0U);
+        }
+    }
+
+    unsigned int CullBoxes(SimdPath path, const Frustum &frustum, const BoxBounds &boxes,
+                           unsigned int count, unsigned int *visible)
+    {
+        assert(IsSimdPathSupported(path));
+
+        switch (path) {
+#if defined(GFXF_SIMD_X64)
+        case SimdPath::SSE2:
+            return CullBoxesSSE2(frustum, boxes, count, visible);
+
+        case SimdPath::AVX2:
+            return CullBoxesAVX2(frustum, boxes, count, visible);
+#endif
+
+#if defined(GFXF_SIMD_NEON)
+        case SimdPath::NEON:
+            return CullBoxesNEON(frustum, boxes, count, visible);
+#endif
+
+        default:
+            return CullBoxesScalar(frustum, boxes, 0U, count, visible, 0U);
+        }
+    }
+}
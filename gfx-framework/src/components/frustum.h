@@ -0,0 +1,80 @@
+#ifndef GFXC_FRUSTUM_H
+#define GFXC_FRUSTUM_H
+
+#include "components/exports.h"
+
+#include "utils/simd_utils.h"
+
+#include "glm/glm.hpp"
+
+
+namespace gfxc
+{
+    // The six planes of a view volume, in world space if extracted from a
+    // projection * view matrix. Each plane is stored as (normal, distance)
+    // with a unit normal that points inside the volume, so a point p is
+    // inside when dot(normal, p) + distance >= 0 for every plane.
+    class GFXC_API Frustum
+    {
+     public:
+        enum { PLANE_COUNT = 6 };
+
+        Frustum();
+
+        // Gribb-Hartmann extraction, for the OpenGL clip volume
+        // (-w <= x, y, z <= w)
+        void Extract(const glm::mat4 &viewProjection);
+
+        // Left, right, bottom, top, near, far
+        const glm::vec4& GetPlane(unsigned int index) const;
+
+        // Conservative tests: volumes that intersect the frustum are visible,
+        // and so are a few volumes near its corners that do not
+        bool IsSphereVisible(const glm::vec3 &center, float radius) const;
+        bool IsBoxVisible(const glm::vec3 &min, const glm::vec3 &max) const;
+
+     private:
+        glm::vec4       m_planes[PLANE_COUNT];
+    };
+
+
+    // Bounding volumes in structure of arrays layout, one array per
+    // component, so that the culling kernels can load several volumes with
+    // a single instruction
+    struct SphereBounds
+    {
+        const float *centerX;
+        const float *centerY;
+        const float *centerZ;
+        const float *radius;
+    };
+
+    struct BoxBounds
+    {
+        const float *minX;
+        const float *minY;
+        const float *minZ;
+        const float *maxX;
+        const float *maxY;
+        const float *maxZ;
+    };
+
+
+    // Test `count` volumes against the frustum, with the same tests as
+    // Frustum::IsSphereVisible and Frustum::IsBoxVisible. The indices of the
+    // visible volumes are written in increasing order to `visible`, which
+    // must hold `count` values. Returns the number of visible volumes.
+    GFXC_API unsigned int CullSpheres(const Frustum &frustum, const SphereBounds &spheres,
+                                      unsigned int count, unsigned int *visible);
+    GFXC_API unsigned int CullBoxes(const Frustum &frustum, const BoxBounds &boxes,
+                                    unsigned int count, unsigned int *visible);
+
+    // Same as above, but with an explicit instruction set. The path must be
+    // supported by the current CPU, see IsSimdPathSupported().
+    GFXC_API unsigned int CullSpheres(SimdPath path, const Frustum &frustum, const SphereBounds &spheres,
+                                      unsigned int count, unsigned int *visible);
+    GFXC_API unsigned int CullBoxes(SimdPath path, const Frustum &frustum, const BoxBounds &boxes,
+                                    unsigned int count, unsigned int *visible);
+}
+
+#endif
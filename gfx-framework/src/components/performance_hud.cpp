@@ -0,0 +1,109 @@
+#include "components/performance_hud.h"
+
+#include <algorithm>
+#include <cstdio>
+
+
+static const float kMargin = 8.0f;
+static const float kPanelWidth = 330.0f;
+static const float kGraphHeight = 60.0f;
+static const float kBarWidth = 2.0f;
+
+// Frame times at the top of the graph, and of the 60 FPS line
+static const float kGraphMaxMs = 33.3f;
+static const float kTargetMs = 16.7f;
+
+static const glm::vec4 kPanelColor(0.0f, 0.0f, 0.0f, 0.6f);
+static const glm::vec4 kTextColor(1.0f);
+static const glm::vec4 kHeaderColor(0.6f, 0.8f, 1.0f, 1.0f);
+static const glm::vec4 kTargetColor(1.0f, 1.0f, 1.0f, 0.3f);
+static const glm::vec4 kFastColor(0.3f, 0.9f, 0.3f, 1.0f);
+static const glm::vec4 kSlowColor(0.9f, 0.8f, 0.2f, 1.0f);
+static const glm::vec4 kVerySlowColor(0.9f, 0.3f, 0.2f, 1.0f);
+
+
+gfxc::PerformanceHud::PerformanceHud()
+{
+    m_nextFrame = 0;
+    m_frameTimeSum = 0;
+}
+
+
+void gfxc::PerformanceHud::AddFrameTime(double seconds)
+{
+    const float ms = static_cast<float>(seconds * 1000);
+
+    if (m_frameTimes.size() < kHistorySize)
+    {
+        m_frameTimes.push_back(ms);
+    }
+    else
+    {
+        m_frameTimeSum -= m_frameTimes[m_nextFrame];
+        m_frameTimes[m_nextFrame] = ms;
+        m_nextFrame = (m_nextFrame + 1) % kHistorySize;
+    }
+
+    m_frameTimeSum += ms;
+}
+
+
+void gfxc::PerformanceHud::Build(TextBatch &batch, const std::vector<GpuProfiler::ScopeStats> &passes, const RenderStats &stats) const
+{
+    const float lineHeight = batch.GetLineHeight(1.0f) + 6.0f;
+    const unsigned int lineCount = 5 + static_cast<unsigned int>(passes.size());
+
+    float y = kMargin;
+    batch.AddRect(0, 0, kPanelWidth, 2 * kMargin + kGraphHeight + kMargin + lineCount * lineHeight, kPanelColor);
+
+    // Frame time graph, oldest frame first
+    const float graphScale = kGraphHeight / kGraphMaxMs;
+    const unsigned int frameCount = static_cast<unsigned int>(m_frameTimes.size());
+    for (unsigned int i = 0; i < frameCount; i++)
+    {
+        const float ms = m_frameTimes[(m_nextFrame + i) % frameCount];
+        const float height = std::min(ms, kGraphMaxMs) * graphScale;
+        const glm::vec4 &color = ms <= kTargetMs ? kFastColor : (ms <= kGraphMaxMs ? kSlowColor : kVerySlowColor);
+
+        batch.AddRect(kMargin + i * kBarWidth, y + kGraphHeight - height, kBarWidth, height, color);
+    }
+    batch.AddRect(kMargin, y + kGraphHeight - kTargetMs * graphScale, kHistorySize * kBarWidth, 1, kTargetColor);
+    y += kGraphHeight + kMargin;
+
+    char line[128];
+    const double averageMs = GetAverageFrameTime();
+    const double lastMs = frameCount ? m_frameTimes[(m_nextFrame + frameCount - 1) % frameCount] : 0;
+
+    snprintf(line, sizeof(line), "FPS %5.1f  %6.2f ms  avg %6.2f ms", averageMs > 0 ? 1000 / averageMs : 0.0, lastMs, averageMs);
+    batch.AddText(line, kMargin, y, 1.0f, kTextColor);
+    y += lineHeight;
+
+    // Time of the passes, averaged over the frames of the profiler
+    snprintf(line, sizeof(line), "%-14s %8s %8s", "pass", "cpu ms", "gpu ms");
+    batch.AddText(line, kMargin, y, 1.0f, kHeaderColor);
+    y += lineHeight;
+
+    for (const GpuProfiler::ScopeStats &pass : passes)
+    {
+        snprintf(line, sizeof(line), "%-14.14s %8.3f %8.3f", pass.name.c_str(), pass.cpu.averageMs, pass.gpu.averageMs);
+        batch.AddText(line, kMargin, y, 1.0f, kTextColor);
+        y += lineHeight;
+    }
+
+    snprintf(line, sizeof(line), "draw calls %u  triangles %llu", stats.drawCalls, stats.triangles);
+    batch.AddText(line, kMargin, y, 1.0f, kTextColor);
+    y += lineHeight;
+
+    snprintf(line, sizeof(line), "textures %.1f MB  buffers %.1f MB", stats.textureBytes / (1024.0 * 1024.0), stats.bufferBytes / (1024.0 * 1024.0));
+    batch.AddText(line, kMargin, y, 1.0f, kTextColor);
+    y += lineHeight;
+
+    snprintf(line, sizeof(line), "shaders %d", stats.shaderPrograms);
+    batch.AddText(line, kMargin, y, 1.0f, kTextColor);
+}
+
+
+double gfxc::PerformanceHud::GetAverageFrameTime() const
+{
+    return m_frameTimes.empty() ? 0 : m_frameTimeSum / m_frameTimes.size();
+}
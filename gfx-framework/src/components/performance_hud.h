@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+
+#include "components/text_batch.h"
+#include "core/gpu/gpu_profiler.h"
+#include "core/gpu/render_stats.h"
+
+
+namespace gfxc
+{
+    // Overlay of the frame time graph, the FPS, the CPU and GPU time of the
+    // passes of a GpuProfiler, and the RenderStats counters. The overlay is
+    // added to a TextBatch as glyphs and rectangles, so a TextRenderer
+    // draws it with one call. Does not use OpenGL itself.
+    class PerformanceHud
+    {
+     public:
+        static const unsigned int kHistorySize = 120;
+
+     public:
+        PerformanceHud();
+
+        void AddFrameTime(double seconds);
+
+        // Adds the overlay to `batch`, at the top left corner of the screen
+        void Build(TextBatch &batch, const std::vector<GpuProfiler::ScopeStats> &passes, const RenderStats &stats) const;
+
+        // Over the frames of the graph, in milliseconds
+        double GetAverageFrameTime() const;
+
+     private:
+        std::vector<float> m_frameTimes;
+        unsigned int m_nextFrame;
+        double m_frameTimeSum;
+    };
+}
@@ -18,6 +18,11 @@ void gfxc::SceneInput::OnKeyPress(int key, int mods)
         scene->ToggleGroundPlane();
     }
 
+    if (key == GLFW_KEY_F4)
+    {
+        scene->ToggleHud();
+    }
+
     if (key == GLFW_KEY_F5)
     {
         scene->ReloadShaders();
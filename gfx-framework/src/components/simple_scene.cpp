@@ -1,6 +1,7 @@
 #include "components/simple_scene.h"
 
 #include <cmath>
+#include <typeinfo>
 #include <vector>
 #include <iostream>
 
@@ -15,6 +16,23 @@
 using namespace gfxc;
 
 
+// Returns an object of the pool that no recorded command holds anymore.
+// Commands are released when their list is cleared, on the update thread,
+// so the count only changes on this thread.
+template <typename T>
+static std::shared_ptr<T> AcquireFromPool(std::vector<std::shared_ptr<T>> &pool)
+{
+    for (const std::shared_ptr<T> &item : pool)
+    {
+        if (item.use_count() == 1)
+            return item;
+    }
+
+    pool.push_back(std::make_shared<T>());
+    return pool.back();
+}
+
+
 SimpleScene::SimpleScene()
 {
     InitResources();
@@ -23,6 +41,8 @@ SimpleScene::SimpleScene()
 
 SimpleScene::~SimpleScene()
 {
+    delete hudText;
+    delete profiler;
 }
 
 
@@ -43,7 +63,10 @@ void SimpleScene::InitResources()
 
     drawGroundPlane = true;
 
-    objectModel = new Transform();
+    showHud = false;
+    hudCreated = false;
+    profiler = nullptr;
+    hudText = nullptr;
 
     camera = new Camera();
     camera->SetPerspective(60, window->props.aspectRatio, 0.01f, 200);
@@ -52,32 +75,20 @@ void SimpleScene::InitResources()
     camera->m_transform->SetWorldRotation(glm::vec3(-15, 0, 0));
     camera->Update();
 
+    cameraUniforms = new CameraUniformBuffer();
+    instanceBuffer = new InstanceBuffer();
+    debugDrawBuffer = new DebugDrawBuffer();
+
     cameraInput = new CameraInput(camera);
     window = Engine::GetWindow();
 
     SceneInput *SI = new SceneInput(this);
     (void)SI;
 
-    xozPlane = new Mesh("plane");
-    xozPlane->LoadMesh(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::MODELS, "primitives"), "plane50.obj");
-
-    {
-        std::vector<VertexFormat> vertices =
-        {
-            VertexFormat(glm::vec3(0, 0, 0), glm::vec3(0, 1, 0)),
-            VertexFormat(glm::vec3(0, 1, 0), glm::vec3(0, 1, 0)),
-        };
-        std::vector<unsigned int> indices = { 0, 1 };
-
-        simpleLine = new Mesh("line");
-        simpleLine->InitFromData(vertices, indices);
-        simpleLine->SetDrawMode(GL_LINES);
-    }
-
     // Create a shader program for drawing face polygon with the color of the normal
     {
         Shader *shader = new Shader("Simple");
-        shader->AddShader(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::SHADERS, "MVP.Texture.VS.glsl"), GL_VERTEX_SHADER);
+        shader->AddShader(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::SHADERS, "MVP.CameraBlock.VS.glsl"), GL_VERTEX_SHADER);
         shader->AddShader(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::SHADERS, "Default.FS.glsl"), GL_FRAGMENT_SHADER);
         shader->CreateAndLink();
         shaders[shader->GetName()] = shader;
@@ -86,7 +97,7 @@ void SimpleScene::InitResources()
     // Create a shader program for drawing vertex colors
     {
         Shader *shader = new Shader("Color");
-        shader->AddShader(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::SHADERS, "MVP.Texture.VS.glsl"), GL_VERTEX_SHADER);
+        shader->AddShader(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::SHADERS, "MVP.CameraBlock.VS.glsl"), GL_VERTEX_SHADER);
         shader->AddShader(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::SHADERS, "Color.FS.glsl"), GL_FRAGMENT_SHADER);
         shader->CreateAndLink();
         shaders[shader->GetName()] = shader;
@@ -95,7 +106,7 @@ void SimpleScene::InitResources()
     // Create a shader program for drawing face polygon with the color of the normal
     {
         Shader *shader = new Shader("VertexNormal");
-        shader->AddShader(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::SHADERS, "MVP.Texture.VS.glsl"), GL_VERTEX_SHADER);
+        shader->AddShader(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::SHADERS, "MVP.CameraBlock.VS.glsl"), GL_VERTEX_SHADER);
         shader->AddShader(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::SHADERS, "Normals.FS.glsl"), GL_FRAGMENT_SHADER);
         shader->CreateAndLink();
         shaders[shader->GetName()] = shader;
@@ -104,12 +115,32 @@ void SimpleScene::InitResources()
     // Create a shader program for drawing vertex colors
     {
         Shader *shader = new Shader("VertexColor");
-        shader->AddShader(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::SHADERS, "MVP.Texture.VS.glsl"), GL_VERTEX_SHADER);
+        shader->AddShader(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::SHADERS, "MVP.CameraBlock.VS.glsl"), GL_VERTEX_SHADER);
         shader->AddShader(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::SHADERS, "VertexColor.FS.glsl"), GL_FRAGMENT_SHADER);
         shader->CreateAndLink();
         shaders[shader->GetName()] = shader;
     }
 
+    // Create a shader program for drawing queued meshes with the color of the
+    // normal, with one draw call for all the copies of a mesh
+    {
+        Shader *shader = new Shader("InstancedVertexNormal");
+        shader->AddDefine("INSTANCED");
+        shader->AddShader(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::SHADERS, "MVP.Instanced.VS.glsl"), GL_VERTEX_SHADER);
+        shader->AddShader(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::SHADERS, "Normals.FS.glsl"), GL_FRAGMENT_SHADER);
+        shader->CreateAndLink();
+        shaders[shader->GetName()] = shader;
+    }
+
+    // Create a shader program for drawing meshes that use a texture array
+    {
+        Shader *shader = new Shader("TextureArray");
+        shader->AddShader(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::SHADERS, "MVP.TextureArray.VS.glsl"), GL_VERTEX_SHADER);
+        shader->AddShader(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::SHADERS, "TextureArray.FS.glsl"), GL_FRAGMENT_SHADER);
+        shader->CreateAndLink();
+        shaders[shader->GetName()] = shader;
+    }
+
     // Default rendering mode will use depth buffer
     glDepthMask(GL_TRUE);
     glEnable(GL_DEPTH_TEST);
@@ -117,6 +148,7 @@ void SimpleScene::InitResources()
 
 
     testTransform = new Transform/*Wrapper*/();
+    testTime = 0;
     //std::cout << "------------------------1--------------------------\n";
     Transform *tParent = new Transform/*Wrapper*/();
     //std::cout << "------------------------2--------------------------\n";
@@ -178,48 +210,71 @@ void SimpleScene::DrawCoordinateSystem()
 
 void SimpleScene::DrawCoordinateSystem(const glm::mat4 & viewMatrix, const glm::mat4 & projectionMaxtix)
 {
-    glLineWidth(1);
-    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+    if (drawGroundPlane)
+        debugDraw.AddGrid(glm::vec3(0), 25, 1, glm::vec3(0.5f));
 
-    // Render the coordinate system
-    {
-        Shader *shader = shaders["Color"];
-        shader->Use();
-        glUniformMatrix4fv(shader->loc_view_matrix, 1, GL_FALSE, glm::value_ptr(viewMatrix));
-        glUniformMatrix4fv(shader->loc_projection_matrix, 1, GL_FALSE, glm::value_ptr(projectionMaxtix));
+    debugDraw.AddAxes(glm::mat4(1), 25, true);
 
-        if (drawGroundPlane)
-        {
-            objectModel->SetScale(glm::vec3(1));
-            objectModel->SetWorldPosition(glm::vec3(0));
-            glUniformMatrix4fv(shader->loc_model_matrix, 1, GL_FALSE, glm::value_ptr(objectModel->GetModel()));
-            glUniform3f(shader->GetUniformLocation("color"), 0.5f, 0.5f, 0.5f);
-            xozPlane->Render();
-        }
+    FlushDebugDraw(viewMatrix, projectionMaxtix);
+}
 
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
-        glLineWidth(3);
-        objectModel->SetScale(glm::vec3(1, 25, 1));
-        objectModel->SetWorldRotation(glm::quat());
-        glUniformMatrix4fv(shader->loc_model_matrix, 1, GL_FALSE, glm::value_ptr(objectModel->GetModel()));
-        glUniform3f(shader->GetUniformLocation("color"), 0, 1, 0);
-        simpleLine->Render();
+DebugDraw & SimpleScene::GetDebugDraw()
+{
+    return debugDraw;
+}
 
-        objectModel->SetWorldRotation(glm::vec3(0, 0, -90));
-        glUniformMatrix4fv(shader->loc_model_matrix, 1, GL_FALSE, glm::value_ptr(objectModel->GetModel()));
-        glUniform3f(shader->GetUniformLocation("color"), 1, 0, 0);
-        simpleLine->Render();
 
-        objectModel->SetWorldRotation(glm::vec3(90, 0, 0));
-        glUniformMatrix4fv(shader->loc_model_matrix, 1, GL_FALSE, glm::value_ptr(objectModel->GetModel()));
-        glUniform3f(shader->GetUniformLocation("color"), 0, 0, 1);
-        simpleLine->Render();
+void SimpleScene::FlushDebugDraw()
+{
+    FlushDebugDraw(camera->GetViewMatrix(), camera->GetProjectionMatrix());
+}
+
+
+void SimpleScene::FlushDebugDraw(const glm::mat4 & viewMatrix, const glm::mat4 & projectionMatrix)
+{
+    if (debugDraw.IsEmpty())
+        return;
 
-        objectModel->SetWorldRotation(glm::quat());
+    Shader *shader = shaders["VertexColor"];
 
-        glLineWidth(1);
+    if (!UsesRenderThread())
+    {
+        DrawDebugShapes(debugDraw, shader, viewMatrix, projectionMatrix);
+        debugDraw.Clear();
+        return;
     }
+
+    std::shared_ptr<DebugDraw> shapes = AcquireFromPool(debugDrawPool);
+    std::swap(*shapes, debugDraw);
+
+    Submit([this, shapes, shader, viewMatrix, projectionMatrix]()
+    {
+        DrawDebugShapes(*shapes, shader, viewMatrix, projectionMatrix);
+        shapes->Clear();
+    });
+}
+
+
+void SimpleScene::DrawDebugShapes(const DebugDraw & shapes, Shader * shader,
+                                  const glm::mat4 & viewMatrix, const glm::mat4 & projectionMatrix)
+{
+    GpuProfiler::Scope scope(profiler, "DebugDraw");
+    debugDrawBuffer->Upload(shapes);
+
+    // The vertices are in world space
+    shader->Use();
+    glUniformMatrix4fv(shader->loc_model_matrix, 1, GL_FALSE, glm::value_ptr(glm::mat4(1)));
+    SetCameraUniforms(shader, viewMatrix, projectionMatrix);
+
+    debugDrawBuffer->Draw(DebugDraw::POINTS);
+    debugDrawBuffer->Draw(DebugDraw::LINES);
+
+    glLineWidth(3);
+    debugDrawBuffer->Draw(DebugDraw::THICK_LINES);
+    glLineWidth(1);
+
+    glBindVertexArray(0);
 }
 
 
@@ -230,8 +285,7 @@ void SimpleScene::RenderMesh(Mesh * mesh, Shader * shader, glm::vec3 position, g
 
     // Render an object using the specified shader and the specified position
     shader->Use();
-    glUniformMatrix4fv(shader->loc_view_matrix, 1, GL_FALSE, glm::value_ptr(camera->GetViewMatrix()));
-    glUniformMatrix4fv(shader->loc_projection_matrix, 1, GL_FALSE, glm::value_ptr(camera->GetProjectionMatrix()));
+    SetCameraUniforms(shader);
 
     glm::mat4 model(1);
     model = glm::translate(model, position);
@@ -253,8 +307,7 @@ void SimpleScene::RenderMesh2D(Mesh * mesh, Shader * shader, const glm::mat3 &mo
         return;
 
     shader->Use();
-    glUniformMatrix4fv(shader->loc_view_matrix, 1, GL_FALSE, glm::value_ptr(camera->GetViewMatrix()));
-    glUniformMatrix4fv(shader->loc_projection_matrix, 1, GL_FALSE, glm::value_ptr(camera->GetProjectionMatrix()));
+    SetCameraUniforms(shader);
 
     glm::mat3 mm = modelMatrix;
     glm::mat4 model = glm::mat4(
@@ -284,8 +337,7 @@ void SimpleScene::RenderMesh2D(Mesh * mesh, const glm::mat3 & modelMatrix, const
 
     // Render an object using the specified shader and the specified position
     shader->Use();
-    glUniformMatrix4fv(shader->loc_view_matrix, 1, GL_FALSE, glm::value_ptr(camera->GetViewMatrix()));
-    glUniformMatrix4fv(shader->loc_projection_matrix, 1, GL_FALSE, glm::value_ptr(camera->GetProjectionMatrix()));
+    SetCameraUniforms(shader);
     glUniformMatrix4fv(shader->loc_model_matrix, 1, GL_FALSE, glm::value_ptr(model));
     glUniform3f(shader->GetUniformLocation("color"), color.r, color.g, color.b);
 
@@ -300,15 +352,145 @@ void SimpleScene::RenderMesh(Mesh * mesh, Shader * shader, const glm::mat4 & mod
 
     // Render an object using the specified shader and the specified position
     shader->Use();
-    glUniformMatrix4fv(shader->loc_view_matrix, 1, GL_FALSE, glm::value_ptr(camera->GetViewMatrix()));
-    glUniformMatrix4fv(shader->loc_projection_matrix, 1, GL_FALSE, glm::value_ptr(camera->GetProjectionMatrix()));
+    SetCameraUniforms(shader);
     glUniformMatrix4fv(shader->loc_model_matrix, 1, GL_FALSE, glm::value_ptr(modelMatrix));
 
     mesh->Render();
 }
 
 
-void SimpleScene::ReloadShaders() const
+void SimpleScene::QueueMesh(Mesh * mesh, Shader * shader, const glm::mat4 & modelMatrix, bool blend)
+{
+    DrawPacket packet = DrawPacket();
+    packet.mesh = mesh;
+    packet.shader = shader;
+    packet.model = modelMatrix;
+    packet.blend = blend;
+    QueueMesh(packet);
+}
+
+
+void SimpleScene::QueueMesh(const DrawPacket & packet)
+{
+    if (!packet.mesh || !packet.shader || !packet.shader->program)
+        return;
+
+    renderQueue.Submit(packet);
+}
+
+
+void SimpleScene::FlushRenderQueue()
+{
+    const CameraUniforms uniforms = CameraUniformBuffer::Capture(*camera, window->props.resolution);
+
+    if (!UsesRenderThread())
+    {
+        DrawRenderQueue(renderQueue, uniforms);
+        renderQueue.Clear();
+        return;
+    }
+
+    // The queue is drawn by the render thread, while the next frame is
+    // queued into another one
+    std::shared_ptr<RenderQueue> queue = AcquireFromPool(renderQueuePool);
+    std::swap(*queue, renderQueue);
+
+    Submit([this, queue, uniforms]()
+    {
+        DrawRenderQueue(*queue, uniforms);
+        queue->Clear();
+    });
+}
+
+
+void SimpleScene::DrawRenderQueue(RenderQueue & queue, const CameraUniforms & uniforms)
+{
+    GpuProfiler::Scope scope(profiler, "RenderQueue");
+    queue.Sort(uniforms.view);
+    cameraUniforms->Update(uniforms);
+
+    const std::vector<DrawBatch> &batches = queue.GetBatches();
+    const std::vector<glm::mat4> &models = queue.GetSortedModels();
+
+    // All the instanced batches read their matrices from one upload
+    for (const DrawBatch &batch : batches)
+    {
+        if (queue.GetSortedPacket(batch.first).shader->UsesInstancing())
+        {
+            instanceBuffer->Upload(models);
+            break;
+        }
+    }
+
+    RenderStateTracker state;
+    bool blend = false;
+
+    for (const DrawBatch &batch : batches)
+    {
+        const DrawPacket &packet = queue.GetSortedPacket(batch.first);
+        const RenderStateChange change = state.Apply(packet);
+
+        if (change.program)
+        {
+            packet.shader->Use();
+            SetCameraUniforms(packet.shader, uniforms);
+        }
+
+        if (change.mesh)
+            packet.mesh->Bind();
+
+        for (unsigned int t = 0; t < DrawPacket::kMaxTextures; t++)
+        {
+            if (change.textureMask & (1U << t))
+                packet.textures[t]->BindToTextureUnit(GL_TEXTURE0 + t);
+        }
+
+        if (change.blend)
+        {
+            blend = packet.blend;
+            if (blend)
+            {
+                glEnable(GL_BLEND);
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            }
+            else
+            {
+                glDisable(GL_BLEND);
+            }
+        }
+
+        if (packet.shader->UsesInstancing())
+        {
+            glUniform1ui(packet.shader->loc_instance_base, batch.first);
+            packet.mesh->Draw(batch.count);
+        }
+        else
+        {
+            for (unsigned int i = batch.first; i < batch.first + batch.count; i++)
+            {
+                glUniformMatrix4fv(packet.shader->loc_model_matrix, 1, GL_FALSE, glm::value_ptr(models[i]));
+                packet.mesh->Draw();
+            }
+        }
+
+        // The mesh binds its own textures to the first unit
+        if (packet.mesh->UsesMaterials())
+            state.ForgetTexture(0);
+    }
+
+    glBindVertexArray(0);
+    if (blend)
+        glDisable(GL_BLEND);
+}
+
+
+const RenderQueue & SimpleScene::GetRenderQueue() const
+{
+    return renderQueue;
+}
+
+
+void SimpleScene::ReloadShaders()
 {
     std::cout << std::endl;
     std::cout << "=============================" << std::endl;
@@ -316,10 +498,17 @@ void SimpleScene::ReloadShaders() const
     std::cout << "=============================" << std::endl;
     std::cout << std::endl;
 
+    std::vector<Shader *> reloaded;
     for (auto &shader : shaders)
     {
-        shader.second->Reload();
+        reloaded.push_back(shader.second);
     }
+
+    Submit([reloaded]()
+    {
+        for (Shader *shader : reloaded)
+            shader->Reload();
+    });
 }
 
 
@@ -335,18 +524,85 @@ InputController * SimpleScene::GetCameraInput() const
 }
 
 
+void SimpleScene::SetCameraUniforms(Shader *shader) const
+{
+    // The camera block already holds the scene camera
+    if (shader->UsesCameraBlock())
+        return;
+
+    glUniformMatrix4fv(shader->loc_view_matrix, 1, GL_FALSE, glm::value_ptr(camera->GetViewMatrix()));
+    glUniformMatrix4fv(shader->loc_projection_matrix, 1, GL_FALSE, glm::value_ptr(camera->GetProjectionMatrix()));
+}
+
+
+void SimpleScene::SetCameraUniforms(Shader *shader, const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix)
+{
+    if (shader->UsesCameraBlock())
+    {
+        // The clip planes cannot be told from the matrices, so they are kept
+        CameraUniforms uniforms = cameraUniforms->GetUniforms();
+        uniforms.view = viewMatrix;
+        uniforms.projection = projectionMatrix;
+        uniforms.viewProjection = projectionMatrix * viewMatrix;
+        uniforms.eyePosition = glm::inverse(viewMatrix)[3];
+        cameraUniforms->Update(uniforms);
+        return;
+    }
+
+    glUniformMatrix4fv(shader->loc_view_matrix, 1, GL_FALSE, glm::value_ptr(viewMatrix));
+    glUniformMatrix4fv(shader->loc_projection_matrix, 1, GL_FALSE, glm::value_ptr(projectionMatrix));
+}
+
+
+void SimpleScene::SetCameraUniforms(Shader *shader, const CameraUniforms &uniforms) const
+{
+    // The camera block is updated once per queue, see DrawRenderQueue
+    if (shader->UsesCameraBlock())
+        return;
+
+    glUniformMatrix4fv(shader->loc_view_matrix, 1, GL_FALSE, glm::value_ptr(uniforms.view));
+    glUniformMatrix4fv(shader->loc_projection_matrix, 1, GL_FALSE, glm::value_ptr(uniforms.projection));
+}
+
+
+void SimpleScene::UpdateCameraUniforms()
+{
+    const CameraUniforms uniforms = CameraUniformBuffer::Capture(*camera, window->props.resolution);
+
+    Submit([this, uniforms]()
+    {
+        cameraUniforms->Update(uniforms);
+    });
+}
+
+
+CameraUniformBuffer * SimpleScene::GetCameraUniformBuffer() const
+{
+    return cameraUniforms;
+}
+
+
 void SimpleScene::ClearScreen(const glm::vec3 &color)
 {
     glm::ivec2 resolution = window->props.resolution;
 
-    // Sets the clear color for the color buffer
-    glClearColor(color.x, color.y, color.z, 1);
+    Submit([color, resolution]()
+    {
+        // Sets the clear color for the color buffer
+        glClearColor(color.x, color.y, color.z, 1);
 
-    // Clears the color buffer (using the previously set color) and depth buffer
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        // Clears the color buffer (using the previously set color) and depth buffer
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // Sets the screen area where to draw
-    glViewport(0, 0, resolution.x, resolution.y);
+        // Sets the screen area where to draw
+        glViewport(0, 0, resolution.x, resolution.y);
+    });
+}
+
+
+bool SimpleScene::SupportsRenderThread() const
+{
+    return typeid(*this) == typeid(SimpleScene);
 }
 
 
@@ -356,6 +612,99 @@ bool SimpleScene::ToggleGroundPlane()
     return drawGroundPlane;
 }
 
+
+bool SimpleScene::ToggleHud()
+{
+    showHud = !showHud;
+
+    // The profiler and the font are only created once the HUD is used
+    if (showHud && !hudCreated)
+    {
+        const glm::ivec2 resolution = window->GetResolution();
+        const std::string selfDir = window->props.selfDir;
+
+        Submit([this, resolution, selfDir]()
+        {
+            profiler = new GpuProfiler();
+            hudText = new TextRenderer(selfDir, resolution.x, resolution.y);
+            hudText->Load(PATH_JOIN(selfDir, RESOURCE_PATH::FONTS, "Hack-Bold.ttf"), 14);
+        });
+        hudCreated = true;
+    }
+
+    return showHud;
+}
+
+
+GpuProfiler * SimpleScene::GetProfiler() const
+{
+    return profiler;
+}
+
+
+void SimpleScene::PreFrame()
+{
+    // The camera input has been handled, so the camera is set for the frame
+    UpdateCameraUniforms();
+
+    if (!hudCreated)
+        return;
+
+    Submit([this]()
+    {
+        profiler->BeginFrame();
+        profiler->BeginScope("Frame");
+    });
+}
+
+
+void SimpleScene::PostFrame()
+{
+    if (!hudCreated)
+    {
+        Submit([]() { render_stats::EndFrame(); });
+        return;
+    }
+
+    const bool show = showHud;
+    const double frameTime = GetLastFrameTime();
+    const glm::ivec2 resolution = window->GetResolution();
+
+    Submit([this, show, frameTime, resolution]()
+    {
+        profiler->EndScope();
+
+        // Counted before the HUD draws, so that it does not count itself
+        const RenderStats stats = render_stats::EndFrame();
+
+        if (show)
+            RenderHud(stats, frameTime, resolution);
+    });
+}
+
+
+void SimpleScene::RenderHud(const RenderStats &stats, double frameTime, const glm::ivec2 &resolution)
+{
+    GpuProfiler::Scope scope(profiler, "HUD");
+
+    hud.AddFrameTime(frameTime);
+    hud.Build(hudText->GetBatch(), profiler->GetScopes(), stats);
+
+    // Drawn over the whole window, on top of the scene
+    const GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+    glDisable(GL_DEPTH_TEST);
+    glViewport(0, 0, resolution.x, resolution.y);
+
+    hudText->SetScreenSize(resolution.x, resolution.y);
+    hudText->Flush();
+
+    if (depthTest)
+        glEnable(GL_DEPTH_TEST);
+
+    // The HUD's own draw is left out of the next frame
+    render_stats::EndFrame();
+}
+
 static unsigned frames = 0U;
 
 void SimpleScene::Update(float deltaTimeSeconds)
@@ -375,21 +724,23 @@ void SimpleScene::Update(float deltaTimeSeconds)
     Transform *parent = *testTransform->m_childNodes.begin();
     Transform *child = *parent->m_childNodes.begin();
 
-    static float totalTime = 0.0F;
     static const glm::vec3 initialParentLocal = parent->GetLocalPosition();
     static const glm::vec3 initialChildLocal = child->GetLocalPosition();
 
-    totalTime += deltaTimeSeconds;
+    // Per scene, so that two instances animate the same way
+    testTime += deltaTimeSeconds;
 
-    parent->SetLocalPosition(initialParentLocal + 0.5F * std::sin(totalTime * 5.0F) * glm::vec3_right);
+    parent->SetLocalPosition(initialParentLocal + 0.5F * std::sin(testTime * 5.0F) * glm::vec3_right);
     parent->RotateLocalOX(100.0F * deltaTimeSeconds);
     parent->RotateLocalOY(-50.0F * deltaTimeSeconds);
 
-    child->SetLocalPosition(initialChildLocal + 0.25F * std::sin(totalTime * 2.0F) * glm::vec3_up);
+    child->SetLocalPosition(initialChildLocal + 0.25F * std::sin(testTime * 2.0F) * glm::vec3_up);
     child->RotateLocalOZ(50.0F * deltaTimeSeconds);
 
-    RenderMesh(meshes.at("Box"), shaders.at("VertexNormal"), parent->GetModel());
-    RenderMesh(meshes.at("Box"), shaders.at("VertexNormal"), child->GetModel());
+    // Both boxes are drawn by a single instanced draw
+    QueueMesh(meshes.at("Box"), shaders.at("InstancedVertexNormal"), parent->GetModel());
+    QueueMesh(meshes.at("Box"), shaders.at("InstancedVertexNormal"), child->GetModel());
+    FlushRenderQueue();
 
     if (frames == 0U)
     {
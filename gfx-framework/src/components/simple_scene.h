@@ -1,13 +1,23 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "components/camera.h"
+#include "components/performance_hud.h"
+#include "components/text_renderer.h"
 
 #include "core/world.h"
 #include "core/engine.h"
+#include "core/gpu/camera_uniform_buffer.h"
+#include "core/gpu/debug_draw.h"
+#include "core/gpu/debug_draw_buffer.h"
+#include "core/gpu/gpu_profiler.h"
+#include "core/gpu/instance_buffer.h"
 #include "core/gpu/mesh.h"
+#include "core/gpu/render_queue.h"
 #include "core/gpu/shader.h"
 #include "core/gpu/texture2D.h"
 #include "core/managers/resource_path.h"
@@ -21,6 +31,10 @@
 
 namespace gfxc
 {
+    // With a render thread (see World::SetRenderThread), ClearScreen,
+    // FlushRenderQueue, FlushDebugDraw, DrawCoordinateSystem, the HUD and
+    // ReloadShaders submit their OpenGL work as commands. The RenderMesh
+    // functions still draw immediately, so they cannot be used then.
     class SimpleScene : public World
     {
         friend class SceneInput;
@@ -30,7 +44,13 @@ namespace gfxc
         ~SimpleScene();
 
         bool ToggleGroundPlane();
-        void ReloadShaders() const;
+        bool ToggleHud();
+        void ReloadShaders();
+
+        // True for this scene only. Derived scenes draw with RenderMesh and
+        // OpenGL calls from their callbacks, so they must override it once
+        // they submit their OpenGL work instead.
+        bool SupportsRenderThread() const override;
 
         protected:
         virtual void AddMeshToList(Mesh *mesh);
@@ -45,15 +65,60 @@ namespace gfxc
 
         virtual void RenderMesh(Mesh *mesh, Shader *shader, const glm::mat4 &modelMatrix);
 
+        // Deferred version of RenderMesh. The queued draws are sorted to
+        // reduce the state changes between them, and issued by
+        // FlushRenderQueue(), which must be called before the frame ends.
+        // Runs of draws that only differ by their model matrix are merged
+        // into one instanced draw if the shader uses instancing.
+        void QueueMesh(Mesh *mesh, Shader *shader, const glm::mat4 &modelMatrix, bool blend = false);
+        void QueueMesh(const DrawPacket &packet);
+        void FlushRenderQueue();
+        const RenderQueue& GetRenderQueue() const;
+
+        // Debug shapes added during the frame are drawn all at once, with
+        // one draw call per stream, by FlushDebugDraw(). The coordinate
+        // system and the ground grid are drawn the same way, and
+        // DrawCoordinateSystem() flushes the shapes added before it.
+        DebugDraw &GetDebugDraw();
+        void FlushDebugDraw();
+        void FlushDebugDraw(const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix);
+
         Camera *GetSceneCamera() const;
         InputController *GetCameraInput() const;
 
+        // Sets the View and Projection uniforms of the shader. Shaders that
+        // declare the camera block, like the default ones, read them from a
+        // uniform buffer instead, uploaded once per frame by
+        // UpdateCameraUniforms(). Scenes that change the scene camera during
+        // the frame call it again before drawing with it.
+        void SetCameraUniforms(Shader *shader) const;
+        void UpdateCameraUniforms();
+        CameraUniformBuffer *GetCameraUniformBuffer() const;
+
+        // Same, with the matrices of another camera. The camera block keeps
+        // them until the next update with the scene camera.
+        void SetCameraUniforms(Shader *shader, const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix);
+
         void ClearScreen(const glm::vec3 &color = glm::vec3(0, 0, 0));
 
+        // Null until the performance HUD is first shown. Scenes can time
+        // their own passes with GpuProfiler::Scope, which accepts null.
+        // With a render thread, only use it inside submitted commands.
+        GpuProfiler *GetProfiler() const;
+
      private:
         void InitResources();
         void Update(float deltaTimeSeconds) override;
 
+        void PreFrame() override;
+        void PostFrame() override;
+        void RenderHud(const RenderStats &stats, double frameTime, const glm::ivec2 &resolution);
+
+        void SetCameraUniforms(Shader *shader, const CameraUniforms &uniforms) const;
+        void DrawRenderQueue(RenderQueue &queue, const CameraUniforms &uniforms);
+        void DrawDebugShapes(const DebugDraw &shapes, Shader *shader,
+                             const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix);
+
         protected:
         std::unordered_map<std::string, Mesh *> meshes;
         std::unordered_map<std::string, Shader *> shaders;
@@ -69,13 +134,27 @@ namespace gfxc
      private:
         Camera *camera;
         InputController *cameraInput;
+        CameraUniformBuffer *cameraUniforms;
+        InstanceBuffer *instanceBuffer;
+        RenderQueue renderQueue;
 
         bool drawGroundPlane;
-        Mesh *xozPlane;
-        Mesh *simpleLine;
-        Transform *objectModel;
+        DebugDraw debugDraw;
+        DebugDrawBuffer *debugDrawBuffer;
+
+        // Queues and shapes handed to the render thread, reused once the
+        // commands that captured them are released
+        std::vector<std::shared_ptr<RenderQueue>> renderQueuePool;
+        std::vector<std::shared_ptr<DebugDraw>> debugDrawPool;
+
+        bool showHud;
+        bool hudCreated;
+        GpuProfiler *profiler;
+        TextRenderer *hudText;
+        PerformanceHud hud;
 
 
         Transform *testTransform;
+        float testTime;
     };
 }
@@ -0,0 +1,154 @@
+#ifndef GFXC_SMALL_VECTOR_H
+#define GFXC_SMALL_VECTOR_H
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+
+namespace gfxc
+{
+    // Contiguous array that stores up to N elements inline, and only moves
+    // them to the heap when it grows past that. Meant for small collections
+    // of plain values, such as the children of a node, so it only supports
+    // trivially copyable types.
+    template <class T, unsigned int N>
+    class SmallVector
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "SmallVector only stores trivially copyable types");
+        static_assert(N > 0U, "SmallVector needs some inline capacity");
+
+     public:
+        SmallVector()
+            : m_data(m_inline),
+              m_size(0U),
+              m_capacity(N)
+        {
+        }
+
+        SmallVector(const SmallVector &other)
+            : SmallVector()
+        {
+            *this = other;
+        }
+
+        ~SmallVector()
+        {
+            if (m_data != m_inline)
+            {
+                std::free(m_data);
+            }
+        }
+
+        SmallVector& operator=(const SmallVector &other)
+        {
+            if (this != &other)
+            {
+                m_size = 0U;
+                Reserve(other.m_size);
+                std::memcpy(m_data, other.m_data, other.m_size * sizeof(T));
+                m_size = other.m_size;
+            }
+            return *this;
+        }
+
+        void Reserve(unsigned int capacity)
+        {
+            if (capacity <= m_capacity)
+            {
+                return;
+            }
+
+            T *data = static_cast<T *>(std::malloc(capacity * sizeof(T)));
+            if (data == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+
+            std::memcpy(data, m_data, m_size * sizeof(T));
+
+            if (m_data != m_inline)
+            {
+                std::free(m_data);
+            }
+
+            m_data = data;
+            m_capacity = capacity;
+        }
+
+        void push_back(const T &value)
+        {
+            if (m_size == m_capacity)
+            {
+                // The value might live in this array, so copy it first
+                const T copy = value;
+                Reserve(m_capacity * 2U);
+                m_data[m_size++] = copy;
+                return;
+            }
+            m_data[m_size++] = value;
+        }
+
+        void pop_back()
+        {
+            assert(m_size > 0U);
+            --m_size;
+        }
+
+        // Removes the element at the given index in O(1) by moving the last
+        // element in its place, so the order of the elements is not kept
+        void SwapRemove(unsigned int index)
+        {
+            assert(index < m_size);
+            m_data[index] = m_data[m_size - 1U];
+            --m_size;
+        }
+
+        void clear()                                { m_size = 0U; }
+
+        unsigned int size() const                   { return m_size; }
+        bool empty() const                          { return m_size == 0U; }
+
+        T& operator[](unsigned int index)           { assert(index < m_size); return m_data[index]; }
+        const T& operator[](unsigned int index) const { assert(index < m_size); return m_data[index]; }
+
+        T& back()                                   { assert(m_size > 0U); return m_data[m_size - 1U]; }
+        const T& back() const                       { assert(m_size > 0U); return m_data[m_size - 1U]; }
+
+        T* begin()                                  { return m_data; }
+        T* end()                                    { return m_data + m_size; }
+        const T* begin() const                      { return m_data; }
+        const T* end() const                        { return m_data + m_size; }
+
+        bool operator==(const SmallVector &other) const
+        {
+            if (m_size != other.m_size)
+            {
+                return false;
+            }
+            for (unsigned int i = 0U; i < m_size; ++i)
+            {
+                if (!(m_data[i] == other.m_data[i]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool operator!=(const SmallVector &other) const
+        {
+            return !(*this == other);
+        }
+
+     private:
+        T *             m_data;
+        unsigned int    m_size;
+        unsigned int    m_capacity;
+        T               m_inline[N];
+    };
+}
+
+#endif
@@ -0,0 +1,111 @@
+#include "components/text_batch.h"
+
+
+gfxc::TextBatch::TextBatch()
+    : m_whiteTexCoord(0)
+{
+}
+
+
+void gfxc::TextBatch::SetCharacters(const std::vector<Character> &characters, const glm::vec2 &whiteTexCoord)
+{
+    m_characters = characters;
+    m_whiteTexCoord = whiteTexCoord;
+}
+
+
+float gfxc::TextBatch::AddText(const std::string &text, float x, float y, float scale, const glm::vec4 &color)
+{
+    const Character *reference = GetCharacter('H');
+    if (!reference)
+        return x;
+
+    for (char c : text)
+    {
+        const Character *ch = GetCharacter(c);
+        if (!ch)
+            continue;
+
+        if (ch->Size.x > 0 && ch->Size.y > 0)
+        {
+            glm::vec2 min(x + ch->Bearing.x * scale, y + (reference->Bearing.y - ch->Bearing.y) * scale);
+            glm::vec2 max = min + glm::vec2(ch->Size) * scale;
+            AddQuad(min, max, ch->TexCoordMin, ch->TexCoordMax, color);
+        }
+
+        // Bitshift by 6 to get the advance in pixels
+        x += (ch->Advance >> 6) * scale;
+    }
+
+    return x;
+}
+
+
+void gfxc::TextBatch::AddRect(float x, float y, float width, float height, const glm::vec4 &color)
+{
+    AddQuad(glm::vec2(x, y), glm::vec2(x + width, y + height), m_whiteTexCoord, m_whiteTexCoord, color);
+}
+
+
+float gfxc::TextBatch::GetTextWidth(const std::string &text, float scale) const
+{
+    float width = 0;
+    for (char c : text)
+    {
+        const Character *ch = GetCharacter(c);
+        if (ch)
+            width += (ch->Advance >> 6) * scale;
+    }
+    return width;
+}
+
+
+float gfxc::TextBatch::GetLineHeight(float scale) const
+{
+    const Character *reference = GetCharacter('H');
+    return reference ? reference->Size.y * scale : 0;
+}
+
+
+void gfxc::TextBatch::Clear()
+{
+    m_vertices.clear();
+}
+
+
+const std::vector<gfxc::TextVertex>& gfxc::TextBatch::GetVertices() const
+{
+    return m_vertices;
+}
+
+
+bool gfxc::TextBatch::IsEmpty() const
+{
+    return m_vertices.empty();
+}
+
+
+void gfxc::TextBatch::AddQuad(const glm::vec2 &min, const glm::vec2 &max,
+                              const glm::vec2 &texCoordMin, const glm::vec2 &texCoordMax,
+                              const glm::vec4 &color)
+{
+    const TextVertex topLeft = { min, texCoordMin, color };
+    const TextVertex topRight = { glm::vec2(max.x, min.y), glm::vec2(texCoordMax.x, texCoordMin.y), color };
+    const TextVertex bottomLeft = { glm::vec2(min.x, max.y), glm::vec2(texCoordMin.x, texCoordMax.y), color };
+    const TextVertex bottomRight = { max, texCoordMax, color };
+
+    m_vertices.push_back(bottomLeft);
+    m_vertices.push_back(topRight);
+    m_vertices.push_back(topLeft);
+
+    m_vertices.push_back(bottomLeft);
+    m_vertices.push_back(bottomRight);
+    m_vertices.push_back(topRight);
+}
+
+
+const gfxc::Character* gfxc::TextBatch::GetCharacter(char c) const
+{
+    const unsigned int index = static_cast<unsigned char>(c);
+    return index < m_characters.size() ? &m_characters[index] : nullptr;
+}
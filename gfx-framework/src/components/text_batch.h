@@ -0,0 +1,70 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+
+namespace gfxc
+{
+    /// Holds all state information relevant to a character as loaded using FreeType
+    struct Character
+    {
+        glm::ivec2 Size;        // Size of glyph
+        glm::ivec2 Bearing;     // Offset from baseline to left/top of glyph
+        unsigned int Advance;   // Horizontal offset to advance to next glyph, in 1/64 pixels
+
+        // Rectangle of the glyph in the font atlas
+        glm::vec2 TexCoordMin;
+        glm::vec2 TexCoordMax;
+    };
+
+
+    struct TextVertex
+    {
+        glm::vec2 position;
+        glm::vec2 texCoord;
+        glm::vec4 color;
+    };
+
+
+    // Quads of text and of solid rectangles, in screen pixels with the
+    // origin at the top left, appended to a single vertex array. Glyphs
+    // sample the font atlas; rectangles sample a white texel of the same
+    // atlas, so text and rectangles are drawn together with one call.
+    // Does not use OpenGL, see TextRenderer for drawing.
+    class TextBatch
+    {
+     public:
+        TextBatch();
+
+        // The first 128 ASCII characters, and a texture coordinate where
+        // the atlas is fully opaque
+        void SetCharacters(const std::vector<Character> &characters, const glm::vec2 &whiteTexCoord);
+
+        // `y` is the top of the line. Returns the x after the last glyph.
+        float AddText(const std::string &text, float x, float y, float scale, const glm::vec4 &color);
+        void AddRect(float x, float y, float width, float height, const glm::vec4 &color);
+
+        float GetTextWidth(const std::string &text, float scale) const;
+        float GetLineHeight(float scale) const;
+
+        void Clear();
+
+        // Two triangles per quad
+        const std::vector<TextVertex>& GetVertices() const;
+        bool IsEmpty() const;
+
+     private:
+        void AddQuad(const glm::vec2 &min, const glm::vec2 &max,
+                     const glm::vec2 &texCoordMin, const glm::vec2 &texCoordMax,
+                     const glm::vec4 &color);
+        const Character* GetCharacter(char c) const;
+
+     private:
+        std::vector<Character> m_characters;
+        glm::vec2 m_whiteTexCoord;
+        std::vector<TextVertex> m_vertices;
+    };
+}
@@ -8,18 +8,33 @@
 ******************************************************************/
 #include "components/text_renderer.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
 
 #include "utils/text_utils.h"
 #include "glm/gtc/matrix_transform.hpp"
+#include "core/gpu/render_stats.h"
 #include "core/managers/resource_path.h"
 
 #include "ft2build.h"
 #include FT_FREETYPE_H
 
 
+// Glyphs are packed in rows of the atlas, with a blank texel between them
+// so that linear filtering does not bleed into the neighbours
+static const unsigned int kAtlasWidth = 512;
+static const unsigned int kAtlasPadding = 1;
+
+// Opaque block in the top left corner of the atlas, sampled by rectangles
+static const unsigned int kWhiteSize = 4;
+
+
 gfxc::TextRenderer::TextRenderer(const std::string &selfDir, GLuint width, GLuint height)
 {
+    atlas = 0;
+    atlasBytes = 0;
+
     // Load and configure shader
     Shader *shader = new Shader("ShaderText");
     shader->AddShader(PATH_JOIN(selfDir, RESOURCE_PATH::SHADERS, "Text.VS.glsl"), GL_VERTEX_SHADER);
@@ -27,31 +42,38 @@ gfxc::TextRenderer::TextRenderer(const std::string &selfDir, GLuint width, GLuin
     shader->CreateAndLink();
     this->m_textShader = shader;
 
-    
-    int loc_projection_matrix = glGetUniformLocation(shader->program, "projection");
-    glUniformMatrix4fv(loc_projection_matrix, 1, GL_FALSE, glm::value_ptr(glm::ortho(0.0f, static_cast<GLfloat>(width), static_cast<GLfloat>(height), 0.0f)));
+    SetScreenSize(width, height);
 
     int loc_text = glGetUniformLocation(shader->program, "text");
     glUniform1i(loc_text, 0);
 
-    // Configure VAO/VBO for texture quads
+    // Configure VAO/VBO for the quads of the batch. The storage is
+    // allocated by the first Flush.
+    vertexBuffer = new StreamingBuffer(sizeof(TextVertex));
     glGenVertexArrays(1, &this->VAO);
-    glGenBuffers(1, &this->VBO);
     glBindVertexArray(this->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
+    vertexBuffer->Bind();
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), 0);
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (void*)offsetof(TextVertex, color));
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 }
 
 
-void gfxc::TextRenderer::Load(std::string font, GLuint fontSize)
+gfxc::TextRenderer::~TextRenderer()
 {
-    // First clear the previously loaded Characters
-    this->Characters.clear();
+    glDeleteVertexArrays(1, &this->VAO);
+    glDeleteTextures(1, &atlas);
+    delete vertexBuffer;
+    render_stats::AddTextureMemory(-static_cast<long long>(atlasBytes));
+    delete m_textShader;
+}
 
+
+void gfxc::TextRenderer::Load(std::string font, GLuint fontSize)
+{
     // Initialize and load the freetype library. All freetype functions
     // return a value different than 0 whenever an error occurs.
     FT_Library ft;
@@ -59,6 +81,7 @@ void gfxc::TextRenderer::Load(std::string font, GLuint fontSize)
     if (FT_Init_FreeType(&ft))
     {
         std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
+        return;
     }
 
     // Load font as face
@@ -66,124 +89,171 @@ void gfxc::TextRenderer::Load(std::string font, GLuint fontSize)
     if (FT_New_Face(ft, font.c_str(), 0, &face))
     {
         std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
+        FT_Done_FreeType(ft);
+        return;
     }
 
     // Set size to load glyphs as
     FT_Set_Pixel_Sizes(face, 0, fontSize);
 
-    // Disable byte-alignment restriction
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    // Then for the first 128 ASCII characters, pre-load/compile their
+    // characters, and place them in the atlas after the white block
+    std::vector<Character> characters(128);
+    std::vector<glm::uvec2> origins(128);
+    std::vector<std::vector<unsigned char>> bitmaps(128);
+
+    glm::uvec2 cursor(kWhiteSize + kAtlasPadding, 0);
+    unsigned int rowHeight = kWhiteSize;
 
-    // Then for the first 128 ASCII characters, pre-load/compile their characters and store them
     for (GLubyte c = 0; c < 128; c++)
     {
         // Load character glyph 
         if (FT_Load_Char(face, c, FT_LOAD_RENDER))
         {
             std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
+            characters[c] = Character();
             continue;
         }
 
-        // Generate texture
-        GLuint texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_RED,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
-            0,
-            GL_RED,
-            GL_UNSIGNED_BYTE,
-            face->glyph->bitmap.buffer
-        );
-
-        // Set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        // Now store character for later use
-        Character character = {
-            texture,
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-            (GLuint)face->glyph->advance.x
-        };
-
-        Characters.insert(std::pair<GLchar, Character>(c, character));
-    }
+        const FT_Bitmap &bitmap = face->glyph->bitmap;
+        const unsigned int w = std::min(bitmap.width, kAtlasWidth);
+        const unsigned int h = bitmap.rows;
 
-    glBindTexture(GL_TEXTURE_2D, 0);
+        if (cursor.x + w > kAtlasWidth)
+        {
+            cursor = glm::uvec2(0, cursor.y + rowHeight + kAtlasPadding);
+            rowHeight = 0;
+        }
+
+        origins[c] = cursor;
+        bitmaps[c].resize(w * h);
+        for (unsigned int row = 0; row < h; row++)
+            std::copy_n(bitmap.buffer + row * bitmap.pitch, w, bitmaps[c].begin() + row * w);
+
+        Character character;
+        character.Size = glm::ivec2(w, h);
+        character.Bearing = glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top);
+        character.Advance = static_cast<unsigned int>(face->glyph->advance.x);
+        characters[c] = character;
+
+        cursor.x += w + kAtlasPadding;
+        rowHeight = std::max(rowHeight, h);
+    }
 
     // Destroy freetype once we're finished
     FT_Done_Face(face);
     FT_Done_FreeType(ft);
-}
 
+    const unsigned int atlasHeight = cursor.y + rowHeight;
+    std::vector<unsigned char> pixels(kAtlasWidth * atlasHeight, 0);
 
-void gfxc::TextRenderer::RenderText(std::string text, GLfloat x, GLfloat y, GLfloat scale, glm::vec3 color)
-{
-    // Activate corresponding render state    
-    if (this->m_textShader)
+    for (unsigned int row = 0; row < kWhiteSize; row++)
+        std::fill_n(pixels.begin() + row * kAtlasWidth, kWhiteSize, 255);
+
+    const glm::vec2 atlasSize(kAtlasWidth, atlasHeight);
+    for (unsigned int c = 0; c < 128; c++)
     {
-        glUseProgram(this->m_textShader->program);
-        CheckOpenGLError();
+        const unsigned int w = characters[c].Size.x;
+        for (unsigned int row = 0; row < static_cast<unsigned int>(characters[c].Size.y); row++)
+        {
+            std::copy_n(bitmaps[c].begin() + row * w, w,
+                        pixels.begin() + (origins[c].y + row) * kAtlasWidth + origins[c].x);
+        }
+
+        characters[c].TexCoordMin = glm::vec2(origins[c]) / atlasSize;
+        characters[c].TexCoordMax = glm::vec2(origins[c] + glm::uvec2(characters[c].Size)) / atlasSize;
     }
 
-    // TODO(developer): Update this class
-    int loc_text_color = glGetUniformLocation(this->m_textShader->program, "textColor");
-    glUniform3f(loc_text_color, color.r, color.g, color.b);
+    batch.SetCharacters(characters, glm::vec2(kWhiteSize * 0.5f) / atlasSize);
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(this->VAO);
+    // Replace the previously loaded atlas
+    glDeleteTextures(1, &atlas);
+    render_stats::AddTextureMemory(static_cast<long long>(pixels.size()) - atlasBytes);
+    atlasBytes = static_cast<unsigned int>(pixels.size());
 
-    // Iterate through all characters
-    for (auto c = text.cbegin(); c != text.cend(); c++)
-    {
-        Character ch = Characters[*c];
+    // Disable byte-alignment restriction
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
-        GLfloat xpos = x + ch.Bearing.x * scale;
-        GLfloat ypos = y + (this->Characters['H'].Bearing.y - ch.Bearing.y) * scale;
+    glGenTextures(1, &atlas);
+    glBindTexture(GL_TEXTURE_2D, atlas);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, kAtlasWidth, atlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
 
-        GLfloat w = ch.Size.x * scale;
-        GLfloat h = ch.Size.y * scale;
+    // Set texture options
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-        // Update VBO for each character
-        GLfloat vertices[6][4] = {
-            { xpos,     ypos + h,   0.0, 1.0 },
-            { xpos + w, ypos,       1.0, 0.0 },
-            { xpos,     ypos,       0.0, 0.0 },
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+
+void gfxc::TextRenderer::RenderText(std::string text, GLfloat x, GLfloat y, GLfloat scale, glm::vec3 color)
+{
+    AddText(text, x, y, scale, glm::vec4(color, 1.0f));
+    Flush();
+}
 
-            { xpos,     ypos + h,   0.0, 1.0 },
-            { xpos + w, ypos + h,   1.0, 1.0 },
-            { xpos + w, ypos,       1.0, 0.0 }
-        };
 
-        // Render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
+float gfxc::TextRenderer::AddText(const std::string &text, GLfloat x, GLfloat y, GLfloat scale, const glm::vec4 &color)
+{
+    return batch.AddText(text, x, y, scale, color);
+}
 
-        // Update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices); // Be sure to use glBufferSubData and not glBufferData
 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+void gfxc::TextRenderer::AddRect(GLfloat x, GLfloat y, GLfloat width, GLfloat height, const glm::vec4 &color)
+{
+    batch.AddRect(x, y, width, height, color);
+}
 
-        // Render quad
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-        glDisable(GL_BLEND);
 
-        // Now advance cursors for next glyph. Bitshift by 6
-        // to get value in pixels.
-        x += (ch.Advance >> 6) * scale; 
+void gfxc::TextRenderer::Flush()
+{
+    const std::vector<TextVertex> &vertices = batch.GetVertices();
+    if (vertices.empty() || !this->m_textShader || !this->m_textShader->program)
+    {
+        batch.Clear();
+        return;
     }
 
+    glUseProgram(this->m_textShader->program);
+    CheckOpenGLError();
+
+    const unsigned int vertexCount = static_cast<unsigned int>(vertices.size());
+
+    vertexBuffer->Orphan(vertexCount);
+    vertexBuffer->SetData(0, vertices.data(), vertexCount);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, atlas);
+    glBindVertexArray(this->VAO);
+
+    // Render all quads
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+    glDisable(GL_BLEND);
+    render_stats::AddDraw(GL_TRIANGLES, vertexCount);
+
     glBindVertexArray(0);
     glBindTexture(GL_TEXTURE_2D, 0);
+
+    batch.Clear();
+}
+
+
+void gfxc::TextRenderer::SetScreenSize(GLuint width, GLuint height)
+{
+    glUseProgram(this->m_textShader->program);
+
+    int loc_projection_matrix = glGetUniformLocation(this->m_textShader->program, "projection");
+    glUniformMatrix4fv(loc_projection_matrix, 1, GL_FALSE, glm::value_ptr(glm::ortho(0.0f, static_cast<GLfloat>(width), static_cast<GLfloat>(height), 0.0f)));
+}
+
+
+gfxc::TextBatch& gfxc::TextRenderer::GetBatch()
+{
+    return batch;
 }
@@ -9,55 +9,65 @@
 #ifndef TEXT_RENDERER_H
 #define TEXT_RENDERER_H
 
-#include <map>
 #include <string>
+#include <vector>
 
 #include "GL/glew.h"
 #include "glm/glm.hpp"
 
+#include "components/text_batch.h"
 #include "core/gpu/mesh.h"
 #include "core/gpu/shader.h"
+#include "core/gpu/streaming_buffer.h"
 #include "core/engine.h"
 
 
 namespace gfxc
 {
-    /// Holds all state information relevant to a character as loaded using FreeType
-    struct Character
-    {
-        GLuint TextureID;   // ID handle of the glyph texture
-        glm::ivec2 Size;    // Size of glyph
-        glm::ivec2 Bearing; // Offset from baseline to left/top of glyph
-        GLuint Advance;     // Horizontal offset to advance to next glyph
-    };
-
-
     // A renderer class for rendering text displayed by a font loaded using the 
-    // FreeType library. A single font is loaded, processed into a list of Character
-    // items for later rendering.
+    // FreeType library. A single font is loaded, and its first 128 characters
+    // are packed into one atlas texture. Text and rectangles are added to a
+    // TextBatch and drawn together with one call by Flush.
     class TextRenderer
     {
      public:
-        // Holds a list of pre-compiled Characters
-        std::map<GLchar, Character> Characters;
-
         // Shader used for text rendering
         Shader *m_textShader;
 
         public:
         // Constructor
         TextRenderer(const std::string &selfDir, GLuint width, GLuint height);
+        ~TextRenderer();
+
+        TextRenderer(const TextRenderer &) = delete;
+        TextRenderer& operator=(const TextRenderer &) = delete;
 
         // Pre-compiles a list of characters from the given font
         void Load(std::string font, GLuint fontSize);
 
-        // Renders a string of text using the precompiled list of characters
+        // Renders a string of text using the precompiled list of characters,
+        // with one draw call
         void RenderText(std::string text, GLfloat x, GLfloat y, GLfloat scale, glm::vec3 color = glm::vec3(1.0f));
-        
+
+        // Queue text and rectangles, drawn by the next Flush
+        float AddText(const std::string &text, GLfloat x, GLfloat y, GLfloat scale, const glm::vec4 &color);
+        void AddRect(GLfloat x, GLfloat y, GLfloat width, GLfloat height, const glm::vec4 &color);
+        void Flush();
+
+        // Size of the screen the coordinates are given in
+        void SetScreenSize(GLuint width, GLuint height);
+
+        TextBatch& GetBatch();
+
      private:
         // Render state
-        GLuint VAO, VBO;
+        GLuint VAO;
+        StreamingBuffer *vertexBuffer;
+        GLuint atlas;
+        unsigned int atlasBytes;
+
+        TextBatch batch;
     };
 }
 
-#endif 
+#endif
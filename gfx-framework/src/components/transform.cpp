@@ -1,12 +1,25 @@
 #include "glm/ext/quaternion_common.hpp"
+#include "glm/gtc/matrix_inverse.hpp"
 #include "glm/gtx/quaternion.hpp"
 #include "transform.h"
+#include "transform_journal.h"
 
 #include "utils/glm_utils.h"
 #include "utils/math_utils.h"
 
+#include <atomic>
+#include <vector>
+
 namespace gfxc
 {
+    // Orders the changes made in lazy mode, see m_propagationStamp
+    static std::atomic<std::uint64_t> lastLazyStamp(0U);
+
+    static std::uint64_t NextLazyStamp()
+    {
+        return lastLazyStamp.fetch_add(1U, std::memory_order_relaxed) + 1U;
+    }
+
     Transform::Transform()
         : m_worldRotation(0.0F, 0.0F, 0.0F, 0.0F),
           m_relativeRotation(0.0F, 0.0F, 0.0F, 0.0F),
@@ -36,7 +49,10 @@ namespace gfxc
     
     Transform::~Transform()
     {
-
+        if (m_isJournaled)
+        {
+            m_journal->Forget(this);
+        }
     }
     
 
@@ -64,6 +80,124 @@ namespace gfxc
     }
     
 
+    // ****************************
+    // Lazy hierarchy update
+
+    void Transform::SetLazyUpdate(bool value)
+    {
+        // Leaving lazy mode requires the world data to be up to date
+        if (!value)
+        {
+            FlushHierarchy();
+        }
+
+        // Parents are always processed before their children are pushed
+        std::vector<Transform *> stack(1, this);
+        while (!stack.empty())
+        {
+            Transform *node = stack.back();
+            stack.pop_back();
+
+            if (value and !node->m_lazyUpdate)
+            {
+                node->EnterLazyUpdate();
+            }
+
+            node->m_lazyUpdate = value;
+            stack.insert(stack.end(), node->m_childNodes.begin(), node->m_childNodes.end());
+        }
+    }
+    
+    bool Transform::GetLazyUpdate() const
+    {
+        return m_lazyUpdate;
+    }
+    
+    void Transform::FlushHierarchy()
+    {
+        ResolveWorldInfo();
+
+        // Parents are always resolved before their children are pushed
+        std::vector<Transform *> stack(m_childNodes.begin(), m_childNodes.end());
+        while (!stack.empty())
+        {
+            Transform *node = stack.back();
+            stack.pop_back();
+
+            if (node->m_isWorldOutdated)
+            {
+                node->ResolveOutdatedChain();
+            }
+            stack.insert(stack.end(), node->m_childNodes.begin(), node->m_childNodes.end());
+        }
+    }
+    
+
+    // ****************************
+    // Batched mutation
+
+    void Transform::SetWorldPositions(Transform *const *transforms, const glm::vec3 *positions, unsigned int count)
+    {
+        std::vector<Transform *> parents;
+
+        for (unsigned int i = 0; i < count; i++)
+        {
+            Transform *transform = transforms[i];
+            if (!parents.empty())
+            {
+                transform->ResolveBatchAncestors(false);
+            }
+
+            transform->ApplyWorldPosition(positions[i]);
+            transform->EnterBatch(parents);
+        }
+
+        PropagateBatch(parents.data(), static_cast<unsigned int>(parents.size()), false);
+    }
+    
+    void Transform::SetWorldRotations(Transform *const *transforms, const glm::quat *rotations, unsigned int count)
+    {
+        std::vector<Transform *> parents;
+
+        for (unsigned int i = 0; i < count; i++)
+        {
+            Transform *transform = transforms[i];
+            if (!parents.empty())
+            {
+                transform->ResolveBatchAncestors(true);
+            }
+
+            transform->ApplyWorldRotation(rotations[i]);
+            transform->EnterBatch(parents);
+        }
+
+        PropagateBatch(parents.data(), static_cast<unsigned int>(parents.size()), true);
+    }
+    
+    void Transform::MoveAll(Transform *const *transforms, unsigned int count, const glm::vec3 &dir, float deltaTime)
+    {
+        const glm::vec3 direction = glm::normalize(dir);
+        std::vector<Transform *> parents;
+
+        for (unsigned int i = 0; i < count; i++)
+        {
+            Transform *transform = transforms[i];
+            if (!parents.empty())
+            {
+                transform->ResolveBatchAncestors(false);
+            }
+
+            transform->ResolveWorldInfo();
+            transform->ApplyWorldPosition(transform->m_worldPosition + transform->m_translationSpeed * deltaTime * direction);
+            transform->MarkModelOutdated();
+
+            transform->EnterBatch(parents);
+        }
+
+        PropagateBatch(parents.data(), static_cast<unsigned int>(parents.size()), false);
+    }
+    
+
     // ****************************
     // Get transform properties
 
@@ -74,11 +208,13 @@ namespace gfxc
     
     glm::vec3 Transform::GetWorldPosition() const
     {
+        ResolveWorldInfo();
         return m_worldPosition;
     }
     
     glm::quat Transform::GetWorldRotation() const
     {
+        ResolveWorldInfo();
         return m_worldRotation;
     }
     
@@ -89,27 +225,32 @@ namespace gfxc
     
     glm::vec3 Transform::GetRotationEulerRad() const
     {
+        ResolveWorldInfo();
         return glm::eulerAngles(m_worldRotation);
     }
     
     glm::vec3 Transform::GetRotationEuler360() const
     {
+        ResolveWorldInfo();
         return DEGREES(glm::eulerAngles(m_worldRotation));
     }
     
 
     glm::vec3 Transform::GetLocalOYVector() const
     {
+        ResolveWorldInfo();
         return m_worldRotation * glm::vec3_up;
     }
     
     glm::vec3 Transform::GetLocalOXVector() const
     {
+        ResolveWorldInfo();
         return m_worldRotation * glm::vec3_right;
     }
     
     glm::vec3 Transform::GetLocalOZVector() const
     {
+        ResolveWorldInfo();
         return m_worldRotation * glm::vec3_forward;
     }
     
@@ -121,6 +262,8 @@ namespace gfxc
     
     const glm::mat4& Transform::GetModel()
     {
+        ResolveWorldInfo();
+
         if (m_isModelOutdated)
         {
             ComputeWorldModel();
@@ -128,6 +271,52 @@ namespace gfxc
         return m_worldModel;
     }
     
+    const glm::mat4& Transform::GetInverseModel()
+    {
+        UpdateInverseModel();
+        return m_invWorldModel;
+    }
+    
+    const glm::mat3& Transform::GetNormalMatrix()
+    {
+        UpdateInverseModel();
+        return m_normalMatrix;
+    }
+    
+    std::uint64_t Transform::GetModelVersion() const
+    {
+        ResolveWorldInfo();
+        return m_modelVersion;
+    }
+    
+
+    // ****************************
+    // Change journal
+
+    void Transform::SetJournal(TransformJournal *journal, unsigned int objectId)
+    {
+        if (m_isJournaled)
+        {
+            m_journal->Forget(this);
+        }
+
+        m_journal = journal;
+        m_objectId = objectId;
+
+        // The matrix was never sent to this journal, so it counts as changed
+        RecordChange();
+    }
+    
+    TransformJournal* Transform::GetJournal() const
+    {
+        return m_journal;
+    }
+    
+    unsigned int Transform::GetObjectId() const
+    {
+        return m_objectId;
+    }
+    
 
     float Transform::GetMoveSpeed() const
     {
@@ -150,6 +339,7 @@ namespace gfxc
 
     void Transform::Move(const glm::vec3 &offset)
     {
+        ResolveWorldInfo();
         SetWorldPosition(m_worldPosition + offset);
 
         UpdateWorldModel();
@@ -157,6 +347,7 @@ namespace gfxc
     
     void Transform::Move(const glm::vec3 &dir, float deltaTime)
     {
+        ResolveWorldInfo();
         SetWorldPosition(m_worldPosition + m_translationSpeed * deltaTime * glm::normalize(dir));
 
         UpdateWorldModel();
@@ -173,6 +364,7 @@ namespace gfxc
     // Rotations
     void Transform::RotateWorldOX(float deltaTime)
     {
+        ResolveWorldInfo();
         const glm::vec3 angles = deltaTime * m_rotationSpeed * glm::vec3_right;
         const glm::quat worldRotation = glm::quat( RADIANS(angles) ) * m_worldRotation;
 
@@ -181,6 +373,7 @@ namespace gfxc
     
     void Transform::RotateWorldOY(float deltaTime)
     {
+        ResolveWorldInfo();
         const glm::vec3 angles = deltaTime * m_rotationSpeed * glm::vec3_up;
         const glm::quat worldRotation = glm::quat( RADIANS(angles) ) * m_worldRotation;
 
@@ -189,6 +382,7 @@ namespace gfxc
     
     void Transform::RotateWorldOZ(float deltaTime)
     {
+        ResolveWorldInfo();
         const glm::vec3 angles = deltaTime * m_rotationSpeed * glm::vec3_forward;
         const glm::quat worldRotation = glm::quat( RADIANS(angles) ) * m_worldRotation;
 
@@ -197,6 +391,7 @@ namespace gfxc
     
     void Transform::RotateLocalOX(float deltaTime)
     {
+        ResolveWorldInfo();
         const glm::vec3 angles = deltaTime * m_rotationSpeed * glm::vec3_right;
         const glm::quat worldRotation = m_worldRotation * glm::quat( RADIANS(angles) );
 
@@ -205,6 +400,7 @@ namespace gfxc
     
     void Transform::RotateLocalOY(float deltaTime)
     {
+        ResolveWorldInfo();
         const glm::vec3 angles = deltaTime * m_rotationSpeed * glm::vec3_up;
         const glm::quat worldRotation = m_worldRotation * glm::quat( RADIANS(angles) );
 
@@ -213,6 +409,7 @@ namespace gfxc
     
     void Transform::RotateLocalOZ(float deltaTime)
     {
+        ResolveWorldInfo();
         const glm::vec3 angles = deltaTime * m_rotationSpeed * glm::vec3_forward;
         const glm::quat worldRotation = m_worldRotation * glm::quat( RADIANS(angles) );
 
@@ -225,6 +422,14 @@ namespace gfxc
     {
         m_localPosition = position;
 
+        if (m_lazyUpdate)
+        {
+            m_positionStamp = NextLazyStamp();
+            MarkHierarchyOutdated();
+            UpdateWorldModel();
+            return;
+        }
+
         UpdateWorldPosition();
         UpdateChildrenPosition();
         UpdateModelPosition();
@@ -232,6 +437,22 @@ namespace gfxc
     
     void Transform::SetWorldPosition(glm::vec3 position)
     {
+        if (m_lazyUpdate)
+        {
+            if (m_parentNode != nullptr)
+            {
+                m_parentNode->ResolveWorldInfo();
+            }
+
+            m_localPosition = (m_parentNode == nullptr)
+                              ? position
+                              : m_parentNode->m_invWorldRotation * (position - m_parentNode->m_worldPosition);
+            m_positionStamp = NextLazyStamp();
+            MarkHierarchyOutdated();
+            UpdateWorldModel();
+            return;
+        }
+
         m_worldPosition = position;
 
         UpdateLocalPosition();
@@ -243,6 +464,22 @@ namespace gfxc
     // Rotations
     void Transform::SetWorldRotation(glm::quat rotationQ)
     {
+        if (m_lazyUpdate)
+        {
+            if (m_parentNode != nullptr)
+            {
+                m_parentNode->ResolveWorldInfo();
+            }
+
+            m_relativeRotation = (m_parentNode == nullptr)
+                                 ? rotationQ
+                                 : m_parentNode->m_invWorldRotation * rotationQ;
+            m_rotationStamp = NextLazyStamp();
+            MarkHierarchyOutdated();
+            UpdateWorldModel();
+            return;
+        }
+
         m_worldRotation = rotationQ;
         m_invWorldRotation = glm::inverse(rotationQ);
 
@@ -271,6 +508,15 @@ namespace gfxc
     
     void Transform::SetReleativeRotation(const glm::quat &localRotationQ)
     {
+        if (m_lazyUpdate)
+        {
+            m_relativeRotation = localRotationQ;
+            m_rotationStamp = NextLazyStamp();
+            MarkHierarchyOutdated();
+            UpdateWorldModel();
+            return;
+        }
+
         const glm::quat worldRotation = (m_parentNode == nullptr)
                                         ? localRotationQ
                                         : m_parentNode->m_worldRotation * localRotationQ;
@@ -311,21 +557,25 @@ namespace gfxc
     // Transform operations
     float Transform::DistanceTo(Transform *transform)
     {
+        ResolveWorldInfo();
         return glm::length(transform->GetWorldPosition() - m_worldPosition);
     }
     
     float Transform::DistanceTo(const glm::vec3 &position)
     {
+        ResolveWorldInfo();
         return glm::length(position - m_worldPosition);
     }
     
     float Transform::Distance2To(Transform *transform)
     {
+        ResolveWorldInfo();
         return glm::length2(transform->GetWorldPosition() - m_worldPosition);
     }
     
     float Transform::Distance2To(const glm::vec3 &position)
     {
+        ResolveWorldInfo();
         return glm::length2(position - m_worldPosition);
     }
     
@@ -335,6 +585,20 @@ namespace gfxc
 
     void Transform::AddChild(Transform *transform)
     {
+        if (m_lazyUpdate or transform->m_lazyUpdate)
+        {
+            // Keep the world placement of the child, in the mode of the parent
+            transform->SetLazyUpdate(m_lazyUpdate);
+            transform->ResolveWorldInfo();
+        }
+
+        // A node has a single slot, so it is detached from its previous parent
+        if (transform->m_parentNode != nullptr)
+        {
+            transform->m_parentNode->RemoveChild(transform);
+        }
+
+        transform->m_childSlot = m_childNodes.size();
         m_childNodes.push_back(transform);
 
         transform->m_parentNode = this;
@@ -345,9 +609,22 @@ namespace gfxc
     
     void Transform::RemoveChild(Transform *transform)
     {
-        (void)(m_childNodes.remove(transform));
+        if (transform->m_parentNode != this)
+        {
+            return;
+        }
+
+        transform->ResolveWorldInfo();
+
+        const unsigned int slot = transform->m_childSlot;
+        m_childNodes.SwapRemove(slot);
+        if (slot < m_childNodes.size())
+        {
+            m_childNodes[slot]->m_childSlot = slot;
+        }
 
         transform->m_parentNode = nullptr;
+        transform->m_childSlot = 0U;
         transform->SetWorldPosition(transform->m_worldPosition);
         transform->SetWorldRotation(transform->m_worldRotation);
     }
@@ -357,9 +634,22 @@ namespace gfxc
     {
         m_relativeRotation = glm::quat();
         m_parentNode = nullptr;
+        m_childSlot = 0U;
         m_isInMotion = false;
         m_isModelOutdated = true;
         m_updateHierarchy = true;
+        m_lazyUpdate = false;
+        m_isWorldOutdated = false;
+        m_isInBatch = false;
+        m_ignoresParentPosition = false;
+        m_propagationStamp = 0U;
+        m_positionStamp = 0U;
+        m_rotationStamp = 0U;
+        m_modelVersion = 0U;
+        m_inverseModelVersion = 0U;
+        m_journal = nullptr;
+        m_objectId = 0U;
+        m_isJournaled = false;
 
         UpdateWorldModel();
     }
@@ -377,15 +667,19 @@ namespace gfxc
         m_worldModel *= glm::toMat4(m_worldRotation);
         m_worldModel = glm::scale(m_worldModel, m_localScalingFactor);
 
-        UpdateModelPosition();
+        // Same as UpdateModelPosition, but the model did not change since the
+        // last version, it is only brought up to date
+        m_worldModel[3][0] = m_worldPosition.x;
+        m_worldModel[3][1] = m_worldPosition.y;
+        m_worldModel[3][2] = m_worldPosition.z;
 
+        m_isInMotion = true;
         m_isModelOutdated = false;
     }
     
     void Transform::UpdateWorldModel()
     {
-        m_isInMotion = true;
-        m_isModelOutdated = true;
+        MarkModelOutdated();
     }
     
     void Transform::UpdateWorldPosition()
@@ -394,6 +688,7 @@ namespace gfxc
                               ? m_localPosition
                               : m_parentNode->m_worldPosition + m_parentNode->m_worldRotation * m_localPosition;
         m_worldPosition = pos;
+        m_ignoresParentPosition = false;
     }
     
     void Transform::UpdateLocalPosition()
@@ -402,6 +697,7 @@ namespace gfxc
                               ? m_worldPosition
                               : m_parentNode->m_invWorldRotation * (m_worldPosition - m_parentNode->m_worldPosition);
         m_localPosition = pos;
+        m_ignoresParentPosition = false;
     }
     
     void Transform::UpdateRelativeRotation()
@@ -420,6 +716,7 @@ namespace gfxc
         m_worldPosition = m_parentNode->m_worldRotation * m_localPosition;
         m_worldRotation = m_parentNode->m_worldRotation * m_relativeRotation;
         m_invWorldRotation = glm::inverse(m_worldRotation);
+        m_ignoresParentPosition = true;
 
         UpdateChildrenRotation();
         UpdateWorldModel();
@@ -456,5 +753,333 @@ namespace gfxc
         m_worldModel[3][2] = m_worldPosition.z;
 
         m_isInMotion = true;
+        ++m_modelVersion;
+        RecordChange();
+    }
+
+
+    void Transform::ResolveWorldInfo() const
+    {
+        if (m_isWorldOutdated)
+        {
+            const_cast<Transform *>(this)->ResolveOutdatedChain();
+        }
+    }
+
+
+    void Transform::EnterLazyUpdate()
+    {
+        // In eager mode, the relative rotation of a root and the world rotation
+        // of a node that was never rotated are zero quaternions, which only act
+        // as the identity once converted to a matrix. The world placement is
+        // the reference, the local data is derived from it.
+        if (m_worldRotation == glm::quat(0.0F, 0.0F, 0.0F, 0.0F))
+        {
+            m_worldRotation = glm::quat(1.0F, 0.0F, 0.0F, 0.0F);
+        }
+        m_invWorldRotation = glm::inverse(m_worldRotation);
+
+        if (m_parentNode == nullptr)
+        {
+            m_localPosition = m_worldPosition;
+            m_relativeRotation = m_worldRotation;
+        }
+        else
+        {
+            const glm::vec3 offset = m_ignoresParentPosition
+                                     ? m_worldPosition
+                                     : m_worldPosition - m_parentNode->m_worldPosition;
+            m_localPosition = m_parentNode->m_invWorldRotation * offset;
+            m_relativeRotation = m_parentNode->m_invWorldRotation * m_worldRotation;
+        }
+
+        // Newer than the changes recorded in the ancestors, which may be left
+        // from an earlier lazy period
+        m_propagationStamp = NextLazyStamp();
+        m_positionStamp = 0U;
+        m_rotationStamp = 0U;
+
+        m_isWorldOutdated = false;
+        UpdateWorldModel();
+    }
+
+
+    void Transform::ResolvePropagation()
+    {
+        // The latest of the changes of position of this node, which reach it
+        // and its subtree, of the rotations of its parent, which only reach
+        // the subtree, and of the changes that reached the parent
+        if (m_positionStamp > m_propagationStamp)
+        {
+            m_propagationStamp = m_positionStamp;
+            m_ignoresParentPosition = false;
+        }
+
+        const Transform *parent = m_parentNode;
+        if (parent == nullptr)
+        {
+            return;
+        }
+
+        if (parent->m_propagationStamp > m_propagationStamp)
+        {
+            m_propagationStamp = parent->m_propagationStamp;
+            m_ignoresParentPosition = parent->m_ignoresParentPosition;
+        }
+        if (parent->m_rotationStamp > m_propagationStamp)
+        {
+            m_propagationStamp = parent->m_rotationStamp;
+            m_ignoresParentPosition = true;
+        }
+    }
+
+
+    void Transform::ResolveOutdatedChain()
+    {
+        // An outdated node always has an outdated subtree, so the outdated
+        // ancestors form a single chain ending at this node. Walk it up, then
+        // resolve it top down. Iterative, so that deep chains cannot overflow.
+        Transform *chain[32];
+        std::vector<Transform *> longChain;
+        unsigned int length = 0U;
+
+        for (Transform *node = this; node != nullptr and node->m_isWorldOutdated; node = node->m_parentNode)
+        {
+            if (length == 32U)
+            {
+                longChain.assign(chain, chain + length);
+            }
+            if (length < 32U)
+            {
+                chain[length] = node;
+            }
+            else
+            {
+                longChain.push_back(node);
+            }
+            ++length;
+        }
+
+        Transform **nodes = longChain.empty() ? chain : longChain.data();
+
+        for (unsigned int i = length; i > 0U; --i)
+        {
+            Transform *node = nodes[i - 1U];
+            const Transform *parent = node->m_parentNode;
+
+            node->ResolvePropagation();
+
+            if (parent == nullptr)
+            {
+                node->m_worldPosition = node->m_localPosition;
+                node->m_worldRotation = node->m_relativeRotation;
+            }
+            else
+            {
+                // Same as UpdateWorldInfo or UpdateWorldPosition, depending
+                // on the change eager mode would have propagated last
+                node->m_worldPosition = parent->m_worldRotation * node->m_localPosition;
+                if (!node->m_ignoresParentPosition)
+                {
+                    node->m_worldPosition += parent->m_worldPosition;
+                }
+                node->m_worldRotation = parent->m_worldRotation * node->m_relativeRotation;
+            }
+            node->m_invWorldRotation = glm::inverse(node->m_worldRotation);
+
+            node->m_isWorldOutdated = false;
+            node->MarkModelOutdated();
+        }
+    }
+
+
+    void Transform::MarkHierarchyOutdated()
+    {
+        // Nodes that are already outdated have an outdated subtree as well
+        if (m_isWorldOutdated)
+        {
+            return;
+        }
+
+        std::vector<Transform *> stack(1, this);
+        while (!stack.empty())
+        {
+            Transform *node = stack.back();
+            stack.pop_back();
+
+            node->m_isWorldOutdated = true;
+            node->RecordChange();
+            for (Transform *child : node->m_childNodes)
+            {
+                if (!child->m_isWorldOutdated)
+                {
+                    stack.push_back(child);
+                }
+            }
+        }
+    }
+
+
+    void Transform::ApplyWorldPosition(const glm::vec3 &position)
+    {
+        // Same as SetWorldPosition, without the children and with no virtual
+        // calls. Lazy nodes never update their children in the setter anyway.
+        if (m_lazyUpdate)
+        {
+            Transform::SetWorldPosition(position);
+            return;
+        }
+
+        m_worldPosition = position;
+
+        Transform::UpdateLocalPosition();
+        Transform::UpdateModelPosition();
+    }
+
+
+    void Transform::ApplyWorldRotation(const glm::quat &rotationQ)
+    {
+        if (m_lazyUpdate)
+        {
+            Transform::SetWorldRotation(rotationQ);
+            return;
+        }
+
+        m_worldRotation = rotationQ;
+        m_invWorldRotation = glm::inverse(rotationQ);
+
+        Transform::UpdateRelativeRotation();
+        MarkModelOutdated();
+    }
+
+
+    void Transform::EnterBatch(std::vector<Transform *> &parents)
+    {
+        // Only eager nodes that update their children have to propagate at the
+        // end of the batch, and only they can be the ancestor of another node
+        if (!m_lazyUpdate and m_updateHierarchy and !m_childNodes.empty() and !m_isInBatch)
+        {
+            m_isInBatch = true;
+            parents.push_back(this);
+        }
+    }
+
+
+    Transform *Transform::FindBatchAncestor() const
+    {
+        // The topmost ancestor changed by the batch whose changes would have
+        // reached this node, had they been propagated right away
+        Transform *ancestor = nullptr;
+        for (Transform *node = m_parentNode; node != nullptr and node->m_updateHierarchy; node = node->m_parentNode)
+        {
+            if (node->m_isInBatch)
+            {
+                ancestor = node;
+            }
+        }
+        return ancestor;
+    }
+
+
+    void Transform::ResolveBatchAncestors(bool rotations)
+    {
+        // Bring the nodes between this one and the ancestors changed earlier in
+        // the batch to the state the immediate propagation would have left
+        // them in, so that this node is changed from the same state
+        const Transform *ancestor = FindBatchAncestor();
+        if (ancestor == nullptr)
+        {
+            return;
+        }
+
+        SmallVector<Transform *, 16U> chain;
+        for (Transform *node = this; node != ancestor; node = node->m_parentNode)
+        {
+            chain.push_back(node);
+        }
+
+        for (unsigned int i = chain.size(); i > 0U; --i)
+        {
+            Transform *node = chain[i - 1U];
+            const Transform *parent = node->m_parentNode;
+
+            if (rotations)
+            {
+                // Same as UpdateWorldInfo, without the children
+                node->m_worldPosition = parent->m_worldRotation * node->m_localPosition;
+                node->m_worldRotation = parent->m_worldRotation * node->m_relativeRotation;
+                node->m_invWorldRotation = glm::inverse(node->m_worldRotation);
+                node->m_ignoresParentPosition = true;
+                node->MarkModelOutdated();
+            }
+            else
+            {
+                // Same as SetLocalPosition, without the children
+                node->Transform::UpdateWorldPosition();
+                node->Transform::UpdateModelPosition();
+            }
+        }
+    }
+
+
+    void Transform::PropagateBatch(Transform *const *parents, unsigned int count, bool rotations)
+    {
+        // A node below another one of the batch is updated together with the
+        // subtree of that node, so only the topmost ones propagate
+        for (unsigned int i = 0; i < count; i++)
+        {
+            Transform *transform = parents[i];
+            if (transform->FindBatchAncestor() != nullptr)
+            {
+                continue;
+            }
+
+            if (rotations)
+            {
+                transform->UpdateChildrenRotation();
+            }
+            else
+            {
+                transform->UpdateChildrenPosition();
+            }
+        }
+
+        for (unsigned int i = 0; i < count; i++)
+        {
+            parents[i]->m_isInBatch = false;
+        }
+    }
+
+
+    void Transform::MarkModelOutdated()
+    {
+        m_isInMotion = true;
+        m_isModelOutdated = true;
+        ++m_modelVersion;
+        RecordChange();
+    }
+
+
+    void Transform::RecordChange()
+    {
+        if (m_journal != nullptr and !m_isJournaled)
+        {
+            m_journal->Record(this);
+        }
+    }
+
+
+    void Transform::UpdateInverseModel()
+    {
+        const glm::mat4 &model = GetModel();
+        if (m_inverseModelVersion == m_modelVersion)
+        {
+            return;
+        }
+
+        // The model is a rotation and a scale followed by a translation
+        m_invWorldModel = glm::affineInverse(model);
+        m_normalMatrix = glm::transpose(glm::mat3(m_invWorldModel));
+        m_inverseModelVersion = m_modelVersion;
     }
 }
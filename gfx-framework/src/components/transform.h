@@ -2,6 +2,7 @@
 #define GFXC_TRANSFORM_H
 
 #include "components/exports.h"
+#include "components/small_vector.h"
 
 #include "glm/glm.hpp"
 #include "glm/gtc/type_ptr.hpp"
@@ -9,12 +10,24 @@
 #include "glm/gtc/quaternion.hpp"
 #include "glm/gtx/quaternion.hpp"
 
-#include <list>
+#include <cstdint>
+#include <vector>
+
+
+// Builds that never derive from gfxc::Transform can mark it final, so that
+// the compiler is free to devirtualize every call made through it
+#if defined(GFXC_TRANSFORM_FINAL)
+#   define GFXC_TRANSFORM_FINAL_SPECIFIER final
+#else
+#   define GFXC_TRANSFORM_FINAL_SPECIFIER
+#endif
 
 
 namespace gfxc
 {
-    class GFXC_API Transform
+    class TransformJournal;
+
+    class GFXC_API Transform GFXC_TRANSFORM_FINAL_SPECIFIER
     {
      public:
 
@@ -29,6 +42,33 @@ namespace gfxc
         void ClearMotionState();
         bool GetMotionState() const;
 
+        // ****************************
+        // Lazy hierarchy update
+
+        // In lazy mode, setters only mark the node and its subtree as outdated.
+        // World data is resolved on demand by the getters, or for a whole
+        // subtree by FlushHierarchy(). The mode applies to the whole subtree
+        // and is inherited by the nodes added with AddChild. Both modes give
+        // the same world data for the same operations, up to rounding,
+        // including the descendants of a rotated node, whose world position
+        // leaves out the position of their parent (see UpdateWorldInfo).
+        void SetLazyUpdate(bool value);
+        bool GetLazyUpdate() const;
+        void FlushHierarchy();
+
+        // ****************************
+        // Batched mutation
+
+        // Apply the same operation to `count` transforms in a single call.
+        // Every element is updated without virtual dispatch, so overrides in
+        // derived classes are not called, and the changes are propagated to
+        // the children once, at the end of the batch. The result is the same
+        // as calling the single element method on each transform in order, up
+        // to rounding for the transforms whose ancestors are in the batch too.
+        static void SetWorldPositions(Transform *const *transforms, const glm::vec3 *positions, unsigned int count);
+        static void SetWorldRotations(Transform *const *transforms, const glm::quat *rotations, unsigned int count);
+        static void MoveAll(Transform *const *transforms, unsigned int count, const glm::vec3 &dir, float deltaTime);
+
         // ****************************
         // Get transform properties
 
@@ -46,6 +86,25 @@ namespace gfxc
         virtual glm::vec3 GetScale() const;
         virtual const glm::mat4& GetModel();
 
+        // Cached like the model matrix, and only recomputed after it changes.
+        // The normal matrix is the transposed inverse of the upper 3x3 part.
+        const glm::mat4& GetInverseModel();
+        const glm::mat3& GetNormalMatrix();
+
+        // Increases every time the model matrix changes, so that renderers
+        // can skip uploading the matrices of transforms that did not move
+        std::uint64_t GetModelVersion() const;
+
+        // ****************************
+        // Change journal
+
+        // Changes of the model matrix are recorded in the journal, under the
+        // given object id. The id is the index of the matrix in GPU buffers
+        // such as ModelMatrixBuffer. A null journal detaches the transform.
+        void SetJournal(TransformJournal *journal, unsigned int objectId);
+        TransformJournal* GetJournal() const;
+        unsigned int GetObjectId() const;
+
         virtual float GetMoveSpeed() const;
         virtual float GetScaleSpeed() const;
         virtual float GetRotationSpeed() const;
@@ -119,9 +178,28 @@ namespace gfxc
      private:
         virtual void UpdateModelPosition();
 
+        void MarkModelOutdated();
+        void RecordChange();
+        void UpdateInverseModel();
+
+        void EnterLazyUpdate();
+        void ResolvePropagation();
+        void ResolveWorldInfo() const;
+        void ResolveOutdatedChain();
+        void MarkHierarchyOutdated();
+
+        void ApplyWorldPosition(const glm::vec3 &position);
+        void ApplyWorldRotation(const glm::quat &rotationQ);
+        void EnterBatch(std::vector<Transform *> &parents);
+        Transform *FindBatchAncestor() const;
+        void ResolveBatchAncestors(bool rotations);
+        static void PropagateBatch(Transform *const *parents, unsigned int count, bool rotations);
+
      //protected:
      public:
         glm::mat4               m_worldModel;
+        glm::mat4               m_invWorldModel;
+        glm::mat3               m_normalMatrix;
 
         // Rotations
         glm::quat               m_worldRotation;
@@ -143,9 +221,35 @@ namespace gfxc
         bool                    m_isInMotion;
         bool                    m_isModelOutdated;
         bool                    m_updateHierarchy;
-
+        bool                    m_lazyUpdate;
+        bool                    m_isWorldOutdated;
+        bool                    m_isInBatch;
+
+        // The world position is the world rotation of the parent applied to
+        // the local position, without the position of the parent. Eager mode
+        // leaves the descendants of a rotated node this way, until a change
+        // of position reaches them. In lazy mode, the latest change that
+        // reached the node decides it: the stamps order the position and
+        // rotation changes made on the nodes, and the last one that was
+        // resolved for this node.
+        bool                    m_ignoresParentPosition;
+        std::uint64_t           m_propagationStamp;
+        std::uint64_t           m_positionStamp;
+        std::uint64_t           m_rotationStamp;
+
+        // Version of the model matrix, and the one the inverse was built for
+        std::uint64_t           m_modelVersion;
+        std::uint64_t           m_inverseModelVersion;
+
+        TransformJournal *      m_journal;
+        unsigned int            m_objectId;
+        bool                    m_isJournaled;
+
+        // Children are stored contiguously and each child knows its slot in
+        // the array of its parent, so that RemoveChild is a swap-remove
         Transform *             m_parentNode;
-        std::list<Transform *>  m_childNodes;
+        SmallVector<Transform *, 4U> m_childNodes;
+        unsigned int            m_childSlot;
     };
 }
 
@@ -0,0 +1,342 @@
+#include "components/transform_batch.h"
+
+#include "glm/gtx/quaternion.hpp"
+
+#include <cassert>
+
+
+namespace gfxc
+{
+    // The kernels read and write the GLM types as packed float arrays
+    static_assert(sizeof(glm::vec3) == 3 * sizeof(float), "glm::vec3 must be packed");
+    static_assert(sizeof(glm::quat) == 4 * sizeof(float), "glm::quat must be packed");
+    static_assert(sizeof(glm::mat4) == 16 * sizeof(float), "glm::mat4 must be packed");
+
+
+    // ****************************
+    // Scalar path
+
+    static void ComposeModelsScalar(const glm::vec3 *positions, const glm::quat *rotations,
+                                    const glm::vec3 *scales, glm::mat4 *models, unsigned int count)
+    {
+        for (unsigned int i = 0U; i < count; ++i)
+        {
+            glm::mat4 &model = models[i];
+            model = glm::scale(glm::toMat4(rotations[i]), scales[i]);
+            model[3][0] = positions[i].x;
+            model[3][1] = positions[i].y;
+            model[3][2] = positions[i].z;
+        }
+    }
+
+
+#if defined(GFXF_SIMD_X64)
+    // ****************************
+    // SSE2 path, 4 matrices per iteration
+
+    // Splits 4 packed vec3 values, loaded as 3 registers, into x, y and z
+    static inline void DeinterleaveVec3(__m128 a, __m128 b, __m128 c, __m128 &x, __m128 &y, __m128 &z)
+    {
+        // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+        x = _mm_shuffle_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 0, 0)),
+                           _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+        y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                           _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+                           _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+    }
+
+    static void ComposeModelsSSE2(const glm::vec3 *positions, const glm::quat *rotations,
+                                  const glm::vec3 *scales, glm::mat4 *models, unsigned int count)
+    {
+        const __m128 one = _mm_set1_ps(1.0F);
+        const __m128 two = _mm_set1_ps(2.0F);
+        const __m128 zero = _mm_setzero_ps();
+
+        unsigned int i = 0U;
+        for (; i + 4U <= count; i += 4U)
+        {
+            const float *p = &positions[i].x;
+            const float *r = &rotations[i].x;
+            const float *s = &scales[i].x;
+            float *m = &models[i][0][0];
+
+            __m128 qx = _mm_loadu_ps(r + 0);
+            __m128 qy = _mm_loadu_ps(r + 4);
+            __m128 qz = _mm_loadu_ps(r + 8);
+            __m128 qw = _mm_loadu_ps(r + 12);
+            _MM_TRANSPOSE4_PS(qx, qy, qz, qw);
+
+            __m128 px, py, pz, sx, sy, sz;
+            DeinterleaveVec3(_mm_loadu_ps(p + 0), _mm_loadu_ps(p + 4), _mm_loadu_ps(p + 8), px, py, pz);
+            DeinterleaveVec3(_mm_loadu_ps(s + 0), _mm_loadu_ps(s + 4), _mm_loadu_ps(s + 8), sx, sy, sz);
+
+            // Same terms as glm::mat3_cast
+            const __m128 qxx = _mm_mul_ps(qx, qx);
+            const __m128 qyy = _mm_mul_ps(qy, qy);
+            const __m128 qzz = _mm_mul_ps(qz, qz);
+            const __m128 qxz = _mm_mul_ps(qx, qz);
+            const __m128 qxy = _mm_mul_ps(qx, qy);
+            const __m128 qyz = _mm_mul_ps(qy, qz);
+            const __m128 qwx = _mm_mul_ps(qw, qx);
+            const __m128 qwy = _mm_mul_ps(qw, qy);
+            const __m128 qwz = _mm_mul_ps(qw, qz);
+
+            __m128 c0x = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(qyy, qzz))), sx);
+            __m128 c0y = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(qxy, qwz)), sx);
+            __m128 c0z = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(qxz, qwy)), sx);
+            __m128 c0w = _mm_mul_ps(zero, sx);
+
+            __m128 c1x = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(qxy, qwz)), sy);
+            __m128 c1y = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(qxx, qzz))), sy);
+            __m128 c1z = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(qyz, qwx)), sy);
+            __m128 c1w = _mm_mul_ps(zero, sy);
+
+            __m128 c2x = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(qxz, qwy)), sz);
+            __m128 c2y = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(qyz, qwx)), sz);
+            __m128 c2z = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(qxx, qyy))), sz);
+            __m128 c2w = _mm_mul_ps(zero, sz);
+
+            __m128 c3w = one;
+
+            // Back from one register per element to one register per column
+            _MM_TRANSPOSE4_PS(c0x, c0y, c0z, c0w);
+            _MM_TRANSPOSE4_PS(c1x, c1y, c1z, c1w);
+            _MM_TRANSPOSE4_PS(c2x, c2y, c2z, c2w);
+            _MM_TRANSPOSE4_PS(px, py, pz, c3w);
+
+            _mm_storeu_ps(m + 0,  c0x); _mm_storeu_ps(m + 4,  c1x); _mm_storeu_ps(m + 8,  c2x); _mm_storeu_ps(m + 12, px);
+            _mm_storeu_ps(m + 16, c0y); _mm_storeu_ps(m + 20, c1y); _mm_storeu_ps(m + 24, c2y); _mm_storeu_ps(m + 28, py);
+            _mm_storeu_ps(m + 32, c0z); _mm_storeu_ps(m + 36, c1z); _mm_storeu_ps(m + 40, c2z); _mm_storeu_ps(m + 44, pz);
+            _mm_storeu_ps(m + 48, c0w); _mm_storeu_ps(m + 52, c1w); _mm_storeu_ps(m + 56, c2w); _mm_storeu_ps(m + 60, c3w);
+        }
+
+        ComposeModelsScalar(positions + i, rotations + i, scales + i, models + i, count - i);
+    }
+
+
+    // ****************************
+    // AVX2 path, 8 matrices per iteration. Matrix k goes into the lower
+    // 128-bit lane and matrix k + 4 into the upper one, so the shuffles
+    // are the same as in the SSE2 path.
+
+    GFXF_TARGET_AVX2
+    static inline __m256 LoadLanes(const float *low, const float *high)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+    }
+
+    GFXF_TARGET_AVX2
+    static inline void StoreLanes(float *low, float *high, __m256 value)
+    {
+        _mm_storeu_ps(low, _mm256_castps256_ps128(value));
+        _mm_storeu_ps(high, _mm256_extractf128_ps(value, 1));
+    }
+
+    GFXF_TARGET_AVX2
+    static inline void Transpose4x4Lanes(__m256 &r0, __m256 &r1, __m256 &r2, __m256 &r3)
+    {
+        const __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+        const __m256 t1 = _mm256_unpacklo_ps(r2, r3);
+        const __m256 t2 = _mm256_unpackhi_ps(r0, r1);
+        const __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+        r0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+        r1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+        r2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        r3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    }
+
+    GFXF_TARGET_AVX2
+    static inline void DeinterleaveVec3Lanes(__m256 a, __m256 b, __m256 c, __m256 &x, __m256 &y, __m256 &z)
+    {
+        x = _mm256_shuffle_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 0, 0)),
+                              _mm256_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+        y = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)),
+                              _mm256_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        z = _mm256_shuffle_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)),
+                              _mm256_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+    }
+
+    GFXF_TARGET_AVX2
+    static void ComposeModelsAVX2(const glm::vec3 *positions, const glm::quat *rotations,
+                                  const glm::vec3 *scales, glm::mat4 *models, unsigned int count)
+    {
+        const __m256 one = _mm256_set1_ps(1.0F);
+        const __m256 two = _mm256_set1_ps(2.0F);
+        const __m256 zero = _mm256_setzero_ps();
+
+        unsigned int i = 0U;
+        for (; i + 8U <= count; i += 8U)
+        {
+            const float *p = &positions[i].x;
+            const float *r = &rotations[i].x;
+            const float *s = &scales[i].x;
+            float *m = &models[i][0][0];
+
+            __m256 qx = LoadLanes(r + 0,  r + 16);
+            __m256 qy = LoadLanes(r + 4,  r + 20);
+            __m256 qz = LoadLanes(r + 8,  r + 24);
+            __m256 qw = LoadLanes(r + 12, r + 28);
+            Transpose4x4Lanes(qx, qy, qz, qw);
+
+            __m256 px, py, pz, sx, sy, sz;
+            DeinterleaveVec3Lanes(LoadLanes(p + 0, p + 12), LoadLanes(p + 4, p + 16), LoadLanes(p + 8, p + 20), px, py, pz);
+            DeinterleaveVec3Lanes(LoadLanes(s + 0, s + 12), LoadLanes(s + 4, s + 16), LoadLanes(s + 8, s + 20), sx, sy, sz);
+
+            const __m256 qxx = _mm256_mul_ps(qx, qx);
+            const __m256 qyy = _mm256_mul_ps(qy, qy);
+            const __m256 qzz = _mm256_mul_ps(qz, qz);
+            const __m256 qxz = _mm256_mul_ps(qx, qz);
+            const __m256 qxy = _mm256_mul_ps(qx, qy);
+            const __m256 qyz = _mm256_mul_ps(qy, qz);
+            const __m256 qwx = _mm256_mul_ps(qw, qx);
+            const __m256 qwy = _mm256_mul_ps(qw, qy);
+            const __m256 qwz = _mm256_mul_ps(qw, qz);
+
+            __m256 c0x = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(qyy, qzz))), sx);
+            __m256 c0y = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(qxy, qwz)), sx);
+            __m256 c0z = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(qxz, qwy)), sx);
+            __m256 c0w = _mm256_mul_ps(zero, sx);
+
+            __m256 c1x = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(qxy, qwz)), sy);
+            __m256 c1y = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(qxx, qzz))), sy);
+            __m256 c1z = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(qyz, qwx)), sy);
+            __m256 c1w = _mm256_mul_ps(zero, sy);
+
+            __m256 c2x = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(qxz, qwy)), sz);
+            __m256 c2y = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(qyz, qwx)), sz);
+            __m256 c2z = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(qxx, qyy))), sz);
+            __m256 c2w = _mm256_mul_ps(zero, sz);
+
+            __m256 c3w = one;
+
+            Transpose4x4Lanes(c0x, c0y, c0z, c0w);
+            Transpose4x4Lanes(c1x, c1y, c1z, c1w);
+            Transpose4x4Lanes(c2x, c2y, c2z, c2w);
+            Transpose4x4Lanes(px, py, pz, c3w);
+
+            StoreLanes(m + 0,  m + 64,  c0x); StoreLanes(m + 4,  m + 68,  c1x); StoreLanes(m + 8,  m + 72,  c2x); StoreLanes(m + 12, m + 76,  px);
+            StoreLanes(m + 16, m + 80,  c0y); StoreLanes(m + 20, m + 84,  c1y); StoreLanes(m + 24, m + 88,  c2y); StoreLanes(m + 28, m + 92,  py);
+            StoreLanes(m + 32, m + 96,  c0z); StoreLanes(m + 36, m + 100, c1z); StoreLanes(m + 40, m + 104, c2z); StoreLanes(m + 44, m + 108, pz);
+            StoreLanes(m + 48, m + 112, c0w); StoreLanes(m + 52, m + 116, c1w); StoreLanes(m + 56, m + 120, c2w); StoreLanes(m + 60, m + 124, c3w);
+        }
+
+        ComposeModelsSSE2(positions + i, rotations + i, scales + i, models + i, count - i);
+    }
+#endif
+
+
+#if defined(GFXF_SIMD_NEON)
+    // ****************************
+    // NEON path, 4 matrices per iteration
+
+    static inline void Transpose4x4(float32x4_t &r0, float32x4_t &r1, float32x4_t &r2, float32x4_t &r3)
+    {
+        const float32x4x2_t t01 = vtrnq_f32(r0, r1);
+        const float32x4x2_t t23 = vtrnq_f32(r2, r3);
+        r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+        r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+        r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+        r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+    }
+
+    static void ComposeModelsNEON(const glm::vec3 *positions, const glm::quat *rotations,
+                                  const glm::vec3 *scales, glm::mat4 *models, unsigned int count)
+    {
+        const float32x4_t one = vdupq_n_f32(1.0F);
+        const float32x4_t two = vdupq_n_f32(2.0F);
+        const float32x4_t zero = vdupq_n_f32(0.0F);
+
+        unsigned int i = 0U;
+        for (; i + 4U <= count; i += 4U)
+        {
+            // The structure loads split the packed values into components
+            const float32x4x4_t q = vld4q_f32(&rotations[i].x);
+            const float32x4x3_t p = vld3q_f32(&positions[i].x);
+            const float32x4x3_t s = vld3q_f32(&scales[i].x);
+            float *m = &models[i][0][0];
+
+            const float32x4_t qxx = vmulq_f32(q.val[0], q.val[0]);
+            const float32x4_t qyy = vmulq_f32(q.val[1], q.val[1]);
+            const float32x4_t qzz = vmulq_f32(q.val[2], q.val[2]);
+            const float32x4_t qxz = vmulq_f32(q.val[0], q.val[2]);
+            const float32x4_t qxy = vmulq_f32(q.val[0], q.val[1]);
+            const float32x4_t qyz = vmulq_f32(q.val[1], q.val[2]);
+            const float32x4_t qwx = vmulq_f32(q.val[3], q.val[0]);
+            const float32x4_t qwy = vmulq_f32(q.val[3], q.val[1]);
+            const float32x4_t qwz = vmulq_f32(q.val[3], q.val[2]);
+
+            float32x4_t c0x = vmulq_f32(vsubq_f32(one, vmulq_f32(two, vaddq_f32(qyy, qzz))), s.val[0]);
+            float32x4_t c0y = vmulq_f32(vmulq_f32(two, vaddq_f32(qxy, qwz)), s.val[0]);
+            float32x4_t c0z = vmulq_f32(vmulq_f32(two, vsubq_f32(qxz, qwy)), s.val[0]);
+            float32x4_t c0w = vmulq_f32(zero, s.val[0]);
+
+            float32x4_t c1x = vmulq_f32(vmulq_f32(two, vsubq_f32(qxy, qwz)), s.val[1]);
+            float32x4_t c1y = vmulq_f32(vsubq_f32(one, vmulq_f32(two, vaddq_f32(qxx, qzz))), s.val[1]);
+            float32x4_t c1z = vmulq_f32(vmulq_f32(two, vaddq_f32(qyz, qwx)), s.val[1]);
+            float32x4_t c1w = vmulq_f32(zero, s.val[1]);
+
+            float32x4_t c2x = vmulq_f32(vmulq_f32(two, vaddq_f32(qxz, qwy)), s.val[2]);
+            float32x4_t c2y = vmulq_f32(vmulq_f32(two, vsubq_f32(qyz, qwx)), s.val[2]);
+            float32x4_t c2z = vmulq_f32(vsubq_f32(one, vmulq_f32(two, vaddq_f32(qxx, qyy))), s.val[2]);
+            float32x4_t c2w = vmulq_f32(zero, s.val[2]);
+
+            float32x4_t px = p.val[0];
+            float32x4_t py = p.val[1];
+            float32x4_t pz = p.val[2];
+            float32x4_t c3w = one;
+
+            Transpose4x4(c0x, c0y, c0z, c0w);
+            Transpose4x4(c1x, c1y, c1z, c1w);
+            Transpose4x4(c2x, c2y, c2z, c2w);
+            Transpose4x4(px, py, pz, c3w);
+
+            vst1q_f32(m + 0,  c0x); vst1q_f32(m + 4,  c1x); vst1q_f32(m + 8,  c2x); vst1q_f32(m + 12, px);
+            vst1q_f32(m + 16, c0y); vst1q_f32(m + 20, c1y); vst1q_f32(m + 24, c2y); vst1q_f32(m + 28, py);
+            vst1q_f32(m + 32, c0z); vst1q_f32(m + 36, c1z); vst1q_f32(m + 40, c2z); vst1q_f32(m + 44, pz);
+            vst1q_f32(m + 48, c0w); vst1q_f32(m + 52, c1w); vst1q_f32(m + 56, c2w); vst1q_f32(m + 60, c3w);
+        }
+
+        ComposeModelsScalar(positions + i, rotations + i, scales + i, models + i, count - i);
+    }
+#endif
+
+
+    // ****************************
+    // Dispatch
+
+    void ComposeModels(const glm::vec3 *positions, const glm::quat *rotations,
+                       const glm::vec3 *scales, glm::mat4 *models, unsigned int count)
+    {
+        static const SimdPath path = GetBestSimdPath();
+        ComposeModels(path, positions, rotations, scales, models, count);
+    }
+
+    void ComposeModels(SimdPath path, const glm::vec3 *positions, const glm::quat *rotations,
+                       const glm::vec3 *scales, glm::mat4 *models, unsigned int count)
+    {
+        assert(IsSimdPathSupported(path));
+
+        switch (path) {
+#if defined(GFXF_SIMD_X64)
+        case SimdPath::SSE2:
+            ComposeModelsSSE2(positions, rotations, scales, models, count);
+            return;
+
+        case SimdPath::AVX2:
+            ComposeModelsAVX2(positions, rotations, scales, models, count);
+            return;
+#endif
+
+#if defined(GFXF_SIMD_NEON)
+        case SimdPath::NEON:
+            ComposeModelsNEON(positions, rotations, scales, models, count);
+            return;
+#endif
+
+        default:
+            ComposeModelsScalar(positions, rotations, scales, models, count);
+            return;
+        }
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef GFXC_TRANSFORM_BATCH_H
+#define GFXC_TRANSFORM_BATCH_H
+
+#include "components/exports.h"
+
+#include "utils/simd_utils.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+
+namespace gfxc
+{
+    // Builds `count` model matrices from arrays of world positions, rotations
+    // and scales, with the same math as Transform::ComputeWorldModel:
+    //
+    //      model = translate(position) * toMat4(rotation) * scale(scale)
+    //
+    // The arrays are read and written in order, so the same index refers to
+    // the same node in every array. The SIMD paths do the operations in the
+    // same order as GLM, so they give the same values as the scalar path, up
+    // to rounding if the compiler contracts them into fused multiply-add.
+    GFXC_API void ComposeModels(const glm::vec3 *positions, const glm::quat *rotations,
+                                const glm::vec3 *scales, glm::mat4 *models, unsigned int count);
+
+    // Same as above, but with an explicit instruction set. The path must be
+    // supported by the current CPU, see IsSimdPathSupported().
+    GFXC_API void ComposeModels(SimdPath path, const glm::vec3 *positions, const glm::quat *rotations,
+                                const glm::vec3 *scales, glm::mat4 *models, unsigned int count);
+}
+
+#endif
@@ -22,8 +22,12 @@ namespace gfxc
                 and (m_isInMotion == other.m_isInMotion)
                 and (m_isModelOutdated == other.m_isModelOutdated)
                 and (m_updateHierarchy == other.m_updateHierarchy)
+                and (m_lazyUpdate == other.m_lazyUpdate)
+                and (m_isWorldOutdated == other.m_isWorldOutdated)
+                and (m_ignoresParentPosition == other.m_ignoresParentPosition)
                 and (m_parentNode == other.m_parentNode)
-                and (m_childNodes == other.m_childNodes);
+                and (m_childNodes == other.m_childNodes)
+                and (m_childSlot == other.m_childSlot);
     }
 
     bool TransformInternals::operator!=(const TransformInternals &other)
@@ -55,8 +59,12 @@ namespace gfxc
         m_isInMotion = transform.m_isInMotion;
         m_isModelOutdated = transform.m_isModelOutdated;
         m_updateHierarchy = transform.m_updateHierarchy;
+        m_lazyUpdate = transform.m_lazyUpdate;
+        m_isWorldOutdated = transform.m_isWorldOutdated;
+        m_ignoresParentPosition = transform.m_ignoresParentPosition;
 
         m_parentNode = transform.m_parentNode;
         m_childNodes = transform.m_childNodes;
+        m_childSlot = transform.m_childSlot;
     }
 }
@@ -29,9 +29,13 @@ namespace gfxc
         bool                    m_isInMotion;
         bool                    m_isModelOutdated;
         bool                    m_updateHierarchy;
+        bool                    m_lazyUpdate;
+        bool                    m_isWorldOutdated;
+        bool                    m_ignoresParentPosition;
 
         Transform *             m_parentNode;
-        std::list<Transform *>  m_childNodes;
+        SmallVector<Transform *, 4U> m_childNodes;
+        unsigned int            m_childSlot;
 
         TransformInternals(const Transform &transform);
         ~TransformInternals() = default;
@@ -0,0 +1,78 @@
+#include "components/transform_journal.h"
+#include "components/transform.h"
+
+#include <algorithm>
+
+
+namespace gfxc
+{
+    TransformJournal::TransformJournal()
+    {
+    }
+
+    TransformJournal::~TransformJournal()
+    {
+        Clear();
+    }
+
+    const std::vector<Transform *>& TransformJournal::GetChanges() const
+    {
+        return m_changes;
+    }
+
+    bool TransformJournal::IsEmpty() const
+    {
+        return m_changes.empty();
+    }
+
+    void TransformJournal::GetChangedRanges(std::vector<IdRange> &ranges, unsigned int maxGap) const
+    {
+        ranges.clear();
+
+        m_ids.resize(m_changes.size());
+        for (unsigned int i = 0; i < m_changes.size(); ++i)
+        {
+            m_ids[i] = m_changes[i]->GetObjectId();
+        }
+        std::sort(m_ids.begin(), m_ids.end());
+
+        for (unsigned int id : m_ids)
+        {
+            if (!ranges.empty() and id <= ranges.back().end + maxGap)
+            {
+                ranges.back().end = std::max(ranges.back().end, id + 1U);
+            }
+            else
+            {
+                ranges.push_back({ id, id + 1U });
+            }
+        }
+    }
+
+    void TransformJournal::Clear()
+    {
+        for (Transform *transform : m_changes)
+        {
+            transform->m_isJournaled = false;
+        }
+        m_changes.clear();
+    }
+
+    void TransformJournal::Record(Transform *transform)
+    {
+        transform->m_isJournaled = true;
+        m_changes.push_back(transform);
+    }
+
+    void TransformJournal::Forget(Transform *transform)
+    {
+        // Only called when a recorded transform is destroyed or detached
+        std::vector<Transform *>::iterator it = std::find(m_changes.begin(), m_changes.end(), transform);
+        if (it != m_changes.end())
+        {
+            *it = m_changes.back();
+            m_changes.pop_back();
+        }
+        transform->m_isJournaled = false;
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef GFXC_TRANSFORM_JOURNAL_H
+#define GFXC_TRANSFORM_JOURNAL_H
+
+#include "components/exports.h"
+
+#include <vector>
+
+
+namespace gfxc
+{
+    class Transform;
+
+    // A contiguous range of object ids, [begin, end)
+    struct IdRange
+    {
+        unsigned int begin;
+        unsigned int end;
+    };
+
+    // Records the transforms whose model matrix changed since the last call
+    // to Clear(). A transform is attached with Transform::SetJournal and is
+    // recorded at most once per frame, the first time its model changes. In
+    // lazy mode, the nodes are recorded when they are marked as outdated.
+    // The journal must outlive the transforms attached to it.
+    class GFXC_API TransformJournal
+    {
+     public:
+        TransformJournal();
+        ~TransformJournal();
+
+        TransformJournal(const TransformJournal &) = delete;
+        TransformJournal& operator=(const TransformJournal &) = delete;
+
+        const std::vector<Transform *>& GetChanges() const;
+        bool IsEmpty() const;
+
+        // Sorted object ids of the recorded transforms, merged into ranges.
+        // Two ranges separated by at most `maxGap` ids are merged into one.
+        void GetChangedRanges(std::vector<IdRange> &ranges, unsigned int maxGap) const;
+
+        void Clear();
+
+        // ****************************
+        // Called by the transforms
+
+        void Record(Transform *transform);
+        void Forget(Transform *transform);
+
+     private:
+        std::vector<Transform *>        m_changes;
+        mutable std::vector<unsigned int> m_ids;
+    };
+}
+
+#endif
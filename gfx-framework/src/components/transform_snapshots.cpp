@@ -0,0 +1,108 @@
+#include "components/transform_snapshots.h"
+
+#include "components/transform.h"
+#include "components/transform_batch.h"
+
+#include <utility>
+
+
+namespace gfxc
+{
+    static glm::mat4 ComposeModel(const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale)
+    {
+        glm::mat4 model;
+        ComposeModels(&position, &rotation, &scale, &model, 1U);
+        return model;
+    }
+
+
+    TransformSnapshots::TransformSnapshots()
+    {
+    }
+
+    TransformSnapshots::~TransformSnapshots()
+    {
+    }
+
+    unsigned int TransformSnapshots::Add(Transform *transform)
+    {
+        const unsigned int index = static_cast<unsigned int>(m_transforms.size());
+        m_transforms.push_back(transform);
+
+        for (Snapshot *snapshot : { &m_previous, &m_current, &m_blended })
+        {
+            snapshot->positions.resize(index + 1U);
+            snapshot->rotations.resize(index + 1U);
+            snapshot->scales.resize(index + 1U);
+        }
+
+        Store(m_previous, index);
+        Store(m_current, index);
+        return index;
+    }
+
+    void TransformSnapshots::Clear()
+    {
+        m_transforms.clear();
+        for (Snapshot *snapshot : { &m_previous, &m_current, &m_blended })
+        {
+            snapshot->positions.clear();
+            snapshot->rotations.clear();
+            snapshot->scales.clear();
+        }
+    }
+
+    unsigned int TransformSnapshots::GetSize() const
+    {
+        return static_cast<unsigned int>(m_transforms.size());
+    }
+
+    void TransformSnapshots::Capture()
+    {
+        std::swap(m_previous, m_current);
+
+        const unsigned int count = GetSize();
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Store(m_current, i);
+        }
+    }
+
+    void TransformSnapshots::Interpolate(float alpha, glm::mat4 *models)
+    {
+        const unsigned int count = GetSize();
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            m_blended.positions[i] = glm::mix(m_previous.positions[i], m_current.positions[i], alpha);
+            m_blended.rotations[i] = glm::slerp(m_previous.rotations[i], m_current.rotations[i], alpha);
+            m_blended.scales[i] = glm::mix(m_previous.scales[i], m_current.scales[i], alpha);
+        }
+
+        ComposeModels(m_blended.positions.data(), m_blended.rotations.data(), m_blended.scales.data(), models, count);
+    }
+
+    glm::mat4 TransformSnapshots::Interpolate(unsigned int index, float alpha) const
+    {
+        return ComposeModel(glm::mix(m_previous.positions[index], m_current.positions[index], alpha),
+                            glm::slerp(m_previous.rotations[index], m_current.rotations[index], alpha),
+                            glm::mix(m_previous.scales[index], m_current.scales[index], alpha));
+    }
+
+    void TransformSnapshots::Store(Snapshot &snapshot, unsigned int index) const
+    {
+        const Transform *transform = m_transforms[index];
+
+        // A node that was never rotated holds a zero quaternion, which only
+        // acts as the identity once converted to a matrix. Slerp needs a unit
+        // quaternion.
+        glm::quat rotation = transform->GetWorldRotation();
+        if (rotation == glm::quat(0.0F, 0.0F, 0.0F, 0.0F))
+        {
+            rotation = glm::quat(1.0F, 0.0F, 0.0F, 0.0F);
+        }
+
+        snapshot.positions[index] = transform->GetWorldPosition();
+        snapshot.rotations[index] = rotation;
+        snapshot.scales[index] = transform->GetScale();
+    }
+}
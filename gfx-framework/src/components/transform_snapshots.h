@@ -0,0 +1,79 @@
+#ifndef GFXC_TRANSFORM_SNAPSHOTS_H
+#define GFXC_TRANSFORM_SNAPSHOTS_H
+
+#include "components/exports.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include <vector>
+
+
+namespace gfxc
+{
+    class Transform;
+
+    // Double buffered world state of a set of transforms, for a simulation
+    // that runs at a fixed rate while rendering runs at the display rate.
+    //
+    // Capture() is called at the end of every fixed simulation tick. It turns
+    // the current snapshot into the previous one, then copies the world
+    // position, rotation and scale of every transform into the current one.
+    // The renderer only reads the snapshots, through Interpolate(), with the
+    // alpha of World::GetInterpolationAlpha():
+    //
+    //      void MyScene::FixedUpdate(float fixedDeltaTimeSeconds)
+    //      {
+    //          ... move the transforms ...
+    //          snapshots.Capture();
+    //      }
+    //
+    //      void MyScene::Update(float deltaTimeSeconds)
+    //      {
+    //          snapshots.Interpolate(GetInterpolationAlpha(), models.data());
+    //          ... draw with models[i] ...
+    //      }
+    //
+    // The transforms are only read by Capture(), so a simulation that runs on
+    // another thread only has to synchronize that call with Interpolate().
+    class GFXC_API TransformSnapshots
+    {
+     public:
+        TransformSnapshots();
+        ~TransformSnapshots();
+
+        // Both snapshots of a new transform start at its current state, so it
+        // does not move until the next capture. Returns its index.
+        unsigned int Add(Transform *transform);
+        void Clear();
+        unsigned int GetSize() const;
+
+        void Capture();
+
+        // Models between the previous (alpha = 0) and the current (alpha = 1)
+        // snapshot: positions and scales are interpolated linearly, rotations
+        // with slerp. `models` must hold GetSize() matrices.
+        void Interpolate(float alpha, glm::mat4 *models);
+        glm::mat4 Interpolate(unsigned int index, float alpha) const;
+
+     private:
+        struct Snapshot
+        {
+            std::vector<glm::vec3>      positions;
+            std::vector<glm::quat>      rotations;
+            std::vector<glm::vec3>      scales;
+        };
+
+        void Store(Snapshot &snapshot, unsigned int index) const;
+
+     private:
+        std::vector<Transform *>        m_transforms;
+        Snapshot                        m_previous;
+        Snapshot                        m_current;
+
+        // Interpolated state, reused between frames
+        Snapshot                        m_blended;
+    };
+}
+
+#endif
@@ -0,0 +1,1114 @@
+#include "components/transform_system.h"
+#include "components/transform_batch.h"
+#include "components/worker_pool.h"
+
+#include "glm/gtx/quaternion.hpp"
+#include "glm/gtx/norm.hpp"
+
+#include "utils/glm_utils.h"
+#include "utils/math_utils.h"
+#include "utils/memory_utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+
+namespace gfxc
+{
+    static const unsigned int INVALID_INDEX = 0xFFFFFFFFU;
+
+    // Note that glm::quat() is the zero quaternion, not the identity
+    static const glm::quat IDENTITY_ROTATION = glm::quat(1.0F, 0.0F, 0.0F, 0.0F);
+
+    // Below this average size, the subtrees of a level are updated as units
+    static const unsigned int SUBTREE_GRAIN = 1024U;
+
+    // Minimum number of nodes for a task of the parallel update, and the
+    // alignment of the task boundaries within a level, in nodes
+    static const unsigned int TASK_GRAIN = 1024U;
+    static const unsigned int TASK_ALIGNMENT = 64U;
+    static const unsigned int TASKS_PER_THREAD = 4U;
+
+
+    TransformSystem::TransformSystem()
+        : m_dirtyCount(0U),
+          m_needsSort(false),
+          m_needsLayout(false)
+    {
+    }
+
+    TransformSystem::~TransformSystem()
+    {
+    }
+
+
+    void TransformSystem::Reserve(unsigned int capacity)
+    {
+        m_sparse.reserve(capacity);
+        m_handles.reserve(capacity);
+        m_parents.reserve(capacity);
+        m_localPositions.reserve(capacity);
+        m_relativeRotations.reserve(capacity);
+        m_scales.reserve(capacity);
+        m_worldPositions.reserve(capacity);
+        m_worldRotations.reserve(capacity);
+        m_models.reserve(capacity);
+        m_dirty.reserve(capacity);
+        m_speeds.reserve(capacity);
+        m_firstChildren.reserve(capacity);
+        m_nextSiblings.reserve(capacity);
+        m_previousSiblings.reserve(capacity);
+    }
+
+
+    // ****************************
+    // Node lifetime
+
+    TransformHandle TransformSystem::Create(TransformHandle parent)
+    {
+        TransformHandle handle;
+        if (m_freeHandles.empty())
+        {
+            handle = static_cast<TransformHandle>(m_sparse.size());
+            m_sparse.push_back(INVALID_INDEX);
+        }
+        else
+        {
+            handle = m_freeHandles.back();
+            m_freeHandles.pop_back();
+        }
+
+        // Appending keeps the parent before child order, since the parent
+        // (if any) is already stored somewhere before the end of the pools
+        const unsigned int index = static_cast<unsigned int>(m_handles.size());
+        m_sparse[handle] = index;
+        m_handles.push_back(handle);
+
+        m_parents.push_back(IsValid(parent) ? m_sparse[parent] : INVALID_INDEX);
+        m_localPositions.push_back(glm::vec3(0.0F));
+        m_relativeRotations.push_back(IDENTITY_ROTATION);
+        m_scales.push_back(glm::vec3(1.0F));
+        m_worldPositions.push_back(glm::vec3(0.0F));
+        m_worldRotations.push_back(IDENTITY_ROTATION);
+        m_models.push_back(glm::mat4(1.0F));
+        m_dirty.push_back(0U);
+        m_speeds.push_back(glm::vec3(1.0F, 1.0F, 0.02F));
+        m_firstChildren.push_back(INVALID_INDEX);
+        m_nextSiblings.push_back(INVALID_INDEX);
+        m_previousSiblings.push_back(INVALID_INDEX);
+
+        LinkChild(index);
+        MarkDirty(index);
+        m_needsLayout = true;
+
+        return handle;
+    }
+
+    void TransformSystem::Destroy(TransformHandle handle)
+    {
+        if (!IsValid(handle))
+        {
+            return;
+        }
+
+        const unsigned int index = m_sparse[handle];
+
+        // Orphaned children become roots and keep their world placement
+        unsigned int child = m_firstChildren[index];
+        while (child != INVALID_INDEX)
+        {
+            const unsigned int next = m_nextSiblings[child];
+
+            glm::vec3 position;
+            glm::quat rotation;
+            ResolveWorld(child, position, rotation);
+
+            m_parents[child] = INVALID_INDEX;
+            m_nextSiblings[child] = INVALID_INDEX;
+            m_previousSiblings[child] = INVALID_INDEX;
+            m_localPositions[child] = position;
+            m_relativeRotations[child] = rotation;
+            MarkDirty(child);
+
+            child = next;
+        }
+        m_firstChildren[index] = INVALID_INDEX;
+
+        UnlinkChild(index);
+        RemoveAt(index);
+
+        m_sparse[handle] = INVALID_INDEX;
+        m_freeHandles.push_back(handle);
+    }
+
+    bool TransformSystem::IsValid(TransformHandle handle) const
+    {
+        return (handle < m_sparse.size()) and (m_sparse[handle] != INVALID_INDEX);
+    }
+
+    unsigned int TransformSystem::GetSize() const
+    {
+        return static_cast<unsigned int>(m_handles.size());
+    }
+
+
+    // ****************************
+    // Hierarchy chain
+
+    void TransformSystem::SetParent(TransformHandle child, TransformHandle parent)
+    {
+        assert(IsValid(child));
+
+        const unsigned int index = m_sparse[child];
+        const unsigned int parentIndex = IsValid(parent) ? m_sparse[parent] : INVALID_INDEX;
+
+        // Refuse to create cycles
+        for (unsigned int p = parentIndex; p != INVALID_INDEX; p = m_parents[p])
+        {
+            if (p == index)
+            {
+                return;
+            }
+        }
+
+        glm::vec3 worldPosition;
+        glm::quat worldRotation;
+        ResolveWorld(index, worldPosition, worldRotation);
+
+        UnlinkChild(index);
+        m_parents[index] = parentIndex;
+        LinkChild(index);
+
+        SetWorldPosition(child, worldPosition);
+        SetWorldRotation(child, worldRotation);
+
+        if (parentIndex != INVALID_INDEX and parentIndex > index)
+        {
+            m_needsSort = true;
+        }
+        m_needsLayout = true;
+    }
+
+    TransformHandle TransformSystem::GetParent(TransformHandle handle) const
+    {
+        const unsigned int parentIndex = m_parents[m_sparse[handle]];
+        return (parentIndex == INVALID_INDEX) ? INVALID_TRANSFORM : m_handles[parentIndex];
+    }
+
+
+    // ****************************
+    // Local properties
+
+    void TransformSystem::SetLocalPosition(TransformHandle handle, const glm::vec3 &position)
+    {
+        const unsigned int index = m_sparse[handle];
+        m_localPositions[index] = position;
+        MarkDirty(index);
+    }
+
+    void TransformSystem::SetRelativeRotation(TransformHandle handle, const glm::quat &rotation)
+    {
+        const unsigned int index = m_sparse[handle];
+        m_relativeRotations[index] = rotation;
+        MarkDirty(index);
+    }
+
+    void TransformSystem::SetScale(TransformHandle handle, const glm::vec3 &scale)
+    {
+        const unsigned int index = m_sparse[handle];
+        m_scales[index] = scale;
+        MarkDirty(index);
+    }
+
+    const glm::vec3& TransformSystem::GetLocalPosition(TransformHandle handle) const
+    {
+        return m_localPositions[m_sparse[handle]];
+    }
+
+    const glm::quat& TransformSystem::GetRelativeRotation(TransformHandle handle) const
+    {
+        return m_relativeRotations[m_sparse[handle]];
+    }
+
+    const glm::vec3& TransformSystem::GetScale(TransformHandle handle) const
+    {
+        return m_scales[m_sparse[handle]];
+    }
+
+
+    // ****************************
+    // World properties
+
+    void TransformSystem::SetWorldPosition(TransformHandle handle, const glm::vec3 &position)
+    {
+        const unsigned int index = m_sparse[handle];
+        const unsigned int parentIndex = m_parents[index];
+
+        if (parentIndex == INVALID_INDEX)
+        {
+            m_localPositions[index] = position;
+        }
+        else
+        {
+            glm::vec3 parentPosition;
+            glm::quat parentRotation;
+            ResolveWorld(parentIndex, parentPosition, parentRotation);
+            m_localPositions[index] = glm::inverse(parentRotation) * (position - parentPosition);
+        }
+
+        MarkDirty(index);
+    }
+
+    void TransformSystem::SetWorldRotation(TransformHandle handle, const glm::quat &rotation)
+    {
+        const unsigned int index = m_sparse[handle];
+        const unsigned int parentIndex = m_parents[index];
+
+        if (parentIndex == INVALID_INDEX)
+        {
+            m_relativeRotations[index] = rotation;
+        }
+        else
+        {
+            glm::vec3 parentPosition;
+            glm::quat parentRotation;
+            ResolveWorld(parentIndex, parentPosition, parentRotation);
+            m_relativeRotations[index] = glm::inverse(parentRotation) * rotation;
+        }
+
+        MarkDirty(index);
+    }
+
+    glm::vec3 TransformSystem::GetWorldPosition(TransformHandle handle) const
+    {
+        glm::vec3 position;
+        glm::quat rotation;
+        ResolveWorld(m_sparse[handle], position, rotation);
+        return position;
+    }
+
+    glm::quat TransformSystem::GetWorldRotation(TransformHandle handle) const
+    {
+        glm::vec3 position;
+        glm::quat rotation;
+        ResolveWorld(m_sparse[handle], position, rotation);
+        return rotation;
+    }
+
+    const glm::mat4& TransformSystem::GetModel(TransformHandle handle)
+    {
+        const unsigned int index = m_sparse[handle];
+
+        if (m_dirtyCount > 0U)
+        {
+            // The node keeps its dirty flag, so that its descendants are still
+            // refreshed by the next Update()
+            glm::vec3 position;
+            glm::quat rotation;
+            ResolveWorld(index, position, rotation);
+            ComposeModels(&position, &rotation, &m_scales[index], &m_models[index], 1U);
+        }
+
+        return m_models[index];
+    }
+
+
+    // ****************************
+    // Speeds
+
+    void TransformSystem::SetSpeeds(TransformHandle handle, float move, float rotation, float scale)
+    {
+        m_speeds[m_sparse[handle]] = glm::vec3(move, rotation, scale);
+    }
+
+    const glm::vec3& TransformSystem::GetSpeeds(TransformHandle handle) const
+    {
+        return m_speeds[m_sparse[handle]];
+    }
+
+
+    // ****************************
+    // Frame update
+
+    unsigned int TransformSystem::Update()
+    {
+        if (m_dirtyCount == 0U)
+        {
+            return 0U;
+        }
+
+        if (m_needsSort)
+        {
+            SortHierarchy();
+        }
+
+        const unsigned int updated = UpdateRange(0U, static_cast<unsigned int>(m_handles.size()));
+
+        std::fill(m_dirty.begin(), m_dirty.end(), static_cast<unsigned char>(0U));
+        m_dirtyCount = 0U;
+
+        return updated;
+    }
+
+    unsigned int TransformSystem::Update(WorkerPool &pool)
+    {
+        if (m_dirtyCount == 0U)
+        {
+            return 0U;
+        }
+
+        if (m_needsSort or m_needsLayout)
+        {
+            SortHierarchy();
+        }
+
+        std::atomic<unsigned int> updated(0U);
+        const unsigned int maxTasks = pool.GetThreadCount() * TASKS_PER_THREAD;
+
+        // Upper levels, with a barrier between them. The task boundaries are
+        // aligned, so that two tasks never write the same cache line.
+        for (unsigned int level = 0U; level + 1U < m_levelOffsets.size(); ++level)
+        {
+            const unsigned int begin = m_levelOffsets[level];
+            const unsigned int end = m_levelOffsets[level + 1U];
+            const unsigned int taskCount = MAX(1U, MIN((end - begin) / TASK_GRAIN, maxTasks));
+
+            pool.Run(taskCount, [&](unsigned int task)
+            {
+                unsigned int taskBegin = begin;
+                unsigned int taskEnd = end;
+
+                if (task > 0U)
+                {
+                    taskBegin = begin + static_cast<unsigned int>(1ULL * (end - begin) * task / taskCount);
+                    taskBegin = MAX(begin, taskBegin - taskBegin % TASK_ALIGNMENT);
+                }
+                if (task + 1U < taskCount)
+                {
+                    taskEnd = begin + static_cast<unsigned int>(1ULL * (end - begin) * (task + 1U) / taskCount);
+                    taskEnd = MAX(begin, taskEnd - taskEnd % TASK_ALIGNMENT);
+                }
+
+                updated += UpdateRange(taskBegin, taskEnd);
+            });
+        }
+
+        // Subtrees, each one stored contiguously. The tasks get about the same
+        // number of nodes and always start at the root of a subtree.
+        const unsigned int begin = m_subtreeOffsets.front();
+        const unsigned int end = m_subtreeOffsets.back();
+        const unsigned int taskCount = MAX(1U, MIN((end - begin) / TASK_GRAIN, maxTasks));
+
+        pool.Run(taskCount, [&](unsigned int task)
+        {
+            const unsigned int taskBegin = (task == 0U) ? begin : *std::lower_bound(m_subtreeOffsets.begin(), m_subtreeOffsets.end(),
+                begin + static_cast<unsigned int>(1ULL * (end - begin) * task / taskCount));
+            const unsigned int taskEnd = (task + 1U == taskCount) ? end : *std::lower_bound(m_subtreeOffsets.begin(), m_subtreeOffsets.end(),
+                begin + static_cast<unsigned int>(1ULL * (end - begin) * (task + 1U) / taskCount));
+
+            updated += UpdateRange(taskBegin, taskEnd);
+        });
+
+        std::fill(m_dirty.begin(), m_dirty.end(), static_cast<unsigned char>(0U));
+        m_dirtyCount = 0U;
+
+        return updated.load();
+    }
+
+    bool TransformSystem::IsDirty() const
+    {
+        return m_dirtyCount > 0U;
+    }
+
+    const glm::mat4* TransformSystem::GetModels() const
+    {
+        return m_models.data();
+    }
+
+    unsigned int TransformSystem::GetIndex(TransformHandle handle) const
+    {
+        return m_sparse[handle];
+    }
+
+
+    // ****************************
+    // Internals
+
+    void TransformSystem::SortHierarchy()
+    {
+        const unsigned int size = static_cast<unsigned int>(m_handles.size());
+
+        // Compute the depth of every node, memoizing the already visited chains
+        std::vector<unsigned int> depths(size, INVALID_INDEX);
+        std::vector<unsigned int> chain;
+        unsigned int maxDepth = 0U;
+
+        for (unsigned int i = 0U; i < size; ++i)
+        {
+            unsigned int node = i;
+            while (node != INVALID_INDEX and depths[node] == INVALID_INDEX)
+            {
+                chain.push_back(node);
+                node = m_parents[node];
+            }
+
+            unsigned int depth = (node == INVALID_INDEX) ? 0U : depths[node] + 1U;
+            while (!chain.empty())
+            {
+                depths[chain.back()] = depth++;
+                chain.pop_back();
+            }
+
+            maxDepth = MAX(maxDepth, depths[i]);
+        }
+
+        // Stable counting sort by depth, which places parents before children
+        std::vector<unsigned int> levels(maxDepth + 2U, 0U);
+        for (unsigned int i = 0U; i < size; ++i)
+        {
+            ++levels[depths[i] + 1U];
+        }
+        for (unsigned int d = 1U; d < levels.size(); ++d)
+        {
+            levels[d] += levels[d - 1U];
+        }
+
+        std::vector<unsigned int> byDepth(size);
+        {
+            std::vector<unsigned int> offsets(levels);
+            for (unsigned int i = 0U; i < size; ++i)
+            {
+                byDepth[offsets[depths[i]]++] = i;
+            }
+        }
+
+        // Subtree sizes and children lists, filled from the deepest level up
+        std::vector<unsigned int> subtreeSizes(size, 1U);
+        std::vector<unsigned int> childOffsets(size + 1U, 0U);
+        for (unsigned int k = size; k > 0U; --k)
+        {
+            const unsigned int node = byDepth[k - 1U];
+            if (m_parents[node] != INVALID_INDEX)
+            {
+                subtreeSizes[m_parents[node]] += subtreeSizes[node];
+                ++childOffsets[m_parents[node] + 1U];
+            }
+        }
+        for (unsigned int i = 1U; i <= size; ++i)
+        {
+            childOffsets[i] += childOffsets[i - 1U];
+        }
+
+        std::vector<unsigned int> children(size);
+        {
+            std::vector<unsigned int> offsets(childOffsets);
+            for (unsigned int k = 0U; k < size; ++k)
+            {
+                const unsigned int node = byDepth[k];
+                if (m_parents[node] != INVALID_INDEX)
+                {
+                    children[offsets[m_parents[node]]++] = node;
+                }
+            }
+        }
+
+        // The first level whose subtrees are, on average, small enough to be
+        // updated by a single thread. The deepest level always qualifies.
+        unsigned int cut = 0U;
+        for (; cut < maxDepth; ++cut)
+        {
+            const unsigned int levelSize = levels[cut + 1U] - levels[cut];
+            if (size - levels[cut] <= levelSize * SUBTREE_GRAIN)
+            {
+                break;
+            }
+        }
+
+        // The levels above the cut are stored level by level, and then every
+        // subtree below the cut is stored contiguously, in depth first order
+        std::vector<unsigned int> order;
+        order.reserve(size);
+
+        m_levelOffsets.assign(levels.begin(), levels.begin() + cut + 1U);
+        order.assign(byDepth.begin(), byDepth.begin() + levels[cut]);
+
+        m_subtreeOffsets.clear();
+        for (unsigned int k = levels[cut]; k < levels[cut + 1U]; ++k)
+        {
+            m_subtreeOffsets.push_back(static_cast<unsigned int>(order.size()));
+
+            chain.push_back(byDepth[k]);
+            while (!chain.empty())
+            {
+                const unsigned int node = chain.back();
+                chain.pop_back();
+                order.push_back(node);
+
+                for (unsigned int c = childOffsets[node + 1U]; c > childOffsets[node]; --c)
+                {
+                    chain.push_back(children[c - 1U]);
+                }
+            }
+        }
+        m_subtreeOffsets.push_back(size);
+
+        std::vector<unsigned int> newIndex(size);
+        for (unsigned int k = 0U; k < size; ++k)
+        {
+            newIndex[order[k]] = k;
+        }
+
+        std::vector<TransformHandle> handles(size);
+        std::vector<unsigned int> parents(size);
+        std::vector<glm::vec3> localPositions(size);
+        std::vector<glm::quat> relativeRotations(size);
+        std::vector<glm::vec3> scales(size);
+        std::vector<glm::vec3> worldPositions(size);
+        std::vector<glm::quat> worldRotations(size);
+        std::vector<glm::mat4> models(size);
+        std::vector<unsigned char> dirty(size);
+        std::vector<glm::vec3> speeds(size);
+
+        for (unsigned int i = 0U; i < size; ++i)
+        {
+            const unsigned int j = newIndex[i];
+            handles[j] = m_handles[i];
+            parents[j] = (m_parents[i] == INVALID_INDEX) ? INVALID_INDEX : newIndex[m_parents[i]];
+            localPositions[j] = m_localPositions[i];
+            relativeRotations[j] = m_relativeRotations[i];
+            scales[j] = m_scales[i];
+            worldPositions[j] = m_worldPositions[i];
+            worldRotations[j] = m_worldRotations[i];
+            models[j] = m_models[i];
+            dirty[j] = m_dirty[i];
+            speeds[j] = m_speeds[i];
+
+            m_sparse[m_handles[i]] = j;
+        }
+
+        m_handles.swap(handles);
+        m_parents.swap(parents);
+        m_localPositions.swap(localPositions);
+        m_relativeRotations.swap(relativeRotations);
+        m_scales.swap(scales);
+        m_worldPositions.swap(worldPositions);
+        m_worldRotations.swap(worldRotations);
+        m_models.swap(models);
+        m_dirty.swap(dirty);
+        m_speeds.swap(speeds);
+
+        // The children lists are rebuilt with the new indices
+        std::fill(m_firstChildren.begin(), m_firstChildren.end(), INVALID_INDEX);
+        for (unsigned int i = size; i > 0U; --i)
+        {
+            LinkChild(i - 1U);
+        }
+
+        m_needsSort = false;
+        m_needsLayout = false;
+    }
+
+    unsigned int TransformSystem::UpdateRange(unsigned int begin, unsigned int end)
+    {
+        unsigned int updated = 0U;
+
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            const unsigned int parentIndex = m_parents[i];
+
+            if (parentIndex != INVALID_INDEX)
+            {
+                // Parents are stored first, so their world data is already final
+                m_dirty[i] |= m_dirty[parentIndex];
+            }
+
+            if (m_dirty[i] == 0U)
+            {
+                continue;
+            }
+
+            if (parentIndex == INVALID_INDEX)
+            {
+                m_worldPositions[i] = m_localPositions[i];
+                m_worldRotations[i] = m_relativeRotations[i];
+            }
+            else
+            {
+                const glm::quat &parentRotation = m_worldRotations[parentIndex];
+                m_worldPositions[i] = m_worldPositions[parentIndex] + parentRotation * m_localPositions[i];
+                m_worldRotations[i] = parentRotation * m_relativeRotations[i];
+            }
+
+            ++updated;
+        }
+
+        // The matrices are rebuilt by the batch kernel, one call for every
+        // run of consecutive dirty nodes
+        for (unsigned int i = begin; i < end; )
+        {
+            if (m_dirty[i] == 0U)
+            {
+                ++i;
+                continue;
+            }
+
+            unsigned int runEnd = i + 1U;
+            while (runEnd < end and m_dirty[runEnd] != 0U)
+            {
+                ++runEnd;
+            }
+
+            ComposeModels(&m_worldPositions[i], &m_worldRotations[i], &m_scales[i], &m_models[i], runEnd - i);
+            i = runEnd;
+        }
+
+        return updated;
+    }
+
+    void TransformSystem::MarkDirty(unsigned int index)
+    {
+        if (m_dirty[index] == 0U)
+        {
+            m_dirty[index] = 1U;
+            ++m_dirtyCount;
+        }
+    }
+
+    void TransformSystem::ResolveWorld(unsigned int index, glm::vec3 &position, glm::quat &rotation) const
+    {
+        if (m_dirtyCount == 0U)
+        {
+            position = m_worldPositions[index];
+            rotation = m_worldRotations[index];
+            return;
+        }
+
+        // Some ancestor might be dirty, so compose the local data from the root
+        // down. Iterative on purpose, deep chains must not overflow the stack.
+        unsigned int chain[64];
+        std::vector<unsigned int> longChain;
+        unsigned int length = 0U;
+
+        for (unsigned int node = index; node != INVALID_INDEX; node = m_parents[node])
+        {
+            if (length < SIZEOF_ARRAY(chain))
+            {
+                chain[length] = node;
+            }
+            else
+            {
+                if (longChain.empty())
+                {
+                    longChain.assign(chain, chain + length);
+                }
+                longChain.push_back(node);
+            }
+            ++length;
+        }
+
+        const unsigned int *nodes = longChain.empty() ? chain : longChain.data();
+
+        position = m_localPositions[nodes[length - 1U]];
+        rotation = m_relativeRotations[nodes[length - 1U]];
+
+        for (unsigned int i = length - 1U; i > 0U; --i)
+        {
+            const unsigned int node = nodes[i - 1U];
+            position = position + rotation * m_localPositions[node];
+            rotation = rotation * m_relativeRotations[node];
+        }
+    }
+
+    void TransformSystem::LinkChild(unsigned int index)
+    {
+        const unsigned int parentIndex = m_parents[index];
+
+        m_previousSiblings[index] = INVALID_INDEX;
+        if (parentIndex == INVALID_INDEX)
+        {
+            m_nextSiblings[index] = INVALID_INDEX;
+            return;
+        }
+
+        const unsigned int next = m_firstChildren[parentIndex];
+        m_nextSiblings[index] = next;
+        if (next != INVALID_INDEX)
+        {
+            m_previousSiblings[next] = index;
+        }
+        m_firstChildren[parentIndex] = index;
+    }
+
+    void TransformSystem::UnlinkChild(unsigned int index)
+    {
+        const unsigned int previous = m_previousSiblings[index];
+        const unsigned int next = m_nextSiblings[index];
+
+        if (previous != INVALID_INDEX)
+        {
+            m_nextSiblings[previous] = next;
+        }
+        else if (m_parents[index] != INVALID_INDEX)
+        {
+            m_firstChildren[m_parents[index]] = next;
+        }
+
+        if (next != INVALID_INDEX)
+        {
+            m_previousSiblings[next] = previous;
+        }
+
+        m_nextSiblings[index] = INVALID_INDEX;
+        m_previousSiblings[index] = INVALID_INDEX;
+    }
+
+    void TransformSystem::RemoveAt(unsigned int index)
+    {
+        // The node has no children and is not linked to its parent anymore
+        const unsigned int last = static_cast<unsigned int>(m_handles.size()) - 1U;
+
+        if (m_dirty[index] != 0U)
+        {
+            --m_dirtyCount;
+        }
+
+        if (index != last)
+        {
+            // Swap-remove, the moved node may now be stored before its parent
+            m_handles[index] = m_handles[last];
+            m_parents[index] = m_parents[last];
+            m_localPositions[index] = m_localPositions[last];
+            m_relativeRotations[index] = m_relativeRotations[last];
+            m_scales[index] = m_scales[last];
+            m_worldPositions[index] = m_worldPositions[last];
+            m_worldRotations[index] = m_worldRotations[last];
+            m_models[index] = m_models[last];
+            m_dirty[index] = m_dirty[last];
+            m_speeds[index] = m_speeds[last];
+            m_firstChildren[index] = m_firstChildren[last];
+            m_nextSiblings[index] = m_nextSiblings[last];
+            m_previousSiblings[index] = m_previousSiblings[last];
+
+            m_sparse[m_handles[index]] = index;
+
+            // Only the links to the moved node need its new index
+            const unsigned int previous = m_previousSiblings[index];
+            const unsigned int next = m_nextSiblings[index];
+
+            if (previous != INVALID_INDEX)
+            {
+                m_nextSiblings[previous] = index;
+            }
+            else if (m_parents[index] != INVALID_INDEX)
+            {
+                m_firstChildren[m_parents[index]] = index;
+            }
+
+            if (next != INVALID_INDEX)
+            {
+                m_previousSiblings[next] = index;
+            }
+
+            for (unsigned int child = m_firstChildren[index]; child != INVALID_INDEX; child = m_nextSiblings[child])
+            {
+                m_parents[child] = index;
+            }
+
+            m_needsSort = true;
+        }
+
+        m_handles.pop_back();
+        m_parents.pop_back();
+        m_localPositions.pop_back();
+        m_relativeRotations.pop_back();
+        m_scales.pop_back();
+        m_worldPositions.pop_back();
+        m_worldRotations.pop_back();
+        m_models.pop_back();
+        m_dirty.pop_back();
+        m_speeds.pop_back();
+        m_firstChildren.pop_back();
+        m_nextSiblings.pop_back();
+        m_previousSiblings.pop_back();
+
+        m_needsLayout = true;
+    }
+
+
+    // ****************************
+    // TransformRef
+
+    TransformRef::TransformRef()
+        : m_system(nullptr),
+          m_handle(INVALID_TRANSFORM)
+    {
+    }
+
+    TransformRef::TransformRef(TransformSystem *system, TransformHandle handle)
+        : m_system(system),
+          m_handle(handle)
+    {
+    }
+
+    TransformSystem* TransformRef::GetSystem() const
+    {
+        return m_system;
+    }
+
+    TransformHandle TransformRef::GetHandle() const
+    {
+        return m_handle;
+    }
+
+    bool TransformRef::IsValid() const
+    {
+        return (m_system != nullptr) and m_system->IsValid(m_handle);
+    }
+
+
+    // ****************************
+    // Get transform properties
+
+    glm::vec3 TransformRef::GetLocalPosition() const
+    {
+        return m_system->GetLocalPosition(m_handle);
+    }
+
+    glm::vec3 TransformRef::GetWorldPosition() const
+    {
+        return m_system->GetWorldPosition(m_handle);
+    }
+
+    glm::quat TransformRef::GetWorldRotation() const
+    {
+        return m_system->GetWorldRotation(m_handle);
+    }
+
+    glm::quat TransformRef::GetRelativeRotation() const
+    {
+        return m_system->GetRelativeRotation(m_handle);
+    }
+
+    glm::vec3 TransformRef::GetRotationEulerRad() const
+    {
+        return glm::eulerAngles(GetWorldRotation());
+    }
+
+    glm::vec3 TransformRef::GetRotationEuler360() const
+    {
+        return DEGREES(glm::eulerAngles(GetWorldRotation()));
+    }
+
+
+    glm::vec3 TransformRef::GetLocalOYVector() const
+    {
+        return GetWorldRotation() * glm::vec3_up;
+    }
+
+    glm::vec3 TransformRef::GetLocalOXVector() const
+    {
+        return GetWorldRotation() * glm::vec3_right;
+    }
+
+    glm::vec3 TransformRef::GetLocalOZVector() const
+    {
+        return GetWorldRotation() * glm::vec3_forward;
+    }
+
+
+    glm::vec3 TransformRef::GetScale() const
+    {
+        return m_system->GetScale(m_handle);
+    }
+
+    const glm::mat4& TransformRef::GetModel()
+    {
+        return m_system->GetModel(m_handle);
+    }
+
+
+    float TransformRef::GetMoveSpeed() const
+    {
+        return m_system->GetSpeeds(m_handle).x;
+    }
+
+    float TransformRef::GetScaleSpeed() const
+    {
+        return m_system->GetSpeeds(m_handle).z;
+    }
+
+    float TransformRef::GetRotationSpeed() const
+    {
+        return m_system->GetSpeeds(m_handle).y;
+    }
+
+
+    // ****************************
+    // Continuous transform methods
+
+    void TransformRef::Move(const glm::vec3 &offset)
+    {
+        SetWorldPosition(GetWorldPosition() + offset);
+    }
+
+    void TransformRef::Move(const glm::vec3 &dir, float deltaTime)
+    {
+        SetWorldPosition(GetWorldPosition() + GetMoveSpeed() * deltaTime * glm::normalize(dir));
+    }
+
+    void TransformRef::Scale(float deltaTime)
+    {
+        SetScale(GetScale() + glm::vec3(GetScaleSpeed() * deltaTime));
+    }
+
+
+    // Rotations
+    void TransformRef::RotateWorldOX(float deltaTime)
+    {
+        const glm::vec3 angles = deltaTime * GetRotationSpeed() * glm::vec3_right;
+        SetWorldRotation(glm::quat( RADIANS(angles) ) * GetWorldRotation());
+    }
+
+    void TransformRef::RotateWorldOY(float deltaTime)
+    {
+        const glm::vec3 angles = deltaTime * GetRotationSpeed() * glm::vec3_up;
+        SetWorldRotation(glm::quat( RADIANS(angles) ) * GetWorldRotation());
+    }
+
+    void TransformRef::RotateWorldOZ(float deltaTime)
+    {
+        const glm::vec3 angles = deltaTime * GetRotationSpeed() * glm::vec3_forward;
+        SetWorldRotation(glm::quat( RADIANS(angles) ) * GetWorldRotation());
+    }
+
+    void TransformRef::RotateLocalOX(float deltaTime)
+    {
+        const glm::vec3 angles = deltaTime * GetRotationSpeed() * glm::vec3_right;
+        SetWorldRotation(GetWorldRotation() * glm::quat( RADIANS(angles) ));
+    }
+
+    void TransformRef::RotateLocalOY(float deltaTime)
+    {
+        const glm::vec3 angles = deltaTime * GetRotationSpeed() * glm::vec3_up;
+        SetWorldRotation(GetWorldRotation() * glm::quat( RADIANS(angles) ));
+    }
+
+    void TransformRef::RotateLocalOZ(float deltaTime)
+    {
+        const glm::vec3 angles = deltaTime * GetRotationSpeed() * glm::vec3_forward;
+        SetWorldRotation(GetWorldRotation() * glm::quat( RADIANS(angles) ));
+    }
+
+
+    // Positions
+    void TransformRef::SetLocalPosition(glm::vec3 position)
+    {
+        m_system->SetLocalPosition(m_handle, position);
+    }
+
+    void TransformRef::SetWorldPosition(glm::vec3 position)
+    {
+        m_system->SetWorldPosition(m_handle, position);
+    }
+
+
+    // Rotations
+    void TransformRef::SetWorldRotation(glm::quat rotationQ)
+    {
+        m_system->SetWorldRotation(m_handle, rotationQ);
+    }
+
+    void TransformRef::SetWorldRotation(const glm::vec3 &eulerAngles360)
+    {
+        SetWorldRotation(glm::quat( RADIANS(eulerAngles360) ));
+    }
+
+    void TransformRef::SetWorldRotationAndScale(const glm::quat &rotationQ, glm::vec3 scale)
+    {
+        m_system->SetScale(m_handle, scale);
+        SetWorldRotation(rotationQ);
+    }
+
+
+    void TransformRef::SetReleativeRotation(const glm::vec3 &eulerAngles360)
+    {
+        SetReleativeRotation(glm::quat( RADIANS(eulerAngles360) ));
+    }
+
+    void TransformRef::SetReleativeRotation(const glm::quat &localRotationQ)
+    {
+        m_system->SetRelativeRotation(m_handle, localRotationQ);
+    }
+
+
+    // Scales
+    void TransformRef::SetScale(glm::vec3 scale)
+    {
+        m_system->SetScale(m_handle, scale);
+    }
+
+
+    // ****************************
+    // Transform properties
+
+    void TransformRef::SetMoveSpeed(float unitsPerSecond)
+    {
+        const glm::vec3 &speeds = m_system->GetSpeeds(m_handle);
+        m_system->SetSpeeds(m_handle, unitsPerSecond, speeds.y, speeds.z);
+    }
+
+    void TransformRef::SetScaleSpeed(float unitsPerSecond)
+    {
+        const glm::vec3 &speeds = m_system->GetSpeeds(m_handle);
+        m_system->SetSpeeds(m_handle, speeds.x, speeds.y, unitsPerSecond);
+    }
+
+    void TransformRef::SetRotationSpeed(float degreesPerSecond)
+    {
+        const glm::vec3 &speeds = m_system->GetSpeeds(m_handle);
+        m_system->SetSpeeds(m_handle, speeds.x, degreesPerSecond, speeds.z);
+    }
+
+
+    // ****************************
+    // Transform operations
+    float TransformRef::DistanceTo(const TransformRef &transform) const
+    {
+        return glm::length(transform.GetWorldPosition() - GetWorldPosition());
+    }
+
+    float TransformRef::DistanceTo(const glm::vec3 &position) const
+    {
+        return glm::length(position - GetWorldPosition());
+    }
+
+    float TransformRef::Distance2To(const TransformRef &transform) const
+    {
+        return glm::length2(transform.GetWorldPosition() - GetWorldPosition());
+    }
+
+    float TransformRef::Distance2To(const glm::vec3 &position) const
+    {
+        return glm::length2(position - GetWorldPosition());
+    }
+
+
+    // ****************************
+    // Hierarchy chain
+
+    void TransformRef::AddChild(const TransformRef &transform)
+    {
+        assert(transform.m_system == m_system);
+        m_system->SetParent(transform.m_handle, m_handle);
+    }
+
+    void TransformRef::RemoveChild(const TransformRef &transform)
+    {
+        assert(transform.m_system == m_system);
+        if (m_system->GetParent(transform.m_handle) == m_handle)
+        {
+            m_system->SetParent(transform.m_handle, INVALID_TRANSFORM);
+        }
+    }
+}
@@ -0,0 +1,238 @@
+#ifndef GFXC_TRANSFORM_SYSTEM_H
+#define GFXC_TRANSFORM_SYSTEM_H
+
+#include "components/exports.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+#include <vector>
+
+
+namespace gfxc
+{
+    class WorkerPool;
+
+    typedef unsigned int TransformHandle;
+
+    static const TransformHandle INVALID_TRANSFORM = 0xFFFFFFFFU;
+
+    // Data oriented storage for large transform hierarchies. Every component
+    // lives in its own contiguous pool (structure of arrays) and the pools are
+    // kept sorted so that a parent is always stored before its children. World
+    // data is only recomputed in Update(), in a single linear pass over the
+    // pools, for the nodes that were modified since the last call.
+    //
+    // The math follows gfxc::Transform: the world position of a node is the
+    // parent world position plus the local position rotated by the parent
+    // world rotation, and the scale is never inherited.
+    class GFXC_API TransformSystem
+    {
+     public:
+        TransformSystem();
+        ~TransformSystem();
+
+        TransformSystem(const TransformSystem &) = delete;
+        TransformSystem& operator=(const TransformSystem &) = delete;
+
+        void Reserve(unsigned int capacity);
+
+        // ****************************
+        // Node lifetime
+
+        TransformHandle Create(TransformHandle parent = INVALID_TRANSFORM);
+        void Destroy(TransformHandle handle);
+        bool IsValid(TransformHandle handle) const;
+        unsigned int GetSize() const;
+
+        // ****************************
+        // Hierarchy chain
+
+        // The world position and rotation of the child are kept unchanged
+        void SetParent(TransformHandle child, TransformHandle parent);
+        TransformHandle GetParent(TransformHandle handle) const;
+
+        // ****************************
+        // Local properties
+
+        void SetLocalPosition(TransformHandle handle, const glm::vec3 &position);
+        void SetRelativeRotation(TransformHandle handle, const glm::quat &rotation);
+        void SetScale(TransformHandle handle, const glm::vec3 &scale);
+
+        const glm::vec3& GetLocalPosition(TransformHandle handle) const;
+        const glm::quat& GetRelativeRotation(TransformHandle handle) const;
+        const glm::vec3& GetScale(TransformHandle handle) const;
+
+        // ****************************
+        // World properties
+
+        void SetWorldPosition(TransformHandle handle, const glm::vec3 &position);
+        void SetWorldRotation(TransformHandle handle, const glm::quat &rotation);
+
+        // Resolved on demand by walking up to the root if any node is dirty
+        glm::vec3 GetWorldPosition(TransformHandle handle) const;
+        glm::quat GetWorldRotation(TransformHandle handle) const;
+        const glm::mat4& GetModel(TransformHandle handle);
+
+        // ****************************
+        // Speeds, used by the continuous methods of TransformRef
+
+        void SetSpeeds(TransformHandle handle, float move, float rotation, float scale);
+        const glm::vec3& GetSpeeds(TransformHandle handle) const;
+
+        // ****************************
+        // Frame update
+
+        // Recomputes the world data of every dirty node and of its descendants.
+        // Returns the number of world matrices that were rebuilt.
+        unsigned int Update();
+        bool IsDirty() const;
+
+        // Same as Update(), but spread over the threads of the pool. The nodes
+        // are laid out in two parts: the upper levels of the hierarchy, stored
+        // level by level and updated one level at a time, and below them the
+        // subtrees small enough for one thread, each stored contiguously and
+        // updated as a unit, so that no two threads write the same cache line.
+        unsigned int Update(WorkerPool &pool);
+
+        // Direct access to the pools, in parent before child order. Only valid
+        // until the next structural change (Create, Destroy, SetParent).
+        const glm::mat4* GetModels() const;
+        unsigned int GetIndex(TransformHandle handle) const;
+
+     private:
+        void SortHierarchy();
+        unsigned int UpdateRange(unsigned int begin, unsigned int end);
+        void MarkDirty(unsigned int index);
+        void ResolveWorld(unsigned int index, glm::vec3 &position, glm::quat &rotation) const;
+        void LinkChild(unsigned int index);
+        void UnlinkChild(unsigned int index);
+        void RemoveAt(unsigned int index);
+
+     private:
+        // Handle -> dense index, and back
+        std::vector<unsigned int>       m_sparse;
+        std::vector<TransformHandle>    m_handles;
+        std::vector<TransformHandle>    m_freeHandles;
+
+        // Hot data, all indexed by the dense index
+        std::vector<unsigned int>       m_parents;
+        std::vector<glm::vec3>          m_localPositions;
+        std::vector<glm::quat>          m_relativeRotations;
+        std::vector<glm::vec3>          m_scales;
+        std::vector<glm::vec3>          m_worldPositions;
+        std::vector<glm::quat>          m_worldRotations;
+        std::vector<glm::mat4>          m_models;
+        std::vector<unsigned char>      m_dirty;
+
+        // Cold data: move, rotation and scale speeds
+        std::vector<glm::vec3>          m_speeds;
+
+        // Children of every node, as doubly linked lists of dense indices, so
+        // that removing a node only visits its own children
+        std::vector<unsigned int>       m_firstChildren;
+        std::vector<unsigned int>       m_nextSiblings;
+        std::vector<unsigned int>       m_previousSiblings;
+
+        // Layout built by SortHierarchy(), used by the parallel update. Both
+        // hold the index of the first node of each level or subtree, plus the
+        // end of the last one.
+        std::vector<unsigned int>       m_levelOffsets;
+        std::vector<unsigned int>       m_subtreeOffsets;
+
+        unsigned int                    m_dirtyCount;
+        bool                            m_needsSort;
+        bool                            m_needsLayout;
+    };
+
+
+    // Thin facade that exposes the gfxc::Transform API on top of a node stored
+    // in a TransformSystem. It is a value type and can be copied freely.
+    class GFXC_API TransformRef
+    {
+     public:
+        TransformRef();
+        TransformRef(TransformSystem *system, TransformHandle handle);
+
+        TransformSystem* GetSystem() const;
+        TransformHandle GetHandle() const;
+        bool IsValid() const;
+
+        // ****************************
+        // Get transform properties
+
+        glm::vec3 GetLocalPosition() const;
+        glm::vec3 GetWorldPosition() const;
+        glm::quat GetWorldRotation() const;
+        glm::quat GetRelativeRotation() const;
+        glm::vec3 GetRotationEulerRad() const;
+        glm::vec3 GetRotationEuler360() const;
+
+        glm::vec3 GetLocalOYVector() const;
+        glm::vec3 GetLocalOXVector() const;
+        glm::vec3 GetLocalOZVector() const;
+
+        glm::vec3 GetScale() const;
+        const glm::mat4& GetModel();
+
+        float GetMoveSpeed() const;
+        float GetScaleSpeed() const;
+        float GetRotationSpeed() const;
+
+        // ****************************
+        // Continuous transform methods
+
+        void Move(const glm::vec3 &offset);
+        void Move(const glm::vec3 &dir, float deltaTime);
+        void Scale(float deltaTime);
+
+        // Rotations
+        void RotateWorldOX(float deltaTime);
+        void RotateWorldOY(float deltaTime);
+        void RotateWorldOZ(float deltaTime);
+        void RotateLocalOX(float deltaTime);
+        void RotateLocalOY(float deltaTime);
+        void RotateLocalOZ(float deltaTime);
+
+        // Positions
+        void SetLocalPosition(glm::vec3 position);
+        void SetWorldPosition(glm::vec3 position);
+
+        // Rotations
+        void SetWorldRotation(glm::quat rotationQ);
+        void SetWorldRotation(const glm::vec3 &eulerAngles360);
+        void SetWorldRotationAndScale(const glm::quat &rotationQ, glm::vec3 scale);
+
+        void SetReleativeRotation(const glm::vec3 &eulerAngles360);
+        void SetReleativeRotation(const glm::quat &localRotationQ);
+
+        // Scales
+        void SetScale(glm::vec3 scale);
+
+        // ****************************
+        // Transform properties
+
+        void SetMoveSpeed(float unitsPerSecond);
+        void SetScaleSpeed(float unitsPerSecond);
+        void SetRotationSpeed(float degreesPerSecond);
+
+        // ****************************
+        // Transform operations
+        float DistanceTo(const TransformRef &transform) const;
+        float DistanceTo(const glm::vec3 &position) const;
+        float Distance2To(const TransformRef &transform) const;
+        float Distance2To(const glm::vec3 &position) const;
+
+        // ****************************
+        // Hierarchy chain
+
+        void AddChild(const TransformRef &transform);
+        void RemoveChild(const TransformRef &transform);
+
+     private:
+        TransformSystem *   m_system;
+        TransformHandle     m_handle;
+    };
+}
+
+#endif
@@ -8,7 +8,9 @@
 #include <ios>
 #include <iostream>
 
-static std::ostream& operator<<(std::ostream &os, const std::list<gfxc::Transform*> &children)
+#if !defined(GFXC_TRANSFORM_FINAL)
+
+static std::ostream& operator<<(std::ostream &os, const gfxc::SmallVector<gfxc::Transform*, 4U> &children)
 {
     auto remainingChildren = children.size();
     os << "[";
@@ -52,9 +54,13 @@ static void PrintInternalState(const gfxc::TransformInternals &internals, const
               << indentStr << "Is in motion: " << internals.m_isInMotion << "\n"
               << indentStr << "Is model outdated: " << internals.m_isModelOutdated << "\n"
               << indentStr << "Update hierarchy: " << internals.m_updateHierarchy << "\n"
+              << indentStr << "Lazy update: " << internals.m_lazyUpdate << "\n"
+              << indentStr << "Is world outdated: " << internals.m_isWorldOutdated << "\n"
+              << indentStr << "Ignores parent position: " << internals.m_ignoresParentPosition << "\n"
               << std::noboolalpha
               << "\n"
               << indentStr << "Parent: " << internals.m_parentNode << "\n"
+              << indentStr << "Slot in parent: " << internals.m_childSlot << "\n"
               << indentStr << "Children: " << internals.m_childNodes << std::endl;
 }
 
@@ -153,6 +159,24 @@ static void PrintDifferences(const gfxc::TransformInternals &i1, const gfxc::Tra
                   << indentStr << "    Before: " << i1.m_updateHierarchy << "\n"
                   << indentStr << "    After: " << i2.m_updateHierarchy << "\n";
     }
+    if (i1.m_lazyUpdate != i2.m_lazyUpdate)
+    {
+        std::cout << indentStr << "Lazy update has changed\n"
+                  << indentStr << "    Before: " << i1.m_lazyUpdate << "\n"
+                  << indentStr << "    After: " << i2.m_lazyUpdate << "\n";
+    }
+    if (i1.m_isWorldOutdated != i2.m_isWorldOutdated)
+    {
+        std::cout << indentStr << "Is world outdated has changed\n"
+                  << indentStr << "    Before: " << i1.m_isWorldOutdated << "\n"
+                  << indentStr << "    After: " << i2.m_isWorldOutdated << "\n";
+    }
+    if (i1.m_ignoresParentPosition != i2.m_ignoresParentPosition)
+    {
+        std::cout << indentStr << "Ignores parent position has changed\n"
+                  << indentStr << "    Before: " << i1.m_ignoresParentPosition << "\n"
+                  << indentStr << "    After: " << i2.m_ignoresParentPosition << "\n";
+    }
     std::cout << std::noboolalpha;
 
     if (i1.m_parentNode != i2.m_parentNode)
@@ -162,6 +186,13 @@ static void PrintDifferences(const gfxc::TransformInternals &i1, const gfxc::Tra
                   << indentStr << "    After: " << i2.m_parentNode << "\n";
     }
 
+    if (i1.m_childSlot != i2.m_childSlot)
+    {
+        std::cout << indentStr << "Slot in parent has changed\n"
+                  << indentStr << "    Before: " << i1.m_childSlot << "\n"
+                  << indentStr << "    After: " << i2.m_childSlot << "\n";
+    }
+
     if (i1.m_childNodes != i2.m_childNodes)
     {
         std::cout << indentStr << "Child nodes have changed:\n"
@@ -698,3 +729,5 @@ namespace gfxc
     }
 #endif
 }
+
+#endif // !GFXC_TRANSFORM_FINAL
@@ -3,6 +3,10 @@
 
 #include "transform.h"
 
+// The wrapper derives from gfxc::Transform, so it is not available when
+// Transform is marked final
+#if !defined(GFXC_TRANSFORM_FINAL)
+
 namespace gfxc
 {
     class TransformWrapper : public Transform
@@ -97,4 +101,6 @@ namespace gfxc
     };
 }
 
+#endif // !GFXC_TRANSFORM_FINAL
+
 #endif // GFXC_TRANSFORM_WRAPPER_H
\ No newline at end of file
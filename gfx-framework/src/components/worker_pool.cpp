@@ -0,0 +1,116 @@
+#include "components/worker_pool.h"
+
+
+namespace gfxc
+{
+    WorkerPool::WorkerPool(unsigned int threadCount)
+        : m_task(nullptr),
+          m_taskCount(0U),
+          m_nextTask(0U),
+          m_batch(0U),
+          m_busyWorkers(0U),
+          m_stop(false)
+    {
+        if (threadCount == 0U)
+        {
+            threadCount = std::thread::hardware_concurrency();
+        }
+
+        // The calling thread is the first one
+        for (unsigned int i = 1U; i < threadCount; ++i)
+        {
+            m_threads.push_back(std::thread(&WorkerPool::WorkerLoop, this));
+        }
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_startCondition.notify_all();
+
+        for (std::thread &thread : m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    unsigned int WorkerPool::GetThreadCount() const
+    {
+        return static_cast<unsigned int>(m_threads.size()) + 1U;
+    }
+
+    void WorkerPool::Run(unsigned int taskCount, const std::function<void(unsigned int)> &task)
+    {
+        if (taskCount == 0U)
+        {
+            return;
+        }
+
+        // Not worth waking up the workers
+        if (taskCount == 1U or m_threads.empty())
+        {
+            for (unsigned int i = 0U; i < taskCount; ++i)
+            {
+                task(i);
+            }
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_task = &task;
+            m_taskCount = taskCount;
+            m_nextTask.store(0U);
+            m_busyWorkers = static_cast<unsigned int>(m_threads.size());
+            ++m_batch;
+        }
+        m_startCondition.notify_all();
+
+        RunTasks();
+
+        // Wait for the workers that are still running their last task
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCondition.wait(lock, [this]() { return m_busyWorkers == 0U; });
+        m_task = nullptr;
+    }
+
+    void WorkerPool::WorkerLoop()
+    {
+        unsigned int batch = 0U;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_startCondition.wait(lock, [this, batch]() { return m_stop or m_batch != batch; });
+
+                if (m_stop)
+                {
+                    return;
+                }
+                batch = m_batch;
+            }
+
+            RunTasks();
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                --m_busyWorkers;
+            }
+            m_doneCondition.notify_one();
+        }
+    }
+
+    void WorkerPool::RunTasks()
+    {
+        const std::function<void(unsigned int)> &task = *m_task;
+
+        for (unsigned int i = m_nextTask.fetch_add(1U); i < m_taskCount; i = m_nextTask.fetch_add(1U))
+        {
+            task(i);
+        }
+    }
+}
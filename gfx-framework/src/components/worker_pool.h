@@ -0,0 +1,57 @@
+#ifndef GFXC_WORKER_POOL_H
+#define GFXC_WORKER_POOL_H
+
+#include "components/exports.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace gfxc
+{
+    // A fixed set of worker threads that run batches of tasks. The calling
+    // thread takes part in every batch and Run() only returns after all the
+    // tasks of the batch are done, so consecutive calls are separated by a
+    // barrier.
+    class GFXC_API WorkerPool
+    {
+     public:
+        // The thread count includes the calling thread. Zero means one
+        // thread for every hardware thread.
+        explicit WorkerPool(unsigned int threadCount = 0U);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool &) = delete;
+        WorkerPool& operator=(const WorkerPool &) = delete;
+
+        unsigned int GetThreadCount() const;
+
+        // Calls task(i) once for every i in [0, taskCount)
+        void Run(unsigned int taskCount, const std::function<void(unsigned int)> &task);
+
+     private:
+        void WorkerLoop();
+        void RunTasks();
+
+     private:
+        std::vector<std::thread>        m_threads;
+
+        std::mutex                      m_mutex;
+        std::condition_variable         m_startCondition;
+        std::condition_variable         m_doneCondition;
+
+        // State of the current batch
+        const std::function<void(unsigned int)> *m_task;
+        unsigned int                    m_taskCount;
+        std::atomic<unsigned int>       m_nextTask;
+        unsigned int                    m_batch;
+        unsigned int                    m_busyWorkers;
+        bool                            m_stop;
+    };
+}
+
+#endif
@@ -0,0 +1,32 @@
+#include "core/command_list.h"
+
+
+void CommandList::Record(const std::function<void()> &command)
+{
+    commands.push_back(command);
+}
+
+
+void CommandList::Execute() const
+{
+    for (const std::function<void()> &command : commands)
+        command();
+}
+
+
+void CommandList::Clear()
+{
+    commands.clear();
+}
+
+
+unsigned int CommandList::GetSize() const
+{
+    return static_cast<unsigned int>(commands.size());
+}
+
+
+bool CommandList::IsEmpty() const
+{
+    return commands.empty();
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+
+// Commands recorded by the update thread and executed later, in the same
+// order, by the render thread (see RenderThread and World::Submit). A
+// command captures by value the state it needs, since the update thread
+// moves on to the next frame before the command runs.
+class CommandList
+{
+ public:
+    void Record(const std::function<void()> &command);
+    void Execute() const;
+
+    // Also releases what the commands captured. The storage is kept for the
+    // next frame.
+    void Clear();
+
+    unsigned int GetSize() const;
+    bool IsEmpty() const;
+
+ private:
+    std::vector<std::function<void()>> commands;
+};
@@ -0,0 +1,169 @@
+#include "core/cpu_profiler.h"
+
+#if defined(WITH_PROFILER)
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+
+struct ProfilerEvent
+{
+    const char *name;
+    uint64_t start;
+    uint64_t duration;
+};
+
+
+// Written by one thread only. The count is published after the event,
+// so readers never see a partial event.
+struct ProfilerChunk
+{
+    static const unsigned int kCapacity = 4096U;
+
+    ProfilerEvent events[kCapacity];
+    std::atomic<unsigned int> count;
+    std::atomic<ProfilerChunk*> next;
+
+    ProfilerChunk()
+        : count(0), next(nullptr)
+    {
+    }
+};
+
+
+struct ProfilerThreadBuffer
+{
+    unsigned int threadID;
+    ProfilerChunk *first;
+    ProfilerChunk *last;
+    ProfilerThreadBuffer *next;
+};
+
+
+static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+// Buffers of all threads, pushed at the front when a thread records its
+// first zone
+static std::atomic<ProfilerThreadBuffer*> threadBuffers(nullptr);
+static std::atomic<unsigned int> threadCount(0);
+
+static thread_local ProfilerThreadBuffer *localBuffer = nullptr;
+
+static std::string exitTracePath;
+
+
+static ProfilerThreadBuffer* CreateThreadBuffer()
+{
+    ProfilerThreadBuffer *buffer = new ProfilerThreadBuffer();
+    buffer->threadID = threadCount.fetch_add(1);
+    buffer->first = new ProfilerChunk();
+    buffer->last = buffer->first;
+    buffer->next = threadBuffers.load();
+
+    while (!threadBuffers.compare_exchange_weak(buffer->next, buffer))
+    {
+    }
+
+    return buffer;
+}
+
+
+CpuProfiler::Zone::Zone(const char *name)
+    : name(name), start(CpuProfiler::Now())
+{
+}
+
+
+CpuProfiler::Zone::~Zone()
+{
+    CpuProfiler::Record(name, start, CpuProfiler::Now());
+}
+
+
+uint64_t CpuProfiler::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+
+void CpuProfiler::Record(const char *name, uint64_t start, uint64_t end)
+{
+    if (!localBuffer)
+        localBuffer = CreateThreadBuffer();
+
+    ProfilerChunk *chunk = localBuffer->last;
+    unsigned int count = chunk->count.load(std::memory_order_relaxed);
+
+    if (count == ProfilerChunk::kCapacity)
+    {
+        ProfilerChunk *next = new ProfilerChunk();
+        chunk->next.store(next, std::memory_order_release);
+        localBuffer->last = next;
+
+        chunk = next;
+        count = 0;
+    }
+
+    ProfilerEvent &event = chunk->events[count];
+    event.name = name;
+    event.start = start;
+    event.duration = end - start;
+    chunk->count.store(count + 1, std::memory_order_release);
+}
+
+
+bool CpuProfiler::WriteTrace(const std::string &path)
+{
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+
+    // Complete events, with times in microseconds
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    bool firstEvent = true;
+    for (ProfilerThreadBuffer *buffer = threadBuffers.load(); buffer; buffer = buffer->next)
+    {
+        for (ProfilerChunk *chunk = buffer->first; chunk; chunk = chunk->next.load(std::memory_order_acquire))
+        {
+            const unsigned int count = chunk->count.load(std::memory_order_acquire);
+            for (unsigned int i = 0; i < count; i++)
+            {
+                const ProfilerEvent &event = chunk->events[i];
+                fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                        firstEvent ? "" : ",", event.name, buffer->threadID, event.start / 1e3, event.duration / 1e3);
+                firstEvent = false;
+            }
+        }
+    }
+
+    fprintf(file, "\n]}\n");
+    return fclose(file) == 0;
+}
+
+
+void CpuProfiler::SetExitTracePath(const std::string &path)
+{
+    exitTracePath = path;
+}
+
+
+const std::string& CpuProfiler::GetExitTracePath()
+{
+    return exitTracePath;
+}
+
+
+unsigned int CpuProfiler::GetEventCount()
+{
+    unsigned int eventCount = 0;
+    for (ProfilerThreadBuffer *buffer = threadBuffers.load(); buffer; buffer = buffer->next)
+    {
+        for (ProfilerChunk *chunk = buffer->first; chunk; chunk = chunk->next.load(std::memory_order_acquire))
+            eventCount += chunk->count.load(std::memory_order_acquire);
+    }
+    return eventCount;
+}
+
+#endif
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+
+// CPU profiler of named zones, written as a Chrome trace that can be opened
+// in chrome://tracing or in Perfetto. Zones are only compiled in with
+// WITH_PROFILER; otherwise PROFILE_ZONE expands to nothing and the profiler
+// is not built at all.
+//
+//      void Mesh::LoadMesh(...)
+//      {
+//          PROFILE_ZONE("Mesh::LoadMesh");
+//          ...
+//      }
+//
+// Each thread records into its own buffer, without locks: the buffer is a
+// list of fixed size chunks, published to readers with atomics, so a trace
+// can be written while other threads are still recording. Buffers are kept
+// until the program exits. Zone names must outlive the profiler, which is
+// the case for string literals.
+#if defined(WITH_PROFILER)
+#   define PROFILE_CONCAT_IMPL(a, b)    a##b
+#   define PROFILE_CONCAT(a, b)         PROFILE_CONCAT_IMPL(a, b)
+#   define PROFILE_ZONE(name)           CpuProfiler::Zone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#else
+#   define PROFILE_ZONE(name)
+#endif
+
+
+#if defined(WITH_PROFILER)
+
+class CpuProfiler
+{
+ public:
+    // Records the time between its construction and its destruction
+    class Zone
+    {
+     public:
+        explicit Zone(const char *name);
+        ~Zone();
+
+        Zone(const Zone &) = delete;
+        Zone& operator=(const Zone &) = delete;
+
+     private:
+        const char *name;
+        uint64_t start;
+    };
+
+ public:
+    // Nanoseconds since the program started
+    static uint64_t Now();
+
+    static void Record(const char *name, uint64_t start, uint64_t end);
+
+    // Writes the zones recorded so far by all threads
+    static bool WriteTrace(const std::string &path);
+
+    // Trace written by Engine::Exit, if not empty
+    static void SetExitTracePath(const std::string &path);
+    static const std::string& GetExitTracePath();
+
+    static unsigned int GetEventCount();
+};
+
+#endif
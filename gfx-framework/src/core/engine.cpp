@@ -1,24 +1,41 @@
 #include "core/engine.h"
 
+#include <chrono>
 #include <iostream>
 
+#include "core/cpu_profiler.h"
+#include "core/job_system.h"
 #include "core/managers/texture_manager.h"
 #include "utils/gl_utils.h"
 
 
 WindowObject* Engine::window = nullptr;
+JobSystem* Engine::jobSystem = nullptr;
+
+// Start of the clock used without GLFW, in headless mode
+static std::chrono::steady_clock::time_point startTime;
+
+
+// GLEW built for GLX returns this error from glewInit() when the current
+// context is not a GLX one, after it has loaded the OpenGL entry points.
+// The value is missing from older headers.
+static const GLenum kGlewErrorNoGlxDisplay = 4;
 
 
 WindowObject* Engine::Init(const WindowProperties & props)
 {
-    /* Initialize the library */
-    if (!glfwInit())
+    /* Initialize the library. Headless mode does not need a display. */
+    if (props.headless)
+        startTime = std::chrono::steady_clock::now();
+    else if (!glfwInit())
         exit(0);
 
     window = new WindowObject(props);
 
     glewExperimental = true;
     GLenum err = glewInit();
+    if (props.headless && err == kGlewErrorNoGlxDisplay)
+        err = GLEW_OK;
     if (GLEW_OK != err)
     {
         // Serious problem
@@ -28,6 +45,8 @@ WindowObject* Engine::Init(const WindowProperties & props)
 
     TextureManager::Init(window->props.selfDir);
 
+    jobSystem = new JobSystem();
+
     return window;
 }
 
@@ -38,15 +57,40 @@ WindowObject* Engine::GetWindow()
 }
 
 
+JobSystem* Engine::GetJobSystem()
+{
+    return jobSystem;
+}
+
+
 void Engine::Exit()
 {
     std::cout << "=====================================================" << std::endl;
     std::cout << "Engine closed. Exit" << std::endl;
+
+    // Runs the jobs still queued, the main thread ones included, while the
+    // OpenGL context still exists
+    delete jobSystem;
+    jobSystem = nullptr;
+
+#if defined(WITH_PROFILER)
+    const std::string &tracePath = CpuProfiler::GetExitTracePath();
+    if (!tracePath.empty() && !CpuProfiler::WriteTrace(tracePath))
+        std::cerr << "Cannot write the trace " << tracePath << std::endl;
+#endif
+
+    if (window && window->props.headless)
+        return;
     glfwTerminate();
 }
 
 
 double Engine::GetElapsedTime()
 {
+    if (window && window->props.headless)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
     return glfwGetTime();
 }
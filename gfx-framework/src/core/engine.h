@@ -7,6 +7,9 @@
 #include "core/window/window_object.h"
 
 
+class JobSystem;
+
+
 class Engine
 {
  public:
@@ -14,6 +17,10 @@ class Engine
 
     static WindowObject* GetWindow();
 
+    // Worker threads shared by the engine and the scenes, created by Init
+    // on the calling thread, which runs the main thread jobs
+    static JobSystem* GetJobSystem();
+
     // Get elapsed time in seconds since the application started
     static double GetElapsedTime();
 
@@ -21,4 +28,5 @@ class Engine
 
  private:
     static WindowObject* window;
+    static JobSystem* jobSystem;
 };
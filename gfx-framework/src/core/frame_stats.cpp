@@ -0,0 +1,103 @@
+#include "core/frame_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+
+static double Percentile(const std::vector<double> &sorted, double percent)
+{
+    // Nearest rank, 1-based
+    size_t rank = static_cast<size_t>(std::ceil(percent / 100 * sorted.size()));
+    rank = std::min(std::max(rank, static_cast<size_t>(1)), sorted.size());
+    return sorted[rank - 1];
+}
+
+
+FrameStats frame_stats::Compute(const std::vector<double> &samples)
+{
+    FrameStats stats = {};
+    if (samples.empty())
+        return stats;
+
+    std::vector<double> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+
+    double sum = 0;
+    for (double sample : sorted)
+        sum += sample;
+
+    stats.min = sorted.front();
+    stats.avg = sum / sorted.size();
+    stats.p50 = Percentile(sorted, 50);
+    stats.p95 = Percentile(sorted, 95);
+    stats.p99 = Percentile(sorted, 99);
+    stats.max = sorted.back();
+    return stats;
+}
+
+
+static void WriteJsonSeries(FILE *file, const char *name, const std::vector<double> &samples, bool last)
+{
+    const FrameStats stats = frame_stats::Compute(samples);
+
+    fprintf(file, "  \"%s\": {\n", name);
+    fprintf(file, "    \"min\": %.6f,\n    \"avg\": %.6f,\n", stats.min, stats.avg);
+    fprintf(file, "    \"p50\": %.6f,\n    \"p95\": %.6f,\n    \"p99\": %.6f,\n", stats.p50, stats.p95, stats.p99);
+    fprintf(file, "    \"max\": %.6f,\n", stats.max);
+    fprintf(file, "    \"samples\": [");
+    for (size_t i = 0; i < samples.size(); i++)
+        fprintf(file, "%s%.6f", i ? ", " : "", samples[i]);
+    fprintf(file, "]\n  }%s\n", last ? "" : ",");
+}
+
+
+static void WriteJson(FILE *file, const std::string &scene, double deltaTime,
+                      const std::vector<double> &cpuTimes, const std::vector<double> &gpuTimes)
+{
+    std::string escaped;
+    for (char c : scene)
+    {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+
+    fprintf(file, "{\n");
+    fprintf(file, "  \"scene\": \"%s\",\n", escaped.c_str());
+    fprintf(file, "  \"deltaTime\": %.6f,\n", deltaTime);
+    fprintf(file, "  \"frames\": %u,\n", static_cast<unsigned int>(cpuTimes.size()));
+    WriteJsonSeries(file, "cpu_ms", cpuTimes, false);
+    WriteJsonSeries(file, "gpu_ms", gpuTimes, true);
+    fprintf(file, "}\n");
+}
+
+
+static void WriteCsv(FILE *file, const std::vector<double> &cpuTimes, const std::vector<double> &gpuTimes)
+{
+    fprintf(file, "frame,cpu_ms,gpu_ms\n");
+    for (size_t i = 0; i < cpuTimes.size(); i++)
+    {
+        fprintf(file, "%u,%.6f,", static_cast<unsigned int>(i), cpuTimes[i]);
+        if (i < gpuTimes.size())
+            fprintf(file, "%.6f", gpuTimes[i]);
+        fprintf(file, "\n");
+    }
+}
+
+
+bool frame_stats::Write(const std::string &path, const std::string &scene, double deltaTime,
+                        const std::vector<double> &cpuTimes, const std::vector<double> &gpuTimes)
+{
+    FILE *file = fopen(path.c_str(), "w");
+    if (!file)
+        return false;
+
+    const std::string extension = ".json";
+    const bool json = path.size() >= extension.size()
+        && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+
+    json ? WriteJson(file, scene, deltaTime, cpuTimes, gpuTimes) : WriteCsv(file, cpuTimes, gpuTimes);
+
+    return fclose(file) == 0;
+}
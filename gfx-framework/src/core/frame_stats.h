@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+
+// Summary of a series of frame time samples, in milliseconds. Percentiles
+// use the nearest rank.
+struct FrameStats
+{
+    double min;
+    double avg;
+    double p50;
+    double p95;
+    double p99;
+    double max;
+};
+
+
+namespace frame_stats
+{
+    // All zero when there are no samples
+    FrameStats Compute(const std::vector<double> &samples);
+
+    // Writes the CPU and GPU frame times. The format is picked from the
+    // extension of `path`: JSON for `.json`, with the stats and the samples,
+    // CSV otherwise, with one row of samples per frame and no stats, so that
+    // every row matches the header. GPU times may be empty, when timer
+    // queries are not available.
+    bool Write(const std::string &path, const std::string &scene, double deltaTime,
+               const std::vector<double> &cpuTimes, const std::vector<double> &gpuTimes);
+}
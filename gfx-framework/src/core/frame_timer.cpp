@@ -0,0 +1,99 @@
+#include "core/frame_timer.h"
+
+
+FrameTimer::FrameTimer()
+{
+    queryCount = 0;
+    readCount = 0;
+
+    glGenQueries(kQueryLatency, queries);
+    CheckOpenGLError();
+}
+
+
+FrameTimer::~FrameTimer()
+{
+    glDeleteQueries(kQueryLatency, queries);
+}
+
+
+void FrameTimer::BeginFrame()
+{
+    BeginGpuFrame();
+    BeginCpuFrame();
+}
+
+
+void FrameTimer::EndFrame()
+{
+    EndGpuFrame();
+    EndCpuFrame();
+}
+
+
+void FrameTimer::BeginCpuFrame()
+{
+    frameStart = std::chrono::steady_clock::now();
+}
+
+
+void FrameTimer::EndCpuFrame()
+{
+    const std::chrono::duration<double, std::milli> cpuTime = std::chrono::steady_clock::now() - frameStart;
+    cpuTimes.push_back(cpuTime.count());
+}
+
+
+void FrameTimer::BeginGpuFrame()
+{
+    // Reuses the query of the frame kQueryLatency frames ago, so its result
+    // has to be read first. It is usually available by now.
+    if (queryCount - readCount == kQueryLatency)
+        ReadQuery(readCount);
+
+    glBeginQuery(GL_TIME_ELAPSED, queries[queryCount % kQueryLatency]);
+}
+
+
+void FrameTimer::EndGpuFrame()
+{
+    glEndQuery(GL_TIME_ELAPSED);
+    queryCount++;
+}
+
+
+void FrameTimer::Finish()
+{
+    while (readCount < queryCount)
+        ReadQuery(readCount);
+}
+
+
+void FrameTimer::Reset()
+{
+    Finish();
+    cpuTimes.clear();
+    gpuTimes.clear();
+}
+
+
+const std::vector<double>& FrameTimer::GetCpuTimes() const
+{
+    return cpuTimes;
+}
+
+
+const std::vector<double>& FrameTimer::GetGpuTimes() const
+{
+    return gpuTimes;
+}
+
+
+void FrameTimer::ReadQuery(unsigned int frame)
+{
+    // Waits for the result if the GPU has not finished the frame yet
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v(queries[frame % kQueryLatency], GL_QUERY_RESULT, &nanoseconds);
+    gpuTimes.push_back(nanoseconds / 1e6);
+    readCount++;
+}
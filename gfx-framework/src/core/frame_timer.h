@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+#include "utils/gl_utils.h"
+
+
+// Records the CPU and GPU time of each frame, in milliseconds. The CPU time
+// is the wall time between BeginFrame and EndFrame. The GPU time is measured
+// with GL_TIME_ELAPSED queries, which are read a few frames later so that
+// the measurement does not wait for the GPU; Finish() reads the last ones.
+//
+// With a render thread, the CPU and the GPU parts are recorded separately:
+// the CPU time on the update thread, where it includes the wait for the
+// render thread, and the queries on the render thread.
+class FrameTimer
+{
+ public:
+    // Frames in flight before the query of a frame is read back
+    static const unsigned int kQueryLatency = 4U;
+
+    FrameTimer();
+    ~FrameTimer();
+
+    FrameTimer(const FrameTimer &) = delete;
+    FrameTimer& operator=(const FrameTimer &) = delete;
+
+    void BeginFrame();
+    void EndFrame();
+
+    void BeginCpuFrame();
+    void EndCpuFrame();
+    void BeginGpuFrame();
+    void EndGpuFrame();
+
+    // Waits for the queries still in flight
+    void Finish();
+
+    // Drops the samples recorded so far, for example after warm-up frames
+    void Reset();
+
+    const std::vector<double>& GetCpuTimes() const;
+    const std::vector<double>& GetGpuTimes() const;
+
+ private:
+    void ReadQuery(unsigned int frame);
+
+ private:
+    GLuint queries[kQueryLatency];
+    unsigned int queryCount;
+    unsigned int readCount;
+
+    std::chrono::steady_clock::time_point frameStart;
+    std::vector<double> cpuTimes;
+    std::vector<double> gpuTimes;
+};
@@ -0,0 +1,103 @@
+#include "core/gpu/camera_uniform_buffer.h"
+
+#include <cstddef>
+
+#include "components/camera.h"
+#include "components/transform.h"
+
+
+// The struct is uploaded as is, so it must match the std140 layout
+static_assert(offsetof(CameraUniforms, view) == 0, "std140 layout mismatch");
+static_assert(offsetof(CameraUniforms, projection) == 64, "std140 layout mismatch");
+static_assert(offsetof(CameraUniforms, viewProjection) == 128, "std140 layout mismatch");
+static_assert(offsetof(CameraUniforms, eyePosition) == 192, "std140 layout mismatch");
+static_assert(offsetof(CameraUniforms, clipPlanes) == 208, "std140 layout mismatch");
+static_assert(offsetof(CameraUniforms, resolution) == 216, "std140 layout mismatch");
+static_assert(sizeof(CameraUniforms) == 224, "std140 layout mismatch");
+
+
+const char *const CameraUniformBuffer::kBlockName = "CameraBlock";
+
+
+CameraUniformBuffer::CameraUniformBuffer()
+{
+    isValid = false;
+    uploadCount = 0;
+
+    glGenBuffers(1, &ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraUniforms), NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    BindBuffer();
+}
+
+
+CameraUniformBuffer::~CameraUniformBuffer()
+{
+    glDeleteBuffers(1, &ubo);
+}
+
+
+bool CameraUniformBuffer::Update(const gfxc::Camera &camera, const glm::ivec2 &resolution)
+{
+    const glm::mat4 &view = camera.GetViewMatrix();
+    const glm::mat4 &projection = camera.GetProjectionMatrix();
+    const glm::vec2 size(resolution);
+
+    // The eye position and the clip planes follow the matrices, so these
+    // are enough to tell if anything changed
+    if (isValid && view == uniforms.view && projection == uniforms.projection && size == uniforms.resolution)
+        return false;
+
+    return Update(Capture(camera, resolution));
+}
+
+
+bool CameraUniformBuffer::Update(const CameraUniforms &cameraUniforms)
+{
+    if (isValid && cameraUniforms.view == uniforms.view && cameraUniforms.projection == uniforms.projection
+        && cameraUniforms.resolution == uniforms.resolution)
+        return false;
+
+    uniforms = cameraUniforms;
+
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraUniforms), &uniforms);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    isValid = true;
+    uploadCount++;
+    return true;
+}
+
+
+void CameraUniformBuffer::BindBuffer() const
+{
+    glBindBufferBase(GL_UNIFORM_BUFFER, kBindingPoint, ubo);
+}
+
+
+CameraUniforms CameraUniformBuffer::Capture(const gfxc::Camera &camera, const glm::ivec2 &resolution)
+{
+    CameraUniforms capture;
+    capture.view = camera.GetViewMatrix();
+    capture.projection = camera.GetProjectionMatrix();
+    capture.viewProjection = capture.projection * capture.view;
+    capture.eyePosition = glm::vec4(camera.m_transform->GetWorldPosition(), 1);
+    capture.clipPlanes = glm::vec2(camera.m_zNear, camera.m_zFar);
+    capture.resolution = glm::vec2(resolution);
+    return capture;
+}
+
+
+const CameraUniforms& CameraUniformBuffer::GetUniforms() const
+{
+    return uniforms;
+}
+
+
+unsigned int CameraUniformBuffer::GetUploadCount() const
+{
+    return uploadCount;
+}
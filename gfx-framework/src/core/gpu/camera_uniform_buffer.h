@@ -0,0 +1,70 @@
+#pragma once
+
+#include "utils/gl_utils.h"
+#include "utils/glm_utils.h"
+
+
+namespace gfxc
+{
+    class Camera;
+}
+
+
+// Camera data shared by all the shaders of a frame, with the std140 layout
+// of the uniform block declared in assets/shaders/MVP.CameraBlock.VS.glsl:
+//
+//      layout(std140) uniform CameraBlock
+//      {
+//          mat4 View;
+//          mat4 Projection;
+//          mat4 ViewProjection;
+//          vec4 EyePosition;       // w is unused
+//          vec2 ClipPlanes;        // zNear, zFar
+//          vec2 Resolution;
+//      };
+struct CameraUniforms
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProjection;
+    glm::vec4 eyePosition;
+    glm::vec2 clipPlanes;
+    glm::vec2 resolution;
+};
+
+
+// Uniform buffer holding the CameraUniforms of a camera, bound at a fixed
+// binding point. Shaders that declare the block are bound to the same
+// point when they are linked (see Shader::UsesCameraBlock), so drawing
+// with them only needs the model data to be set per draw.
+class CameraUniformBuffer
+{
+ public:
+    static const GLuint kBindingPoint = 0U;
+    static const char *const kBlockName;
+
+    CameraUniformBuffer();
+    ~CameraUniformBuffer();
+
+    CameraUniformBuffer(const CameraUniformBuffer &) = delete;
+    CameraUniformBuffer& operator=(const CameraUniformBuffer &) = delete;
+
+    // Uploads the camera data, only if it changed since the last upload.
+    // Returns true if the buffer was updated.
+    bool Update(const gfxc::Camera &camera, const glm::ivec2 &resolution);
+    bool Update(const CameraUniforms &cameraUniforms);
+
+    // Data of the camera at the time of the call, for commands that are
+    // run later on the render thread (see World::Submit)
+    static CameraUniforms Capture(const gfxc::Camera &camera, const glm::ivec2 &resolution);
+    void BindBuffer() const;
+
+    const CameraUniforms& GetUniforms() const;
+    unsigned int GetUploadCount() const;
+
+ private:
+    GLuint ubo;
+    CameraUniforms uniforms;
+    bool isValid;
+    unsigned int uploadCount;
+};
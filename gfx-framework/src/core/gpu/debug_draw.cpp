@@ -0,0 +1,170 @@
+#include "core/gpu/debug_draw.h"
+
+#include <cmath>
+
+
+// Pairs of corners joined by the edges of a box, with the corners numbered
+// by their x, y and z bits
+static const unsigned int kBoxEdges[12][2] = {
+    { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 },
+    { 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 },
+    { 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 },
+};
+
+
+DebugDraw::DebugDraw()
+{
+}
+
+
+void DebugDraw::AddPoint(const glm::vec3 &position, const glm::vec3 &color)
+{
+    DebugVertex vertex = { position, color };
+    streams[POINTS].push_back(vertex);
+}
+
+
+void DebugDraw::AddLine(const glm::vec3 &from, const glm::vec3 &to, const glm::vec3 &color, bool thick)
+{
+    std::vector<DebugVertex> &stream = streams[thick ? THICK_LINES : LINES];
+
+    DebugVertex vertex = { from, color };
+    stream.push_back(vertex);
+    vertex.position = to;
+    stream.push_back(vertex);
+}
+
+
+void DebugDraw::AddBox(const glm::vec3 &min, const glm::vec3 &max, const glm::vec3 &color)
+{
+    glm::vec3 corners[8];
+    for (unsigned int i = 0; i < 8; i++)
+    {
+        corners[i] = glm::vec3((i & 1) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 4) ? max.z : min.z);
+    }
+    AddEdges(corners, color);
+}
+
+
+void DebugDraw::AddBox(const glm::mat4 &model, const glm::vec3 &color)
+{
+    glm::vec3 corners[8];
+    for (unsigned int i = 0; i < 8; i++)
+    {
+        const glm::vec4 corner((i & 1) ? 0.5f : -0.5f, (i & 2) ? 0.5f : -0.5f, (i & 4) ? 0.5f : -0.5f, 1);
+        corners[i] = glm::vec3(model * corner);
+    }
+    AddEdges(corners, color);
+}
+
+
+void DebugDraw::AddSphere(const glm::vec3 &center, float radius, const glm::vec3 &color)
+{
+    // Points of the unit circle, computed once
+    static const std::vector<glm::vec2> circle = []()
+    {
+        std::vector<glm::vec2> points(kCircleSegments + 1);
+        for (unsigned int i = 0; i <= kCircleSegments; i++)
+        {
+            const float angle = glm::two_pi<float>() * i / kCircleSegments;
+            points[i] = glm::vec2(std::cos(angle), std::sin(angle));
+        }
+        return points;
+    }();
+
+    std::vector<DebugVertex> &stream = streams[LINES];
+    stream.reserve(stream.size() + 3 * 2 * kCircleSegments);
+
+    for (unsigned int i = 0; i < kCircleSegments; i++)
+    {
+        const glm::vec2 a = radius * circle[i];
+        const glm::vec2 b = radius * circle[i + 1];
+
+        AddLine(center + glm::vec3(0, a.x, a.y), center + glm::vec3(0, b.x, b.y), color);
+        AddLine(center + glm::vec3(a.x, 0, a.y), center + glm::vec3(b.x, 0, b.y), color);
+        AddLine(center + glm::vec3(a.x, a.y, 0), center + glm::vec3(b.x, b.y, 0), color);
+    }
+}
+
+
+void DebugDraw::AddFrustum(const glm::mat4 &viewProjection, const glm::vec3 &color)
+{
+    const glm::mat4 inverse = glm::inverse(viewProjection);
+
+    glm::vec3 corners[8];
+    for (unsigned int i = 0; i < 8; i++)
+    {
+        const glm::vec4 corner = inverse * glm::vec4((i & 1) ? 1 : -1, (i & 2) ? 1 : -1, (i & 4) ? 1 : -1, 1);
+        corners[i] = glm::vec3(corner) / corner.w;
+    }
+    AddEdges(corners, color);
+}
+
+
+void DebugDraw::AddAxes(const glm::mat4 &model, float length, bool thick)
+{
+    const glm::vec3 origin(model[3]);
+    AddLine(origin, origin + length * glm::vec3(model[0]), glm::vec3(1, 0, 0), thick);
+    AddLine(origin, origin + length * glm::vec3(model[1]), glm::vec3(0, 1, 0), thick);
+    AddLine(origin, origin + length * glm::vec3(model[2]), glm::vec3(0, 0, 1), thick);
+}
+
+
+void DebugDraw::AddGrid(const glm::vec3 &center, unsigned int halfCells, float cellSize, const glm::vec3 &color)
+{
+    std::vector<DebugVertex> &stream = streams[LINES];
+    stream.reserve(stream.size() + 2 * 2 * (2 * halfCells + 1));
+
+    const float extent = halfCells * cellSize;
+    for (unsigned int i = 0; i <= 2 * halfCells; i++)
+    {
+        const float offset = i * cellSize - extent;
+        AddLine(center + glm::vec3(offset, 0, -extent), center + glm::vec3(offset, 0, extent), color);
+        AddLine(center + glm::vec3(-extent, 0, offset), center + glm::vec3(extent, 0, offset), color);
+    }
+}
+
+
+void DebugDraw::Clear()
+{
+    for (std::vector<DebugVertex> &stream : streams)
+    {
+        stream.clear();
+    }
+}
+
+
+bool DebugDraw::IsEmpty() const
+{
+    return GetVertexCount() == 0;
+}
+
+
+const std::vector<DebugVertex>& DebugDraw::GetVertices(Stream stream) const
+{
+    return streams[stream];
+}
+
+
+unsigned int DebugDraw::GetVertexCount() const
+{
+    std::size_t count = 0;
+    for (const std::vector<DebugVertex> &stream : streams)
+    {
+        count += stream.size();
+    }
+    return static_cast<unsigned int>(count);
+}
+
+
+void DebugDraw::AddEdges(const glm::vec3 *corners, const glm::vec3 &color)
+{
+    std::vector<DebugVertex> &stream = streams[LINES];
+    for (const unsigned int *edge : kBoxEdges)
+    {
+        DebugVertex vertex = { corners[edge[0]], color };
+        stream.push_back(vertex);
+        vertex.position = corners[edge[1]];
+        stream.push_back(vertex);
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+
+#include "utils/glm_utils.h"
+
+
+// Vertex of the debug streams, in world space. The color is read by the
+// shaders at location 3, like the color of VertexFormat.
+struct DebugVertex
+{
+    glm::vec3 position;
+    glm::vec3 color;
+};
+
+
+// Accumulates debug shapes during a frame, as vertices in world space, so
+// that they can be uploaded at once and drawn with one call per stream
+// (see DebugDrawBuffer and SimpleScene::FlushDebugDraw). Shapes are drawn
+// as wireframes. The streams are cleared by Clear(), usually after they
+// are drawn.
+class DebugDraw
+{
+ public:
+    enum Stream
+    {
+        POINTS,
+        LINES,
+        THICK_LINES,
+        STREAM_COUNT,
+    };
+
+    // Segments of the circles of AddSphere
+    static const unsigned int kCircleSegments = 24U;
+
+    DebugDraw();
+
+    void AddPoint(const glm::vec3 &position, const glm::vec3 &color);
+    void AddLine(const glm::vec3 &from, const glm::vec3 &to, const glm::vec3 &color, bool thick = false);
+
+    // Axis aligned box, or a unit cube centered at the origin transformed
+    // by `model`
+    void AddBox(const glm::vec3 &min, const glm::vec3 &max, const glm::vec3 &color);
+    void AddBox(const glm::mat4 &model, const glm::vec3 &color);
+
+    // Three circles, one around each axis
+    void AddSphere(const glm::vec3 &center, float radius, const glm::vec3 &color);
+
+    // Volume seen through a view projection matrix, such as the frustum of
+    // a camera
+    void AddFrustum(const glm::mat4 &viewProjection, const glm::vec3 &color);
+
+    // X, Y and Z axes of `model`, in red, green and blue
+    void AddAxes(const glm::mat4 &model, float length, bool thick = false);
+
+    // Square grid in the XOZ plane, of `2 * halfCells` cells per side
+    void AddGrid(const glm::vec3 &center, unsigned int halfCells, float cellSize, const glm::vec3 &color);
+
+    void Clear();
+    bool IsEmpty() const;
+
+    const std::vector<DebugVertex>& GetVertices(Stream stream) const;
+    unsigned int GetVertexCount() const;
+
+ private:
+    void AddEdges(const glm::vec3 *corners, const glm::vec3 &color);
+
+ private:
+    std::vector<DebugVertex> streams[STREAM_COUNT];
+};
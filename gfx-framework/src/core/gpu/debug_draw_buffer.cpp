@@ -0,0 +1,79 @@
+#include "core/gpu/debug_draw_buffer.h"
+
+#include <cstddef>
+
+#include "core/gpu/render_stats.h"
+#include "utils/memory_utils.h"
+
+
+static const GLenum kStreamModes[DebugDraw::STREAM_COUNT] = { GL_POINTS, GL_LINES, GL_LINES };
+
+
+DebugDrawBuffer::DebugDrawBuffer()
+{
+    for (unsigned int i = 0; i < DebugDraw::STREAM_COUNT; i++)
+    {
+        first[i] = 0;
+        count[i] = 0;
+    }
+
+    vertexBuffer = new StreamingBuffer(sizeof(DebugVertex));
+
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+    vertexBuffer->Bind();
+
+    // Same locations as VertexFormat, so the VertexColor shader can be used
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (void*)offsetof(DebugVertex, position));
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (void*)offsetof(DebugVertex, color));
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    CheckOpenGLError();
+}
+
+
+DebugDrawBuffer::~DebugDrawBuffer()
+{
+    glDeleteVertexArrays(1, &vao);
+    SAFE_FREE(vertexBuffer);
+}
+
+
+void DebugDrawBuffer::Upload(const DebugDraw &debugDraw)
+{
+    vertexBuffer->Orphan(debugDraw.GetVertexCount());
+
+    unsigned int offset = 0;
+    for (unsigned int i = 0; i < DebugDraw::STREAM_COUNT; i++)
+    {
+        const std::vector<DebugVertex> &vertices = debugDraw.GetVertices(static_cast<DebugDraw::Stream>(i));
+
+        first[i] = offset;
+        count[i] = static_cast<unsigned int>(vertices.size());
+        vertexBuffer->SetData(offset, vertices.data(), count[i]);
+        offset += count[i];
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    CheckOpenGLError();
+}
+
+
+void DebugDrawBuffer::Draw(DebugDraw::Stream stream) const
+{
+    if (count[stream] == 0)
+        return;
+
+    glBindVertexArray(vao);
+    glDrawArrays(kStreamModes[stream], first[stream], count[stream]);
+    render_stats::AddDraw(kStreamModes[stream], count[stream]);
+}
+
+
+unsigned int DebugDrawBuffer::GetCapacity() const
+{
+    return vertexBuffer->GetCapacity();
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "core/gpu/debug_draw.h"
+#include "core/gpu/streaming_buffer.h"
+#include "utils/gl_utils.h"
+
+
+// Vertex buffer holding the streams of a DebugDraw, one after the other,
+// in a StreamingBuffer. Each stream is then drawn with one call.
+class DebugDrawBuffer
+{
+ public:
+    DebugDrawBuffer();
+    ~DebugDrawBuffer();
+
+    DebugDrawBuffer(const DebugDrawBuffer &) = delete;
+    DebugDrawBuffer& operator=(const DebugDrawBuffer &) = delete;
+
+    void Upload(const DebugDraw &debugDraw);
+
+    // Draws a stream of the last upload, with the current program and line
+    // width. Binds the vertex array of the buffer.
+    void Draw(DebugDraw::Stream stream) const;
+
+    unsigned int GetCapacity() const;
+
+ private:
+    GLuint vao;
+    StreamingBuffer *vertexBuffer;
+
+    unsigned int first[DebugDraw::STREAM_COUNT];
+    unsigned int count[DebugDraw::STREAM_COUNT];
+};
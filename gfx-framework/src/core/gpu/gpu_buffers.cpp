@@ -1,4 +1,5 @@
 #include "core/gpu/gpu_buffers.h"
+#include "core/gpu/render_stats.h"
 #include "core/gpu/vertex_format.h"
 
 
@@ -7,12 +8,15 @@ enum VERTEX_ATTRIBUTE_LOC
     POS,
     NORMAL,
     TEX_COORD,
+    COLOR,
+    TEXTURE_LAYER,
 };
 
 
 GPUBuffers::GPUBuffers()
 {
     m_size = 0;
+    m_memory = 0;
     m_VAO = 0;
     memset(m_VBO, 0, 6 * sizeof(int));
 }
@@ -30,13 +34,21 @@ void GPUBuffers::ReleaseMemory()
 {
     if (m_size)
     {
-        m_size = 0;
         glDeleteVertexArrays(1, &m_VAO);
         glDeleteBuffers(m_size, m_VBO);
+        m_size = 0;
+        SetGpuMemory(0);
     }
 }
 
 
+void GPUBuffers::SetGpuMemory(long long bytes)
+{
+    render_stats::AddBufferMemory(bytes - m_memory);
+    m_memory = bytes;
+}
+
+
 GPUBuffers gpu_utils::UploadData(const std::vector<glm::vec3> &positions,
                                  const std::vector<glm::vec3> &normals,
                                  const std::vector<unsigned int>& indices)
@@ -64,6 +76,10 @@ GPUBuffers gpu_utils::UploadData(const std::vector<glm::vec3> &positions,
 
     CheckOpenGLError();
 
+    buffers.SetGpuMemory(sizeof(positions[0]) * positions.size() +
+                         sizeof(normals[0]) * normals.size() +
+                         sizeof(indices[0]) * indices.size());
+
     return buffers;
 }
 
@@ -101,6 +117,60 @@ GPUBuffers gpu_utils::UploadData(const std::vector<glm::vec3> &positions,
     glBindVertexArray(0);
     CheckOpenGLError();
 
+    buffers.SetGpuMemory(sizeof(positions[0]) * positions.size() +
+                         sizeof(normals[0]) * normals.size() +
+                         sizeof(text_coords[0]) * text_coords.size() +
+                         sizeof(indices[0]) * indices.size());
+
+    return buffers;
+}
+
+
+GPUBuffers gpu_utils::UploadData(const std::vector<glm::vec3> &positions,
+                                 const std::vector<glm::vec3> &normals,
+                                 const std::vector<glm::vec2> &text_coords,
+                                 const std::vector<float> &texture_layers,
+                                 const std::vector<unsigned int> &indices)
+{
+    // Create the VAO
+    GPUBuffers buffers;
+    buffers.CreateBuffers(5);
+    glBindVertexArray(buffers.m_VAO);
+
+    // Generate and populate the buffers with vertex attributes and the indices
+    glBindBuffer(GL_ARRAY_BUFFER, buffers.m_VBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(positions[0]) * positions.size(), &positions[0], GL_STATIC_DRAW);
+    glEnableVertexAttribArray(VERTEX_ATTRIBUTE_LOC::POS);
+    glVertexAttribPointer(VERTEX_ATTRIBUTE_LOC::POS, 3, GL_FLOAT, GL_FALSE, 0, 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffers.m_VBO[1]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(normals[0]) * normals.size(), &normals[0], GL_STATIC_DRAW);
+    glEnableVertexAttribArray(VERTEX_ATTRIBUTE_LOC::NORMAL);
+    glVertexAttribPointer(VERTEX_ATTRIBUTE_LOC::NORMAL, 3, GL_FLOAT, GL_FALSE, 0, 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffers.m_VBO[2]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(text_coords[0]) * text_coords.size(), &text_coords[0], GL_STATIC_DRAW);
+    glEnableVertexAttribArray(VERTEX_ATTRIBUTE_LOC::TEX_COORD);
+    glVertexAttribPointer(VERTEX_ATTRIBUTE_LOC::TEX_COORD, 2, GL_FLOAT, GL_FALSE, 0, 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, buffers.m_VBO[3]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(texture_layers[0]) * texture_layers.size(), &texture_layers[0], GL_STATIC_DRAW);
+    glEnableVertexAttribArray(VERTEX_ATTRIBUTE_LOC::TEXTURE_LAYER);
+    glVertexAttribPointer(VERTEX_ATTRIBUTE_LOC::TEXTURE_LAYER, 1, GL_FLOAT, GL_FALSE, 0, 0);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers.m_VBO[4]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices[0]) * indices.size(), &indices[0], GL_STATIC_DRAW);
+
+    // Make sure the VAO is not changed from the outside
+    glBindVertexArray(0);
+    CheckOpenGLError();
+
+    buffers.SetGpuMemory(sizeof(positions[0]) * positions.size() +
+                         sizeof(normals[0]) * normals.size() +
+                         sizeof(text_coords[0]) * text_coords.size() +
+                         sizeof(texture_layers[0]) * texture_layers.size() +
+                         sizeof(indices[0]) * indices.size());
+
     return buffers;
 }
 
@@ -136,5 +206,8 @@ GPUBuffers gpu_utils::UploadData(const std::vector<VertexFormat> &vertices,
         glBindVertexArray(0);
         CheckOpenGLError();
 
+        buffers.SetGpuMemory(sizeof(vertices[0]) * vertices.size() +
+                             sizeof(indices[0]) * indices.size());
+
         return buffers;
     }
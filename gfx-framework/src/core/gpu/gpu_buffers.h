@@ -15,12 +15,16 @@ class GPUBuffers
     void CreateBuffers(unsigned int size);
     void ReleaseMemory();
 
+    // Size of the uploaded data, reported to render_stats
+    void SetGpuMemory(long long bytes);
+
  public:
     GLuint m_VAO;
     GLuint m_VBO[6];
 
  private:
     unsigned int m_size;
+    long long m_memory;
 };
 
 
@@ -35,6 +39,13 @@ namespace gpu_utils
                           const std::vector<glm::vec2> &text_coords,
                           const std::vector<unsigned int> &indices);
 
+    // The texture layer of each vertex is bound at location 4, see TextureArray
+    GPUBuffers UploadData(const std::vector<glm::vec3> &positions,
+                          const std::vector<glm::vec3> &normals,
+                          const std::vector<glm::vec2> &text_coords,
+                          const std::vector<float> &texture_layers,
+                          const std::vector<unsigned int> &indices);
+
     GPUBuffers UploadData(const std::vector<VertexFormat> &vertices,
                           const std::vector<unsigned int>& indices);
 }   // namespace gpu_utils
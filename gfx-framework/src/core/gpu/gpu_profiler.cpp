@@ -0,0 +1,241 @@
+#include "core/gpu/gpu_profiler.h"
+
+
+GpuProfiler::Scope::Scope(GpuProfiler *profiler, const std::string &name)
+    : profiler(profiler)
+{
+    if (profiler)
+        profiler->BeginScope(name);
+}
+
+
+GpuProfiler::Scope::~Scope()
+{
+    if (profiler)
+        profiler->EndScope();
+}
+
+
+GpuProfiler::GpuProfiler(unsigned int frameLatency, unsigned int averageFrames)
+{
+    frames.resize(frameLatency ? frameLatency : 1);
+    for (Frame &frame : frames)
+    {
+        frame.usedQueries = 0;
+        frame.pending = false;
+    }
+
+    currentFrame = 0;
+    this->averageFrames = averageFrames ? averageFrames : 1;
+    droppedFrames = 0;
+}
+
+
+GpuProfiler::~GpuProfiler()
+{
+    for (Frame &frame : frames)
+    {
+        if (!frame.queries.empty())
+            glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+    }
+}
+
+
+void GpuProfiler::BeginFrame()
+{
+    const unsigned int frameCount = static_cast<unsigned int>(frames.size());
+
+    ResolveCpu(frames[currentFrame]);
+    frames[currentFrame].pending = !frames[currentFrame].timings.empty();
+    openScopes.clear();
+
+    // Oldest first, so that the rolling averages see the frames in order
+    for (unsigned int i = 1; i <= frameCount; i++)
+    {
+        Frame &frame = frames[(currentFrame + i) % frameCount];
+        if (frame.pending && IsAvailable(frame))
+            Resolve(frame);
+    }
+
+    currentFrame = (currentFrame + 1) % frameCount;
+
+    // The GPU is more than the whole ring behind. Reading this frame would
+    // wait for it, so its results are dropped instead.
+    Frame &frame = frames[currentFrame];
+    if (frame.pending)
+    {
+        frame.pending = false;
+        droppedFrames++;
+    }
+
+    frame.usedQueries = 0;
+    frame.timings.clear();
+}
+
+
+void GpuProfiler::BeginScope(const std::string &name)
+{
+    auto it = scopeIndices.find(name);
+    if (it == scopeIndices.end())
+    {
+        RollingTime time;
+        time.lastMs = 0;
+        time.averageMs = 0;
+        time.historyNext = 0;
+        time.historySum = 0;
+
+        ScopeStats stats;
+        stats.name = name;
+        stats.gpu = time;
+        stats.cpu = time;
+
+        it = scopeIndices.emplace(name, static_cast<unsigned int>(scopes.size())).first;
+        scopes.push_back(stats);
+    }
+
+    Frame &frame = frames[currentFrame];
+
+    Timing timing;
+    timing.scope = it->second;
+    timing.beginQuery = frame.usedQueries;
+    timing.endQuery = frame.usedQueries;
+    timing.cpuMs = 0;
+    glQueryCounter(NextQuery(frame), GL_TIMESTAMP);
+    timing.cpuBegin = std::chrono::steady_clock::now();
+
+    openScopes.push_back(static_cast<unsigned int>(frame.timings.size()));
+    frame.timings.push_back(timing);
+}
+
+
+void GpuProfiler::EndScope()
+{
+    if (openScopes.empty())
+        return;
+
+    Frame &frame = frames[currentFrame];
+    Timing &timing = frame.timings[openScopes.back()];
+
+    timing.cpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - timing.cpuBegin).count();
+    timing.endQuery = frame.usedQueries;
+    glQueryCounter(NextQuery(frame), GL_TIMESTAMP);
+    openScopes.pop_back();
+}
+
+
+const GpuProfiler::ScopeStats* GpuProfiler::GetScopeStats(const std::string &name) const
+{
+    auto it = scopeIndices.find(name);
+    return it != scopeIndices.end() ? &scopes[it->second] : nullptr;
+}
+
+
+const std::vector<GpuProfiler::ScopeStats>& GpuProfiler::GetScopes() const
+{
+    return scopes;
+}
+
+
+unsigned int GpuProfiler::GetDroppedFrameCount() const
+{
+    return droppedFrames;
+}
+
+
+GLuint GpuProfiler::NextQuery(Frame &frame)
+{
+    // Query objects are generated the first time a frame of the ring needs
+    // them, and reused after that
+    if (frame.usedQueries == frame.queries.size())
+    {
+        GLuint query = 0;
+        glGenQueries(1, &query);
+        frame.queries.push_back(query);
+    }
+
+    return frame.queries[frame.usedQueries++];
+}
+
+
+bool GpuProfiler::IsAvailable(const Frame &frame) const
+{
+    for (unsigned int i = frame.usedQueries; i > 0; i--)
+    {
+        GLint available = 0;
+        glGetQueryObjectiv(frame.queries[i - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            return false;
+    }
+
+    return true;
+}
+
+
+void GpuProfiler::Resolve(Frame &frame)
+{
+    frameTimes.assign(scopes.size(), 0);
+    frameUsed.assign(scopes.size(), false);
+
+    for (const Timing &timing : frame.timings)
+    {
+        // Scopes left open have no end time
+        if (timing.endQuery == timing.beginQuery)
+            continue;
+
+        GLuint64 begin = 0, end = 0;
+        glGetQueryObjectui64v(frame.queries[timing.beginQuery], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(frame.queries[timing.endQuery], GL_QUERY_RESULT, &end);
+
+        frameTimes[timing.scope] += (end - begin) / 1e6;
+        frameUsed[timing.scope] = true;
+    }
+
+    for (size_t i = 0; i < scopes.size(); i++)
+    {
+        if (frameUsed[i])
+            AddSample(scopes[i].gpu, frameTimes[i]);
+    }
+
+    frame.pending = false;
+}
+
+
+void GpuProfiler::ResolveCpu(const Frame &frame)
+{
+    frameTimes.assign(scopes.size(), 0);
+    frameUsed.assign(scopes.size(), false);
+
+    for (const Timing &timing : frame.timings)
+    {
+        if (timing.endQuery == timing.beginQuery)
+            continue;
+
+        frameTimes[timing.scope] += timing.cpuMs;
+        frameUsed[timing.scope] = true;
+    }
+
+    for (size_t i = 0; i < scopes.size(); i++)
+    {
+        if (frameUsed[i])
+            AddSample(scopes[i].cpu, frameTimes[i]);
+    }
+}
+
+
+void GpuProfiler::AddSample(RollingTime &time, double ms)
+{
+    if (time.history.size() < averageFrames)
+    {
+        time.history.push_back(ms);
+    }
+    else
+    {
+        time.historySum -= time.history[time.historyNext];
+        time.history[time.historyNext] = ms;
+        time.historyNext = (time.historyNext + 1) % averageFrames;
+    }
+
+    time.historySum += ms;
+    time.lastMs = ms;
+    time.averageMs = time.historySum / time.history.size();
+}
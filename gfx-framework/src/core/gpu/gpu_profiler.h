@@ -0,0 +1,130 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/gl_utils.h"
+
+
+// GPU time of named scopes, measured with pairs of GL_TIMESTAMP queries,
+// and the CPU time spent recording them. Scopes may nest, and a name used
+// several times in a frame adds up.
+//
+// Queries are kept in a ring of `frameLatency` frames and reused, never
+// generated per frame. The results of a frame are only read once all of
+// its queries are available, so measuring never waits for the GPU. If the
+// GPU falls further behind than the ring, the oldest frame is dropped.
+//
+//      profiler->BeginFrame();
+//      {
+//          GpuProfiler::Scope scope(profiler, "Blur");
+//          ...
+//      }
+//      profiler->GetScopeStats("Blur")->gpu.averageMs
+class GpuProfiler
+{
+ public:
+    struct RollingTime
+    {
+        // Of the last resolved frame, and rolling average over the last
+        // `averageFrames` frames that used the scope
+        double lastMs;
+        double averageMs;
+
+        // Ring of the recent frame times, with their sum
+        std::vector<double> history;
+        unsigned int historyNext;
+        double historySum;
+    };
+
+    struct ScopeStats
+    {
+        std::string name;
+
+        // The CPU time is resolved when the next frame begins, the GPU
+        // time once its queries are available
+        RollingTime gpu;
+        RollingTime cpu;
+    };
+
+    // Begins a scope on construction and ends it on destruction. Does
+    // nothing for a null profiler.
+    class Scope
+    {
+     public:
+        Scope(GpuProfiler *profiler, const std::string &name);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope& operator=(const Scope &) = delete;
+
+     private:
+        GpuProfiler *profiler;
+    };
+
+ public:
+    explicit GpuProfiler(unsigned int frameLatency = 4, unsigned int averageFrames = 60);
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler &) = delete;
+    GpuProfiler& operator=(const GpuProfiler &) = delete;
+
+    // Reads the frames whose results are available, then starts recording
+    // a new frame
+    void BeginFrame();
+
+    void BeginScope(const std::string &name);
+    void EndScope();
+
+    // Null for names never used. The times stay zero until a frame that
+    // used the scope is resolved.
+    const ScopeStats* GetScopeStats(const std::string &name) const;
+
+    // In the order in which the scopes were first used
+    const std::vector<ScopeStats>& GetScopes() const;
+
+    unsigned int GetDroppedFrameCount() const;
+
+ private:
+    struct Timing
+    {
+        unsigned int scope;
+        unsigned int beginQuery;
+        unsigned int endQuery;
+
+        std::chrono::steady_clock::time_point cpuBegin;
+        double cpuMs;
+    };
+
+    struct Frame
+    {
+        std::vector<GLuint> queries;
+        unsigned int usedQueries;
+        std::vector<Timing> timings;
+        bool pending;
+    };
+
+    GLuint NextQuery(Frame &frame);
+    bool IsAvailable(const Frame &frame) const;
+    void Resolve(Frame &frame);
+    void ResolveCpu(const Frame &frame);
+    void AddSample(RollingTime &time, double ms);
+
+ private:
+    std::vector<Frame> frames;
+    unsigned int currentFrame;
+    unsigned int averageFrames;
+    unsigned int droppedFrames;
+
+    std::vector<ScopeStats> scopes;
+    std::unordered_map<std::string, unsigned int> scopeIndices;
+
+    // Timings of the open scopes, in the current frame
+    std::vector<unsigned int> openScopes;
+
+    // Per scope time of the frame being resolved
+    std::vector<double> frameTimes;
+    std::vector<bool> frameUsed;
+};
@@ -0,0 +1,61 @@
+#include "core/gpu/instance_buffer.h"
+
+#include "utils/memory_utils.h"
+
+
+InstanceBuffer::InstanceBuffer()
+{
+    matrices = nullptr;
+    uploadedMatrixCount = 0;
+}
+
+
+InstanceBuffer::~InstanceBuffer()
+{
+    SAFE_FREE(matrices);
+}
+
+
+void InstanceBuffer::Upload(const std::vector<glm::mat4> &models)
+{
+    uploadedMatrixCount = static_cast<unsigned int>(models.size());
+    if (models.empty())
+        return;
+
+    if (uploadedMatrixCount > GetCapacity())
+    {
+        // Grow by powers of two, so a growing scene reallocates rarely
+        unsigned int capacity = 256U;
+        while (capacity < uploadedMatrixCount)
+            capacity *= 2U;
+
+        SAFE_FREE(matrices);
+        matrices = new SSBO<glm::mat4>(capacity);
+    }
+    else
+    {
+        matrices->SetBufferData(nullptr);
+    }
+
+    matrices->SetBufferSubData(models.data(), 0, uploadedMatrixCount);
+    BindBuffer();
+}
+
+
+void InstanceBuffer::BindBuffer() const
+{
+    if (matrices)
+        matrices->BindBuffer(kBindingPoint);
+}
+
+
+unsigned int InstanceBuffer::GetCapacity() const
+{
+    return matrices ? matrices->GetSize() : 0U;
+}
+
+
+unsigned int InstanceBuffer::GetUploadedMatrixCount() const
+{
+    return uploadedMatrixCount;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+#include "core/gpu/ssbo.h"
+#include "utils/glm_utils.h"
+
+
+// Per-instance model matrices, streamed every frame into a shader storage
+// buffer bound at a fixed binding point. Shaders opt in to instancing with
+// the INSTANCED macro (see Shader::AddDefine and Shader::UsesInstancing),
+// and read the matrix of an instance with:
+//
+//      layout(std430, binding = 1) buffer InstanceMatrices { mat4 instanceModels[]; };
+//      uniform uint InstanceBase;
+//      ... instanceModels[InstanceBase + uint(gl_InstanceID)] ...
+//
+// See assets/shaders/MVP.Instanced.VS.glsl.
+class InstanceBuffer
+{
+ public:
+    static const GLuint kBindingPoint = 1U;
+
+    InstanceBuffer();
+    ~InstanceBuffer();
+
+    InstanceBuffer(const InstanceBuffer &) = delete;
+    InstanceBuffer& operator=(const InstanceBuffer &) = delete;
+
+    // Replaces the content of the buffer, growing it if needed. The old
+    // storage is orphaned first, so the upload does not wait for the draws
+    // of the previous frame that still read it.
+    void Upload(const std::vector<glm::mat4> &models);
+    void BindBuffer() const;
+
+    unsigned int GetCapacity() const;
+    unsigned int GetUploadedMatrixCount() const;
+
+ private:
+    SSBO<glm::mat4> *matrices;
+    unsigned int uploadedMatrixCount;
+};
@@ -1,11 +1,16 @@
 #include "core/gpu/mesh.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "assimp/Importer.hpp"          // C++ importer interface
 #include "assimp/postprocess.h"         // Post processing flags
 
+#include "core/cpu_profiler.h"
+#include "core/engine.h"
+#include "core/job_system.h"
 #include "core/gpu/gpu_buffers.h"
+#include "core/gpu/render_stats.h"
 #include "core/gpu/texture2D.h"
 #include "core/managers/texture_manager.h"
 
@@ -15,11 +20,86 @@
 static_assert(sizeof(aiColor4D) == sizeof(glm::vec4), "WARNING! glm::vec4 and aiColor4D size differs!");
 
 
+// File being loaded by LoadMeshAsync. The mesh is cleared when it is
+// destroyed, or loads another file, before the upload.
+struct Mesh::AsyncLoad
+{
+    Mesh *mesh;
+    MeshFileData data;
+    bool read;
+};
+
+
+static void ReadMesh(const aiMesh* paiMesh, MeshFileData &data)
+{
+    const aiVector3D Zero3D(0.0f, 0.0f, 0.0f);
+
+    // Populate the vertex attribute vectors
+    for (unsigned int i = 0; i < paiMesh->mNumVertices; i++) {
+        const aiVector3D* pPos      = &(paiMesh->mVertices[i]);
+        const aiVector3D* pNormal   = &(paiMesh->mNormals[i]);
+        const aiVector3D* pTexCoord = paiMesh->HasTextureCoords(0) ? &(paiMesh->mTextureCoords[0][i]) : &Zero3D;
+
+        data.positions.push_back(glm::vec3(pPos->x, pPos->y, pPos->z));
+        data.normals.push_back(glm::vec3(pNormal->x, pNormal->y, pNormal->z));
+        data.texCoords.push_back(glm::vec2(pTexCoord->x, pTexCoord->y));
+    }
+
+    // Init the index buffer
+    for (unsigned int i = 0; i < paiMesh->mNumFaces; i++) {
+        const aiFace& Face = paiMesh->mFaces[i];
+        data.indices.push_back(Face.mIndices[0]);
+        data.indices.push_back(Face.mIndices[1]);
+        data.indices.push_back(Face.mIndices[2]);
+        if (Face.mNumIndices == 4)
+            data.indices.push_back(Face.mIndices[3]);
+    }
+}
+
+
+static void ReadMaterials(const aiScene* pScene, MeshFileData &data)
+{
+    aiColor4D color;
+
+    data.materials.resize(pScene->mNumMaterials);
+    data.texturePaths.resize(pScene->mNumMaterials);
+
+    for (unsigned int i = 0 ; i < pScene->mNumMaterials ; i++)
+    {
+        const aiMaterial* pMaterial = pScene->mMaterials[i];
+        Material &material = data.materials[i];
+
+        if (pMaterial->GetTextureCount(aiTextureType_DIFFUSE) > 0)
+        {
+            aiString Path;
+            if (pMaterial->GetTexture(aiTextureType_DIFFUSE, 0, &Path, NULL, NULL, NULL, NULL, NULL) == AI_SUCCESS)
+            {
+                data.texturePaths[i] = Path.data;
+            }
+        }
+
+        if (aiGetMaterialColor(pMaterial, AI_MATKEY_COLOR_AMBIENT, &color) == AI_SUCCESS)
+            memcpy((void *)&material.ambient, &color, sizeof(color));
+
+        if (aiGetMaterialColor(pMaterial, AI_MATKEY_COLOR_DIFFUSE, &color) == AI_SUCCESS)
+            memcpy((void *)&material.diffuse, &color, sizeof(color));
+
+        if (aiGetMaterialColor(pMaterial, AI_MATKEY_COLOR_SPECULAR, &color) == AI_SUCCESS)
+            memcpy((void *)&material.specular, &color, sizeof(color));
+
+        if (aiGetMaterialColor(pMaterial, AI_MATKEY_COLOR_EMISSIVE, &color) == AI_SUCCESS)
+            memcpy((void *)&material.emissive, &color, sizeof(color));
+    }
+}
+
+
 Mesh::Mesh(std::string meshID)
 {
     this->meshID = std::move(meshID);
 
     useMaterial = true;
+    useTextureArray = false;
+    textureArray = nullptr;
     glDrawMode = GL_TRIANGLES;
     buffers = new GPUBuffers();
 }
@@ -27,8 +107,10 @@ Mesh::Mesh(std::string meshID)
 
 Mesh::~Mesh()
 {
+    CancelAsyncLoad();
     ClearData();
     meshEntries.clear();
+    buffers->ReleaseMemory();
     SAFE_FREE(buffers);
 }
 
@@ -50,35 +132,140 @@ void Mesh::ClearData()
     for (unsigned int i = 0 ; i < materials.size() ; i++) {
         SAFE_FREE(materials[i]);
     }
+    SAFE_FREE(textureArray);
     positions.clear();
     texCoords.clear();
     indices.clear();
     normals.clear();
+    textureLayers.clear();
 }
 
 
 bool Mesh::LoadMesh(const std::string& fileLocation,
                     const std::string& fileName)
 {
+    PROFILE_ZONE("Mesh::LoadMesh");
+
+    CancelAsyncLoad();
     ClearData();
     this->fileLocation = fileLocation;
-    std::string file = (fileLocation + '/' + fileName).c_str();
+
+    MeshFileData data;
+    if (!ReadFile(fileLocation + '/' + fileName, glDrawMode, data))
+        return false;
+
+    return InitFromFileData(data);
+}
+
+
+void Mesh::LoadMeshAsync(const std::string& fileLocation,
+                         const std::string& fileName,
+                         JobCounter *counter)
+{
+    JobSystem *jobs = Engine::GetJobSystem();
+    if (!jobs)
+    {
+        LoadMesh(fileLocation, fileName);
+        return;
+    }
+
+    CancelAsyncLoad();
+    ClearData();
+    this->fileLocation = fileLocation;
+    InitPlaceholder();
+
+    std::shared_ptr<AsyncLoad> load = std::make_shared<AsyncLoad>();
+    load->mesh = this;
+    load->read = false;
+    asyncLoad = load;
+
+    // Only the main thread touches the mesh, which may be destroyed while
+    // the worker fills `data`
+    const std::string file = fileLocation + '/' + fileName;
+    const GLenum drawMode = glDrawMode;
+    jobs->Run([jobs, load, file, drawMode, counter]()
+    {
+        load->read = ReadFile(file, drawMode, load->data);
+
+        jobs->Run([load]()
+        {
+            Mesh *mesh = load->mesh;
+            if (!mesh)
+                return;
+
+            mesh->asyncLoad.reset();
+            if (load->read)
+                mesh->InitFromFileData(load->data);
+        }, counter, JobAffinity::MainThread);
+    }, counter);
+}
+
+
+bool Mesh::IsLoading() const
+{
+    return asyncLoad != nullptr;
+}
+
+
+void Mesh::CancelAsyncLoad()
+{
+    if (!asyncLoad)
+        return;
+
+    asyncLoad->mesh = nullptr;
+    asyncLoad.reset();
+}
+
+
+bool Mesh::ReadFile(const std::string &file, GLenum drawMode, MeshFileData &data)
+{
+    PROFILE_ZONE("Mesh::ReadFile");
 
     Assimp::Importer Importer;
 
     unsigned int flags = aiProcess_GenSmoothNormals | aiProcess_FlipUVs;
-    if (glDrawMode == GL_TRIANGLES) flags |= aiProcess_Triangulate;
+    if (drawMode == GL_TRIANGLES) flags |= aiProcess_Triangulate;
 
     const aiScene* pScene = Importer.ReadFile(file, flags);
 
-    if (pScene) {
-        return InitFromScene(pScene);
+    // pScene is freed when returning because of Importer
+    if (!pScene)
+    {
+        printf("Error parsing '%s': '%s'\n", file.c_str(), Importer.GetErrorString());
+        return false;
     }
 
-    // pScene is freed when returning because of Importer
+    data.entries.resize(pScene->mNumMeshes);
+
+    unsigned int nrVertices = 0;
+    unsigned int nrIndices = 0;
 
-    printf("Error parsing '%s': '%s'\n", file.c_str(), Importer.GetErrorString());
-    return false;
+    // Count the number of vertices and indices
+    for (unsigned int i = 0 ; i < pScene->mNumMeshes ; i++)
+    {
+        data.entries[i].materialIndex = pScene->mMeshes[i]->mMaterialIndex;
+        data.entries[i].nrIndices = (pScene->mMeshes[i]->mNumFaces * (drawMode == GL_TRIANGLES ? 3 : 4));
+        data.entries[i].baseVertex = nrVertices;
+        data.entries[i].baseIndex = nrIndices;
+
+        nrVertices += pScene->mMeshes[i]->mNumVertices;
+        nrIndices  += data.entries[i].nrIndices;
+    }
+
+    // Reserve space in the vectors for the vertex attributes and indices
+    data.positions.reserve(nrVertices);
+    data.normals.reserve(nrVertices);
+    data.texCoords.reserve(nrVertices);
+    data.indices.reserve(nrIndices);
+
+    // Read the meshes in the scene one by one
+    for (unsigned int i = 0 ; i < pScene->mNumMeshes ; i++)
+    {
+        ReadMesh(pScene->mMeshes[i], data);
+    }
+
+    ReadMaterials(pScene, data);
+    return true;
 }
 
 
@@ -90,11 +277,27 @@ void Mesh::InitFromData()
 
     M.nrIndices = (unsigned int)indices.size();
     meshEntries.push_back(M);
+    InitDrawRanges();
 
     buffers->ReleaseMemory();
 }
 
 
+void Mesh::InitDrawRanges()
+{
+    drawCounts.resize(meshEntries.size());
+    drawOffsets.resize(meshEntries.size());
+    drawBaseVertices.resize(meshEntries.size());
+
+    for (unsigned int i = 0; i < meshEntries.size(); i++)
+    {
+        drawCounts[i] = static_cast<GLsizei>(meshEntries[i].nrIndices);
+        drawOffsets[i] = (void*)(sizeof(unsigned int) * meshEntries[i].baseIndex);
+        drawBaseVertices[i] = static_cast<GLint>(meshEntries[i].baseVertex);
+    }
+}
+
+
 bool Mesh::InitFromBuffer(unsigned int VAO,
                           unsigned int nrIndices)
 {
@@ -106,6 +309,7 @@ bool Mesh::InitFromBuffer(unsigned int VAO,
     MeshEntry M;
     M.nrIndices = nrIndices;
     meshEntries.push_back(M);
+    InitDrawRanges();
 
     buffers->ReleaseMemory();
     buffers->m_VAO = VAO;
@@ -156,109 +360,129 @@ bool Mesh::InitFromData(const std::vector<glm::vec3>& positions,
 }
 
 
-bool Mesh::InitFromScene(const aiScene* pScene)
+bool Mesh::InitFromFileData(MeshFileData &data)
 {
-    meshEntries.resize(pScene->mNumMeshes);
-    materials.resize(pScene->mNumMaterials);
+    PROFILE_ZONE("Mesh::InitFromFileData");
+
+    positions = std::move(data.positions);
+    normals = std::move(data.normals);
+    texCoords = std::move(data.texCoords);
+    indices = std::move(data.indices);
+    meshEntries = std::move(data.entries);
+
+    materials.resize(data.materials.size());
+    if (useMaterial)
+        InitMaterials(data);
+
+    // Entries drawn with the same texture are merged, so that a model made
+    // of many parts takes one draw call per texture. Without materials,
+    // no texture is bound and they all merge into one.
+    std::vector<const Texture2D *> textures;
+    std::vector<unsigned int> groups(meshEntries.size());
+    for (unsigned int i = 0; i < meshEntries.size(); i++)
+    {
+        const unsigned int materialIndex = meshEntries[i].materialIndex;
+        const Texture2D *texture = nullptr;
+        if (useMaterial && materialIndex != INVALID_MATERIAL && materials[materialIndex])
+            texture = materials[materialIndex]->texture;
+
+        groups[i] = static_cast<unsigned int>(std::find(textures.begin(), textures.end(), texture) - textures.begin());
+        if (groups[i] == textures.size())
+            textures.push_back(texture);
+    }
 
-    unsigned int nrVertices = 0;
-    unsigned int nrIndices = 0;
+    // With a texture array, each vertex selects its texture by its layer,
+    // so all the entries are drawn with the same binding
+    if (useMaterial && useTextureArray && textures.size() > 1 && InitTextureArray(textures, groups))
+        std::fill(groups.begin(), groups.end(), 0U);
 
-    // Count the number of vertices and indices
-    for (unsigned int i = 0 ; i < pScene->mNumMeshes ; i++)
-    {
-        meshEntries[i].materialIndex = pScene->mMeshes[i]->mMaterialIndex;
-        meshEntries[i].nrIndices = (pScene->mMeshes[i]->mNumFaces * (glDrawMode == GL_TRIANGLES ? 3 : 4));
-        meshEntries[i].baseVertex = nrVertices;
-        meshEntries[i].baseIndex = nrIndices;
+    gpu_utils::MergeMeshEntries(meshEntries, indices, groups);
+    InitDrawRanges();
 
-        nrVertices += pScene->mMeshes[i]->mNumVertices;
-        nrIndices  += meshEntries[i].nrIndices;
-    }
+    buffers->ReleaseMemory();
+    if (textureArray)
+        *buffers = gpu_utils::UploadData(positions, normals, texCoords, textureLayers, indices);
+    else
+        *buffers = gpu_utils::UploadData(positions, normals, texCoords, indices);
+    return buffers->m_VAO != 0;
+}
 
-    // Reserve space in the vectors for the vertex attributes and indices
-    positions.reserve(nrVertices);
-    normals.reserve(nrVertices);
-    texCoords.reserve(nrVertices);
-    indices.reserve(nrIndices);
 
-    // Initialize the meshes in the scene one by one
-    for (unsigned int i = 0 ; i < meshEntries.size() ; i++)
+bool Mesh::InitTextureArray(std::vector<const Texture2D *> textures,
+                            const std::vector<unsigned int> &layers)
+{
+    // Entries without a texture are drawn with the default one
+    for (const Texture2D *&texture : textures)
     {
-        const aiMesh* paiMesh = pScene->mMeshes[i];
-        InitMesh(paiMesh);
+        if (!texture)
+            texture = TextureManager::GetTexture(static_cast<unsigned int>(0));
     }
 
-    if (useMaterial && !InitMaterials(pScene))
+    textureArray = new TextureArray();
+    if (!textureArray->Create(textures))
+    {
+        SAFE_FREE(textureArray);
         return false;
+    }
 
-    buffers->ReleaseMemory();
-    *buffers = gpu_utils::UploadData(positions, normals, texCoords, indices);
-    return buffers->m_VAO != 0;
+    textureLayers.clear();
+    textureLayers.reserve(positions.size());
+    for (unsigned int i = 0; i < meshEntries.size(); i++)
+    {
+        const unsigned int end = i + 1 < meshEntries.size() ? meshEntries[i + 1].baseVertex : static_cast<unsigned int>(positions.size());
+        textureLayers.insert(textureLayers.end(), end - meshEntries[i].baseVertex, static_cast<float>(layers[i]));
+    }
+
+    return true;
 }
 
 
-void Mesh::InitMesh(const aiMesh* paiMesh)
+void Mesh::InitMaterials(const MeshFileData &data)
 {
-    const aiVector3D Zero3D(0.0f, 0.0f, 0.0f);
-
-    // Populate the vertex attribute vectors
-    for (unsigned int i = 0; i < paiMesh->mNumVertices; i++) {
-        const aiVector3D* pPos      = &(paiMesh->mVertices[i]);
-        const aiVector3D* pNormal   = &(paiMesh->mNormals[i]);
-        const aiVector3D* pTexCoord = paiMesh->HasTextureCoords(0) ? &(paiMesh->mTextureCoords[0][i]) : &Zero3D;
+    for (unsigned int i = 0 ; i < data.materials.size() ; i++)
+    {
+        materials[i] = new Material(data.materials[i]);
 
-        positions.push_back(glm::vec3(pPos->x, pPos->y, pPos->z));
-        normals.push_back(glm::vec3(pNormal->x, pNormal->y, pNormal->z));
-        texCoords.push_back(glm::vec2(pTexCoord->x, pTexCoord->y));
+        if (!data.texturePaths[i].empty())
+            materials[i]->texture = TextureManager::LoadTexture(fileLocation, data.texturePaths[i].c_str());
     }
 
-    // Init the index buffer
-    for (unsigned int i = 0; i < paiMesh->mNumFaces; i++) {
-        const aiFace& Face = paiMesh->mFaces[i];
-        indices.push_back(Face.mIndices[0]);
-        indices.push_back(Face.mIndices[1]);
-        indices.push_back(Face.mIndices[2]);
-        if (Face.mNumIndices == 4)
-            indices.push_back(Face.mIndices[3]);
-    }
+    CheckOpenGLError();
 }
 
 
-bool Mesh::InitMaterials(const aiScene* pScene)
+void Mesh::InitPlaceholder()
 {
-    bool ret = true;
-    aiColor4D color;
+    // A unit box, with four vertices per face for flat normals
+    std::vector<glm::vec3> boxPositions, boxNormals;
+    std::vector<glm::vec2> boxTexCoords;
+    std::vector<unsigned int> boxIndices;
 
-    for (unsigned int i = 0 ; i < pScene->mNumMaterials ; i++)
+    for (unsigned int axis = 0; axis < 3; axis++)
     {
-        const aiMaterial* pMaterial = pScene->mMaterials[i];
-        materials[i] = new Material();
-
-        if (pMaterial->GetTextureCount(aiTextureType_DIFFUSE) > 0)
+        for (float side = -1; side <= 1; side += 2)
         {
-            aiString Path;
-            if (pMaterial->GetTexture(aiTextureType_DIFFUSE, 0, &Path, NULL, NULL, NULL, NULL, NULL) == AI_SUCCESS)
+            glm::vec3 normal(0), u(0), v(0);
+            normal[axis] = side;
+            u[(axis + 1) % 3] = side;
+            v[(axis + 2) % 3] = 1;
+
+            const unsigned int base = static_cast<unsigned int>(boxPositions.size());
+            for (unsigned int corner = 0; corner < 4; corner++)
             {
-                materials[i]->texture = TextureManager::LoadTexture(fileLocation, Path.data);
+                const glm::vec2 uv = glm::vec2(corner == 1 || corner == 2 ? 1 : 0, corner >= 2 ? 1 : 0);
+                boxPositions.push_back(0.5f * (normal + (2 * uv.x - 1) * u + (2 * uv.y - 1) * v));
+                boxNormals.push_back(normal);
+                boxTexCoords.push_back(uv);
             }
-        }
-
-        if (aiGetMaterialColor(pMaterial, AI_MATKEY_COLOR_AMBIENT, &color) == AI_SUCCESS)
-            memcpy((void *)&materials[i]->ambient, &color, sizeof(color));
-
-        if (aiGetMaterialColor(pMaterial, AI_MATKEY_COLOR_DIFFUSE, &color) == AI_SUCCESS)
-            memcpy((void *)&materials[i]->diffuse, &color, sizeof(color));
-
-        if (aiGetMaterialColor(pMaterial, AI_MATKEY_COLOR_SPECULAR, &color) == AI_SUCCESS)
-            memcpy((void *)&materials[i]->specular, &color, sizeof(color));
 
-        if (aiGetMaterialColor(pMaterial, AI_MATKEY_COLOR_EMISSIVE, &color) == AI_SUCCESS)
-            memcpy((void *)&materials[i]->emissive, &color, sizeof(color));
+            const unsigned int quad[] = { 0, 1, 2, 0, 2, 3 };
+            for (unsigned int index : quad)
+                boxIndices.push_back(base + index);
+        }
     }
 
-    CheckOpenGLError();
-    return ret;
+    InitFromData(boxPositions, boxNormals, boxTexCoords, boxIndices);
 }
 
 
@@ -280,12 +504,48 @@ void Mesh::UseMaterials(bool value)
 }
 
 
+void Mesh::UseTextureArray(bool value)
+{
+    useTextureArray = value;
+}
+
+
 void Mesh::Render() const
+{
+    Bind();
+    Draw();
+    glBindVertexArray(0);
+}
+
+
+void Mesh::Bind() const
 {
     glBindVertexArray(buffers->m_VAO);
+}
+
+
+void Mesh::Draw(unsigned int instanceCount) const
+{
+    const bool bindPerEntry = useMaterial && !textureArray;
+    if (useMaterial && textureArray)
+        textureArray->BindToTextureUnit(GL_TEXTURE0);
+
+    // Without materials, nothing has to change between the entries
+    if (!bindPerEntry && instanceCount == 1 && meshEntries.size() > 1)
+    {
+        glMultiDrawElementsBaseVertex(glDrawMode, drawCounts.data(), GL_UNSIGNED_INT, drawOffsets.data(),
+            static_cast<GLsizei>(drawCounts.size()), drawBaseVertices.data());
+
+        unsigned int indexCount = 0;
+        for (GLsizei count : drawCounts)
+            indexCount += count;
+        render_stats::AddDraw(glDrawMode, indexCount);
+        return;
+    }
+
     for (unsigned int i = 0; i < meshEntries.size(); i++)
     {
-        if (useMaterial)
+        if (bindPerEntry)
         {
             auto materialIndex = meshEntries[i].materialIndex;
             if (materialIndex != INVALID_MATERIAL && materials[materialIndex]->texture)
@@ -296,9 +556,30 @@ void Mesh::Render() const
             }
         }
 
-        glDrawElementsBaseVertex(glDrawMode, meshEntries[i].nrIndices,
-            GL_UNSIGNED_INT, (void*)(sizeof(unsigned int) * meshEntries[i].baseIndex),
-            meshEntries[i].baseVertex);
+        if (instanceCount == 1)
+        {
+            glDrawElementsBaseVertex(glDrawMode, meshEntries[i].nrIndices,
+                GL_UNSIGNED_INT, (void*)(sizeof(unsigned int) * meshEntries[i].baseIndex),
+                meshEntries[i].baseVertex);
+        }
+        else
+        {
+            glDrawElementsInstancedBaseVertex(glDrawMode, meshEntries[i].nrIndices,
+                GL_UNSIGNED_INT, (void*)(sizeof(unsigned int) * meshEntries[i].baseIndex),
+                instanceCount, meshEntries[i].baseVertex);
+        }
+        render_stats::AddDraw(glDrawMode, meshEntries[i].nrIndices, instanceCount);
     }
-    glBindVertexArray(0);
+}
+
+
+bool Mesh::UsesMaterials() const
+{
+    return useMaterial;
+}
+
+
+const TextureArray* Mesh::GetTextureArray() const
+{
+    return textureArray;
 }
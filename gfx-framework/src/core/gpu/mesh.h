@@ -1,11 +1,14 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "core/gpu/vertex_format.h"
 #include "core/gpu/texture2D.h"
+#include "core/gpu/texture_array.h"
 #include "core/gpu/gpu_buffers.h"
+#include "core/gpu/mesh_entry.h"
 
 #include "assimp/scene.h"   // Output data structure
 
@@ -27,24 +30,28 @@ class Material
     Texture2D* texture;
 };
 
-static const unsigned int INVALID_MATERIAL = std::numeric_limits<unsigned int>::max();
 
-class MeshEntry
+class JobCounter;
+
+
+// What LoadMesh reads from a model file: the vertex data, the entries and
+// the materials, with the paths of their textures. Reading it does not
+// need OpenGL, so LoadMeshAsync reads it on a worker thread.
+struct MeshFileData
 {
- public:
-    MeshEntry()
-    {
-        nrIndices = 0;
-        baseVertex = 0;
-        baseIndex = 0;
-        materialIndex = INVALID_MATERIAL;
-    }
-    unsigned int nrIndices;
-    unsigned int baseVertex;
-    unsigned int baseIndex;
-    unsigned int materialIndex;
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> normals;
+    std::vector<glm::vec2> texCoords;
+    std::vector<unsigned int> indices;
+    std::vector<MeshEntry> entries;
+
+    // One per material of the file, without its texture, and the path of
+    // the texture, relative to the file, or empty if it has none
+    std::vector<Material> materials;
+    std::vector<std::string> texturePaths;
 };
 
+
 class Mesh
 {
     typedef unsigned int GLenum;
@@ -77,8 +84,38 @@ class Mesh
     bool LoadMesh(const std::string& fileLocation,
                   const std::string& fileName);
 
+    // Same as LoadMesh, but returns at once. The file is read on a worker
+    // of the JobSystem, then a main thread job loads the textures and
+    // uploads the buffers, at the start of a frame. Until then, the mesh
+    // is drawn as a unit box, which also stays if the file cannot be read.
+    //
+    // `counter`, when given, reaches zero once the mesh is uploaded, so
+    // Init can start loading all its meshes, then wait for all of them:
+    //
+    //      JobCounter loaded;
+    //      box->LoadMeshAsync(location, "box.obj", &loaded);
+    //      bunny->LoadMeshAsync(location, "bunny.obj", &loaded);
+    //      Engine::GetJobSystem()->Wait(loaded);
+    //
+    // Must be called on the main thread, and not with a render thread,
+    // since the upload uses the context of the main thread.
+    void LoadMeshAsync(const std::string& fileLocation,
+                       const std::string& fileName,
+                       JobCounter *counter = nullptr);
+
+    // True from LoadMeshAsync until the mesh is uploaded
+    bool IsLoading() const;
+
     void UseMaterials(bool value);
 
+    // Packs the diffuse textures of the materials in a TextureArray when
+    // the mesh is loaded, if they have the same size, so the whole mesh is
+    // drawn with a single texture bind and draw call. The layer of each
+    // vertex is passed at location 4, and the mesh must be drawn with a
+    // shader that samples a sampler2DArray, such as TextureArray.FS.glsl.
+    // Must be called before LoadMesh.
+    void UseTextureArray(bool value);
+
     // GL_POINTS, GL_TRIANGLES, GL_LINES, GL_LINE_STRIP, GL_LINE_LOOP, GL_LINE_STRIP_ADJACENCY, GL_LINES_ADJACENCY,
     // GL_TRIANGLE_STRIP, GL_TRIANGLE_FAN, GL_TRIANGLE_STRIP_ADJACENCY, GL_TRIANGLES_ADJACENCY
     void SetDrawMode(GLenum primitive);
@@ -86,23 +123,52 @@ class Mesh
 
     void Render() const;
 
+    // Render() split in two, so that consecutive draws of the same mesh
+    // bind its VAO once. Draw() expects the VAO to be bound, and draws
+    // `instanceCount` instances with a single instanced draw call if more
+    // than one is asked for. Without materials, all the entries of the
+    // mesh are drawn with one glMultiDrawElementsBaseVertex call.
+    void Bind() const;
+    void Draw(unsigned int instanceCount = 1) const;
+    bool UsesMaterials() const;
+
+    // Null if the mesh does not use a texture array
+    const TextureArray* GetTextureArray() const;
+
     const GPUBuffers* GetBuffers() const;
     const char* GetMeshID() const;
 
  protected:
     void InitFromData();
+    void InitDrawRanges();
+
+    void InitPlaceholder();
 
-    void InitMesh(const aiMesh* paiMesh);
-    bool InitMaterials(const aiScene* pScene);
-    bool InitFromScene(const aiScene* pScene);
+    // Reads the faces of `file` as triangles, or as quads for the other draw
+    // modes. Prints the error, if any.
+    static bool ReadFile(const std::string &file, GLenum drawMode, MeshFileData &data);
+
+    // Takes the data, loads the textures and uploads the buffers
+    bool InitFromFileData(MeshFileData &data);
+    void InitMaterials(const MeshFileData &data);
+    bool InitTextureArray(std::vector<const Texture2D *> textures,
+                          const std::vector<unsigned int> &layers);
+
+ private:
+    struct AsyncLoad;
+
+    // Stops the upload of the file being loaded, if any
+    void CancelAsyncLoad();
 
  private:
     std::string meshID;
+    std::shared_ptr<AsyncLoad> asyncLoad;
 
  public:
     std::vector<glm::vec3> positions;
     std::vector<glm::vec3> normals;
     std::vector<glm::vec2> texCoords;
+    std::vector<float> textureLayers;
     std::vector<VertexFormat> vertices;
     std::vector<unsigned int> indices;
 
@@ -110,9 +176,16 @@ class Mesh
     std::string fileLocation;
 
     bool useMaterial;
+    bool useTextureArray;
+    TextureArray *textureArray;
     GLenum glDrawMode;
     GPUBuffers *buffers;
 
     std::vector<MeshEntry> meshEntries;
     std::vector<Material*> materials;
+
+    // Entries in the layout of glMultiDrawElementsBaseVertex
+    std::vector<GLsizei> drawCounts;
+    std::vector<const void *> drawOffsets;
+    std::vector<GLint> drawBaseVertices;
 };
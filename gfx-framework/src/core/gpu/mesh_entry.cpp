@@ -0,0 +1,53 @@
+#include "core/gpu/mesh_entry.h"
+
+#include <cassert>
+
+
+unsigned int gpu_utils::MergeMeshEntries(std::vector<MeshEntry> &entries,
+                                         std::vector<unsigned int> &indices,
+                                         const std::vector<unsigned int> &groups)
+{
+    assert(groups.size() == entries.size());
+
+    // Position of each group in the merged entries
+    std::vector<unsigned int> groupOrder;
+    std::vector<unsigned int> entryGroup(entries.size());
+
+    for (unsigned int i = 0; i < entries.size(); i++)
+    {
+        unsigned int order = 0;
+        while (order < groupOrder.size() && groups[groupOrder[order]] != groups[i])
+            order++;
+
+        if (order == groupOrder.size())
+            groupOrder.push_back(i);
+        entryGroup[i] = order;
+    }
+
+    std::vector<MeshEntry> merged(groupOrder.size());
+    std::vector<unsigned int> mergedIndices;
+    mergedIndices.reserve(indices.size());
+
+    for (unsigned int order = 0; order < groupOrder.size(); order++)
+    {
+        MeshEntry &entry = merged[order];
+        entry.baseIndex = static_cast<unsigned int>(mergedIndices.size());
+        entry.materialIndex = entries[groupOrder[order]].materialIndex;
+
+        for (unsigned int i = groupOrder[order]; i < entries.size(); i++)
+        {
+            if (entryGroup[i] != order)
+                continue;
+
+            const MeshEntry &source = entries[i];
+            for (unsigned int k = 0; k < source.nrIndices; k++)
+                mergedIndices.push_back(indices[source.baseIndex + k] + source.baseVertex);
+        }
+
+        entry.nrIndices = static_cast<unsigned int>(mergedIndices.size()) - entry.baseIndex;
+    }
+
+    entries.swap(merged);
+    indices.swap(mergedIndices);
+    return static_cast<unsigned int>(entries.size());
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+
+
+static const unsigned int INVALID_MATERIAL = std::numeric_limits<unsigned int>::max();
+
+class MeshEntry
+{
+ public:
+    MeshEntry()
+    {
+        nrIndices = 0;
+        baseVertex = 0;
+        baseIndex = 0;
+        materialIndex = INVALID_MATERIAL;
+    }
+    unsigned int nrIndices;
+    unsigned int baseVertex;
+    unsigned int baseIndex;
+    unsigned int materialIndex;
+};
+
+
+namespace gpu_utils
+{
+    // Merges the entries that are in the same group, such as the entries
+    // drawn with the same texture, into one entry per group, in the order
+    // in which the groups first appear. The indices of each group are
+    // moved next to each other, and the base vertex of every entry is
+    // added to its indices, so each merged entry is a single range drawn
+    // from vertex 0. An entry keeps the material of the first entry of its
+    // group. Returns the number of entries after the merge.
+    unsigned int MergeMeshEntries(std::vector<MeshEntry> &entries,
+                                  std::vector<unsigned int> &indices,
+                                  const std::vector<unsigned int> &groups);
+}   // namespace gpu_utils
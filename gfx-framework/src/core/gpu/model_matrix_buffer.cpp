@@ -0,0 +1,79 @@
+#include "core/gpu/model_matrix_buffer.h"
+
+#include "components/transform.h"
+#include "utils/memory_utils.h"
+
+
+ModelMatrixBuffer::ModelMatrixBuffer(unsigned int capacity)
+    : localMatrices(capacity, glm::mat4(1))
+{
+    matrices = new SSBO<glm::mat4>(capacity);
+    matrices->SetBufferData(localMatrices.data());
+    uploadedMatrixCount = 0;
+}
+
+
+ModelMatrixBuffer::~ModelMatrixBuffer()
+{
+    SAFE_FREE(matrices);
+}
+
+
+void ModelMatrixBuffer::Upload(gfxc::TransformJournal &journal)
+{
+    uploadedMatrixCount = 0;
+    ranges.clear();
+
+    if (journal.IsEmpty())
+        return;
+
+    for (gfxc::Transform *transform : journal.GetChanges())
+    {
+        const unsigned int id = transform->GetObjectId();
+        if (id < localMatrices.size())
+            localMatrices[id] = transform->GetModel();
+    }
+
+    journal.GetChangedRanges(ranges, kMaxRangeGap);
+    for (const gfxc::IdRange &range : ranges)
+    {
+        if (range.begin >= localMatrices.size())
+            break;
+
+        const unsigned int end = glm::min(range.end, static_cast<unsigned int>(localMatrices.size()));
+        matrices->SetBufferSubData(&localMatrices[range.begin], range.begin * sizeof(glm::mat4), end - range.begin);
+        uploadedMatrixCount += end - range.begin;
+    }
+
+    journal.Clear();
+}
+
+
+void ModelMatrixBuffer::BindBuffer(GLuint index) const
+{
+    matrices->BindBuffer(index);
+}
+
+
+unsigned int ModelMatrixBuffer::GetCapacity() const
+{
+    return static_cast<unsigned int>(localMatrices.size());
+}
+
+
+const glm::mat4* ModelMatrixBuffer::GetMatrices() const
+{
+    return localMatrices.data();
+}
+
+
+unsigned int ModelMatrixBuffer::GetUploadedMatrixCount() const
+{
+    return uploadedMatrixCount;
+}
+
+
+unsigned int ModelMatrixBuffer::GetUploadedRangeCount() const
+{
+    return static_cast<unsigned int>(ranges.size());
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+#include "components/transform_journal.h"
+#include "core/gpu/ssbo.h"
+#include "utils/glm_utils.h"
+
+
+// Model matrices of a scene, stored in a shader storage buffer and indexed
+// by the object id of each transform (see gfxc::Transform::SetJournal).
+// Every frame, Upload() only sends the matrices recorded in the journal,
+// so the upload volume follows what moved instead of the scene size. A
+// vertex shader reads them with:
+//
+//      layout(std430, binding = 0) buffer ModelMatrices { mat4 models[]; };
+//      uniform uint ObjectId;
+//      ... models[ObjectId] ...
+//
+// See assets/shaders/MVP.ModelBuffer.VS.glsl.
+class ModelMatrixBuffer
+{
+ public:
+    // Ids closer than this are uploaded in a single range, since a few
+    // unchanged matrices cost less than an extra glBufferSubData call
+    static const unsigned int kMaxRangeGap = 4U;
+
+    explicit ModelMatrixBuffer(unsigned int capacity);
+    ~ModelMatrixBuffer();
+
+    ModelMatrixBuffer(const ModelMatrixBuffer &) = delete;
+    ModelMatrixBuffer& operator=(const ModelMatrixBuffer &) = delete;
+
+    // Sends the changed matrices to the GPU, then clears the journal
+    void Upload(gfxc::TransformJournal &journal);
+    void BindBuffer(GLuint index) const;
+
+    unsigned int GetCapacity() const;
+    const glm::mat4* GetMatrices() const;
+
+    // Statistics of the last upload
+    unsigned int GetUploadedMatrixCount() const;
+    unsigned int GetUploadedRangeCount() const;
+
+ private:
+    SSBO<glm::mat4> *matrices;
+    std::vector<glm::mat4> localMatrices;
+    std::vector<gfxc::IdRange> ranges;
+
+    unsigned int uploadedMatrixCount;
+};
@@ -0,0 +1,359 @@
+#include "core/gpu/render_queue.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <functional>
+
+
+// Bit widths of the fields of the sort key. Ids past the width of their
+// field share its largest value, which only makes the grouping coarser.
+static const unsigned int kPassBits = 4U;
+static const unsigned int kShaderBits = 10U;
+static const unsigned int kTextureSetBits = 12U;
+static const unsigned int kMeshBits = 13U;
+static const unsigned int kDepthBits = 24U;
+
+static_assert(kPassBits + 1U + kShaderBits + kTextureSetBits + kMeshBits + kDepthBits == 64U, "The key fields must fill 64 bits");
+
+
+static std::uint64_t Field(unsigned int value, unsigned int bits)
+{
+    const unsigned int maxValue = (1U << bits) - 1U;
+    return static_cast<std::uint64_t>(std::min(value, maxValue));
+}
+
+
+// The bits of a positive float sort in the same order as its value, so the
+// top bits are a depth with more precision near the camera
+static unsigned int QuantizeDepth(float depth)
+{
+    depth = std::max(depth, 0.0f);
+
+    std::uint32_t bits;
+    std::memcpy(&bits, &depth, sizeof(bits));
+    return bits >> (32U - kDepthBits);
+}
+
+
+// Least significant digit first radix sort, 11 bits per pass. It is stable,
+// so equal keys keep the submission order. Passes over digits that are the
+// same for every key, such as the pass bits most of the time, are skipped.
+template <class Entry>
+static void RadixSort(std::vector<Entry> &entries, std::vector<Entry> &scratch)
+{
+    const unsigned int kDigitBits = 11U;
+    const unsigned int kBuckets = 1U << kDigitBits;
+
+    // Clearing the buckets costs more than a comparison sort of few entries
+    if (entries.size() < kBuckets / 4U)
+    {
+        std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b)
+        {
+            return a.key < b.key || (a.key == b.key && a.index < b.index);
+        });
+        return;
+    }
+
+    scratch.resize(entries.size());
+    std::vector<unsigned int> counts(kBuckets);
+
+    for (unsigned int shift = 0; shift < 64U; shift += kDigitBits)
+    {
+        std::fill(counts.begin(), counts.end(), 0U);
+        for (const Entry &entry : entries)
+        {
+            counts[(entry.key >> shift) & (kBuckets - 1U)]++;
+        }
+
+        if (entries.empty() || counts[(entries[0].key >> shift) & (kBuckets - 1U)] == entries.size())
+            continue;
+
+        unsigned int offset = 0;
+        for (unsigned int &count : counts)
+        {
+            const unsigned int bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+
+        for (const Entry &entry : entries)
+        {
+            scratch[counts[(entry.key >> shift) & (kBuckets - 1U)]++] = entry;
+        }
+        entries.swap(scratch);
+    }
+}
+
+
+unsigned int RenderQueueStats::GetStateChanges() const
+{
+    return programChanges + meshChanges + textureChanges + blendChanges;
+}
+
+
+RenderStateTracker::RenderStateTracker()
+{
+    shader = nullptr;
+    mesh = nullptr;
+    std::fill(textures, textures + DrawPacket::kMaxTextures, nullptr);
+    blend = false;
+    stats = RenderQueueStats();
+}
+
+
+RenderStateChange RenderStateTracker::Apply(const DrawPacket &packet)
+{
+    RenderStateChange change = RenderStateChange();
+
+    change.program = packet.shader != shader;
+    change.mesh = packet.mesh != mesh;
+    change.blend = packet.blend != blend;
+
+    for (unsigned int i = 0; i < DrawPacket::kMaxTextures; i++)
+    {
+        if (packet.textures[i] && packet.textures[i] != textures[i])
+        {
+            textures[i] = packet.textures[i];
+            change.textureMask |= 1U << i;
+            stats.textureChanges++;
+        }
+    }
+
+    shader = packet.shader;
+    mesh = packet.mesh;
+    blend = packet.blend;
+
+    stats.draws++;
+    stats.programChanges += change.program ? 1U : 0U;
+    stats.meshChanges += change.mesh ? 1U : 0U;
+    stats.blendChanges += change.blend ? 1U : 0U;
+    return change;
+}
+
+
+void RenderStateTracker::ForgetTexture(unsigned int unit)
+{
+    textures[unit] = nullptr;
+}
+
+
+const RenderQueueStats& RenderStateTracker::GetStats() const
+{
+    return stats;
+}
+
+
+bool RenderQueue::TextureSet::operator==(const TextureSet &other) const
+{
+    return std::equal(textures, textures + DrawPacket::kMaxTextures, other.textures);
+}
+
+
+std::size_t RenderQueue::TextureSetHash::operator()(const TextureSet &set) const
+{
+    std::size_t hash = 0;
+    for (const Texture2D *texture : set.textures)
+    {
+        hash = hash * 31 + std::hash<const Texture2D *>()(texture);
+    }
+    return hash;
+}
+
+
+RenderQueue::RenderQueue()
+{
+    stats = RenderQueueStats();
+    unsortedStats = RenderQueueStats();
+}
+
+
+void RenderQueue::Submit(const DrawPacket &packet)
+{
+    assert(packet.pass < kMaxPasses);
+    packets.push_back(packet);
+}
+
+
+void RenderQueue::Sort(const glm::mat4 &view)
+{
+    RenderStateTracker unsortedState;
+
+    entries.resize(packets.size());
+    for (unsigned int i = 0; i < packets.size(); i++)
+    {
+        entries[i].key = ComputeKey(packets[i], view);
+        entries[i].index = i;
+        unsortedState.Apply(packets[i]);
+    }
+
+    RadixSort(entries, scratchEntries);
+
+    RenderStateTracker sortedState;
+
+    sortedPackets.resize(entries.size());
+    sortedModels.resize(entries.size());
+    batches.clear();
+
+    for (unsigned int i = 0; i < entries.size(); i++)
+    {
+        const DrawPacket &packet = packets[entries[i].index];
+        sortedPackets[i] = &packet;
+        sortedModels[i] = packet.model;
+        sortedState.Apply(packet);
+
+        if (i > 0 && IsSameBatch(*sortedPackets[i - 1], packet))
+        {
+            batches.back().count++;
+        }
+        else
+        {
+            DrawBatch batch;
+            batch.first = i;
+            batch.count = 1;
+            batches.push_back(batch);
+        }
+    }
+
+    stats = sortedState.GetStats();
+    unsortedStats = unsortedState.GetStats();
+}
+
+
+void RenderQueue::Clear()
+{
+    packets.clear();
+    entries.clear();
+    sortedPackets.clear();
+    sortedModels.clear();
+    batches.clear();
+
+    shaderIds.clear();
+    meshIds.clear();
+    textureSetIds.clear();
+}
+
+
+unsigned int RenderQueue::GetSize() const
+{
+    return static_cast<unsigned int>(packets.size());
+}
+
+
+const DrawPacket& RenderQueue::GetPacket(unsigned int index) const
+{
+    return packets[index];
+}
+
+
+const DrawPacket& RenderQueue::GetSortedPacket(unsigned int index) const
+{
+    return *sortedPackets[index];
+}
+
+
+const std::vector<glm::mat4>& RenderQueue::GetSortedModels() const
+{
+    return sortedModels;
+}
+
+
+const std::vector<DrawBatch>& RenderQueue::GetBatches() const
+{
+    return batches;
+}
+
+
+const RenderQueueStats& RenderQueue::GetStats() const
+{
+    return stats;
+}
+
+
+const RenderQueueStats& RenderQueue::GetUnsortedStats() const
+{
+    return unsortedStats;
+}
+
+
+unsigned int RenderQueue::GetSavedStateChanges() const
+{
+    return unsortedStats.GetStateChanges() - stats.GetStateChanges();
+}
+
+
+bool RenderQueue::IsSameBatch(const DrawPacket &a, const DrawPacket &b)
+{
+    return a.mesh == b.mesh && a.shader == b.shader && a.blend == b.blend && a.pass == b.pass
+        && std::equal(a.textures, a.textures + DrawPacket::kMaxTextures, b.textures);
+}
+
+
+// Looks the key up before inserting it, since inserting allocates a node
+// even when the key is already in the map
+template <class Map, class Key>
+static unsigned int GetOrAddId(Map &ids, const Key &key)
+{
+    auto it = ids.find(key);
+    if (it != ids.end())
+        return it->second;
+
+    const unsigned int id = static_cast<unsigned int>(ids.size());
+    ids.emplace(key, id);
+    return id;
+}
+
+
+unsigned int RenderQueue::GetShaderId(const Shader *shader)
+{
+    return GetOrAddId(shaderIds, shader);
+}
+
+
+unsigned int RenderQueue::GetMeshId(const Mesh *mesh)
+{
+    return GetOrAddId(meshIds, mesh);
+}
+
+
+unsigned int RenderQueue::GetTextureSetId(const DrawPacket &packet)
+{
+    TextureSet set;
+    std::copy(packet.textures, packet.textures + DrawPacket::kMaxTextures, set.textures);
+    return GetOrAddId(textureSetIds, set);
+}
+
+
+std::uint64_t RenderQueue::ComputeKey(const DrawPacket &packet, const glm::mat4 &view)
+{
+    // Distance along the view direction
+    const glm::vec4 position = view * packet.model[3];
+    const unsigned int depth = QuantizeDepth(-position.z);
+
+    const std::uint64_t shader = Field(GetShaderId(packet.shader), kShaderBits);
+    const std::uint64_t textureSet = Field(GetTextureSetId(packet), kTextureSetBits);
+    const std::uint64_t mesh = Field(GetMeshId(packet.mesh), kMeshBits);
+
+    std::uint64_t key = Field(packet.pass, kPassBits);
+
+    if (!packet.blend)
+    {
+        key = key << 1;
+        key = (key << kShaderBits) | shader;
+        key = (key << kTextureSetBits) | textureSet;
+        key = (key << kMeshBits) | mesh;
+        key = (key << kDepthBits) | depth;
+    }
+    else
+    {
+        const std::uint64_t backToFront = ((1U << kDepthBits) - 1U) - depth;
+
+        key = (key << 1) | 1U;
+        key = (key << kDepthBits) | backToFront;
+        key = (key << kShaderBits) | shader;
+        key = (key << kTextureSetBits) | textureSet;
+        key = (key << kMeshBits) | mesh;
+    }
+
+    return key;
+}
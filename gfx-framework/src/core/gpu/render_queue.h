@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/glm_utils.h"
+
+
+class Mesh;
+class Shader;
+class Texture2D;
+
+
+// One deferred draw call. The textures are bound to consecutive texture
+// units, starting with GL_TEXTURE0, and unused slots are null. Meshes that
+// use their materials (see Mesh::UseMaterials) bind their own texture to
+// the first unit when drawn.
+struct DrawPacket
+{
+    static const unsigned int kMaxTextures = 4U;
+
+    const Mesh *mesh;
+    Shader *shader;
+    Texture2D *textures[kMaxTextures];
+    glm::mat4 model;
+    bool blend;
+
+    // Packets are drawn pass by pass, in increasing order
+    unsigned int pass;
+};
+
+
+// Number of draws and of state changes done to draw them
+struct RenderQueueStats
+{
+    unsigned int draws;
+    unsigned int programChanges;
+    unsigned int meshChanges;
+    unsigned int textureChanges;
+    unsigned int blendChanges;
+
+    unsigned int GetStateChanges() const;
+};
+
+
+// State that has to be set before drawing a packet, given the previous ones
+struct RenderStateChange
+{
+    bool program;
+    bool mesh;
+    bool blend;
+
+    // Bit i is set if texture unit i has to be bound
+    unsigned int textureMask;
+};
+
+
+// Run of consecutive sorted packets that only differ by their model
+// matrix, so they can be drawn with one instanced draw call
+struct DrawBatch
+{
+    unsigned int first;
+    unsigned int count;
+};
+
+
+// Follows the state set by a sequence of draws, to set only what differs
+// from one draw to the next, and counts the changes
+class RenderStateTracker
+{
+ public:
+    RenderStateTracker();
+
+    RenderStateChange Apply(const DrawPacket &packet);
+
+    // For textures bound outside of the tracker
+    void ForgetTexture(unsigned int unit);
+
+    const RenderQueueStats& GetStats() const;
+
+ private:
+    const Shader *shader;
+    const Mesh *mesh;
+    const Texture2D *textures[DrawPacket::kMaxTextures];
+    bool blend;
+
+    RenderQueueStats stats;
+};
+
+
+// Collects the draws of a frame and sorts them by a 64-bit key, so that
+// the program, the VAO and the textures only change once per group:
+//
+//      opaque:     pass | 0 | shader | texture set | mesh | depth
+//      blended:    pass | 1 | depth  | shader | texture set | mesh
+//
+// Opaque draws are sorted front to back within a group, blended draws back
+// to front before anything else, since their order changes the image.
+// Shaders, texture sets and meshes get small ids in the order they are
+// first submitted. After sorting, runs of packets with the same pass,
+// blending, shader, textures and mesh are grouped into batches, and the
+// model matrices are gathered in draw order, ready to be uploaded for
+// instanced drawing. The queue does not call OpenGL, the draws are issued
+// by its user (see SimpleScene::FlushRenderQueue).
+class RenderQueue
+{
+ public:
+    static const unsigned int kMaxPasses = 16U;
+
+    RenderQueue();
+
+    void Submit(const DrawPacket &packet);
+
+    // Sorts the packets, with the depth measured along the view direction
+    // of `view`, and computes the statistics of both orders
+    void Sort(const glm::mat4 &view);
+
+    // Removes the packets. The statistics of the last sort are kept.
+    void Clear();
+
+    unsigned int GetSize() const;
+    const DrawPacket& GetPacket(unsigned int index) const;
+
+    // Packets in draw order, valid after Sort()
+    const DrawPacket& GetSortedPacket(unsigned int index) const;
+
+    // Model matrices of the packets in draw order, and batches of the
+    // sorted packets, valid after Sort()
+    const std::vector<glm::mat4>& GetSortedModels() const;
+    const std::vector<DrawBatch>& GetBatches() const;
+
+    const RenderQueueStats& GetStats() const;
+    const RenderQueueStats& GetUnsortedStats() const;
+    unsigned int GetSavedStateChanges() const;
+
+ private:
+    struct TextureSet
+    {
+        const Texture2D *textures[DrawPacket::kMaxTextures];
+
+        bool operator==(const TextureSet &other) const;
+    };
+
+    struct TextureSetHash
+    {
+        std::size_t operator()(const TextureSet &set) const;
+    };
+
+    static bool IsSameBatch(const DrawPacket &a, const DrawPacket &b);
+
+    struct SortEntry
+    {
+        std::uint64_t key;
+        unsigned int index;
+    };
+
+    unsigned int GetShaderId(const Shader *shader);
+    unsigned int GetMeshId(const Mesh *mesh);
+    unsigned int GetTextureSetId(const DrawPacket &packet);
+
+    std::uint64_t ComputeKey(const DrawPacket &packet, const glm::mat4 &view);
+
+ private:
+    std::vector<DrawPacket> packets;
+    std::vector<SortEntry> entries;
+    std::vector<SortEntry> scratchEntries;
+    std::vector<const DrawPacket *> sortedPackets;
+    std::vector<glm::mat4> sortedModels;
+    std::vector<DrawBatch> batches;
+
+    std::unordered_map<const Shader *, unsigned int> shaderIds;
+    std::unordered_map<const Mesh *, unsigned int> meshIds;
+    std::unordered_map<TextureSet, unsigned int, TextureSetHash> textureSetIds;
+
+    RenderQueueStats stats;
+    RenderQueueStats unsortedStats;
+};
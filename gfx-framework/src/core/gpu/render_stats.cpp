@@ -0,0 +1,58 @@
+#include "core/gpu/render_stats.h"
+
+
+static RenderStats stats = {};
+
+
+void render_stats::AddDraw(GLenum mode, unsigned int indexCount, unsigned int instanceCount)
+{
+    unsigned long long triangles = 0;
+    switch (mode)
+    {
+    case GL_TRIANGLES:
+        triangles = indexCount / 3;
+        break;
+    case GL_TRIANGLE_STRIP:
+    case GL_TRIANGLE_FAN:
+        triangles = indexCount > 2 ? indexCount - 2 : 0;
+        break;
+    default:
+        break;
+    }
+
+    stats.drawCalls++;
+    stats.triangles += triangles * instanceCount;
+}
+
+
+void render_stats::AddTextureMemory(long long bytes)
+{
+    stats.textureBytes += bytes;
+}
+
+
+void render_stats::AddBufferMemory(long long bytes)
+{
+    stats.bufferBytes += bytes;
+}
+
+
+void render_stats::AddShaderPrograms(int count)
+{
+    stats.shaderPrograms += count;
+}
+
+
+const RenderStats& render_stats::Get()
+{
+    return stats;
+}
+
+
+RenderStats render_stats::EndFrame()
+{
+    const RenderStats frame = stats;
+    stats.drawCalls = 0;
+    stats.triangles = 0;
+    return frame;
+}
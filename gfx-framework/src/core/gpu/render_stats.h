@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+
+#include "utils/gl_utils.h"
+
+
+// Counters kept by the framework's own GPU classes: the draw calls and
+// triangles of the current frame, issued through Mesh, DebugDrawBuffer and
+// TextRenderer, and the memory and programs allocated through Texture2D,
+// TextureArray, GPUBuffers, SSBO, DebugDrawBuffer and Shader. Calls made
+// directly to OpenGL are not counted. The counters are only updated from
+// the thread that owns the OpenGL context.
+struct RenderStats
+{
+    unsigned int drawCalls;
+    unsigned long long triangles;
+
+    long long textureBytes;
+    long long bufferBytes;
+    int shaderPrograms;
+};
+
+
+namespace render_stats
+{
+    // `indexCount` vertices drawn `instanceCount` times with `mode`
+    void AddDraw(GLenum mode, unsigned int indexCount, unsigned int instanceCount = 1);
+
+    // Negative to release memory or programs
+    void AddTextureMemory(long long bytes);
+    void AddBufferMemory(long long bytes);
+    void AddShaderPrograms(int count);
+
+    const RenderStats& Get();
+
+    // Returns the counters, then resets the draw calls and the triangles
+    // for the next frame
+    RenderStats EndFrame();
+}
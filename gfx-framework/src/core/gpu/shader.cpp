@@ -3,10 +3,16 @@
 #include <fstream>
 #include <iostream>
 
+#include "core/cpu_profiler.h"
+#include "core/gpu/camera_uniform_buffer.h"
+#include "core/gpu/render_stats.h"
+
 
 Shader::Shader(const std::string &name)
 {
     program = 0;
+    loc_instance_base = INVALID_LOC;
+    camera_block_index = GL_INVALID_INDEX;
     shaderName = name;
     shaderFiles.reserve(5);
 }
@@ -14,6 +20,8 @@ Shader::Shader(const std::string &name)
 
 Shader::~Shader()
 {
+    if (program)
+        render_stats::AddShaderPrograms(-1);
     glDeleteProgram(program);
 }
 
@@ -44,6 +52,7 @@ unsigned int Shader::Reload()
 {
     if (program) {
         glDeleteProgram(program);
+        render_stats::AddShaderPrograms(-1);
         program = 0;
     }
 
@@ -66,6 +75,18 @@ GLint Shader::GetUniformLocation(const char *uniformName) const
 }
 
 
+bool Shader::UsesCameraBlock() const
+{
+    return camera_block_index != GL_INVALID_INDEX;
+}
+
+
+bool Shader::UsesInstancing() const
+{
+    return loc_instance_base != INVALID_LOC;
+}
+
+
 void Shader::OnLoad(std::function<void()> onLoad)
 {
     loadObservers.push_back(onLoad);
@@ -78,6 +99,7 @@ void Shader::GetUniforms()
     loc_model_matrix        = GetUniformLocation("Model");
     loc_view_matrix         = GetUniformLocation("View");
     loc_projection_matrix   = GetUniformLocation("Projection");
+    loc_instance_base       = GetUniformLocation("InstanceBase");
 
     // Lighting and shadows
     loc_light_pos           = GetUniformLocation("light_position");
@@ -94,6 +116,11 @@ void Shader::GetUniforms()
     // General
     loc_resolution          = GetUniformLocation("resolution");
 
+    // Uniform blocks
+    camera_block_index      = glGetUniformBlockIndex(program, CameraUniformBuffer::kBlockName);
+    if (camera_block_index != GL_INVALID_INDEX)
+        glUniformBlockBinding(program, camera_block_index, CameraUniformBuffer::kBindingPoint);
+
     char buffer[64];
 
     // Textures
@@ -129,13 +156,21 @@ void Shader::AddShaderCode(const std::string &shaderCode, GLenum shaderType)
 }
 
 
+void Shader::AddDefine(const std::string &name)
+{
+    defines.push_back(name);
+}
+
+
 unsigned int Shader::CreateAndLink()
 {
+    PROFILE_ZONE("Shader::CreateAndLink");
+
     std::vector<unsigned int> shaders;
 
     // Compile shaders
     for (auto S : shaderFiles) {
-        auto shaderID = Shader::CreateShader(S.file, S.type);
+        auto shaderID = Shader::CreateShader(S.file, S.type, defines);
         if (shaderID) {
             shaders.push_back(shaderID);
         } else {
@@ -159,6 +194,7 @@ unsigned int Shader::CreateAndLink()
 
         if (program)
         {
+            render_stats::AddShaderPrograms(1);
             glUseProgram(program);
             GetUniforms();
             for (auto Observer : loadObservers) {
@@ -177,7 +213,7 @@ void Shader::ClearShaders()
 }
 
 
-static std::string InjectDefines(const std::string &shaderCode)
+static std::string InjectDefines(const std::string &shaderCode, const std::vector<std::string> &names)
 {
     std::string defines;
     size_t pos = shaderCode.find_first_of("\n");
@@ -186,6 +222,11 @@ static std::string InjectDefines(const std::string &shaderCode)
     defines += "\n#define SOLVED";
 #endif
 
+    for (const std::string &name : names)
+    {
+        defines += "\n#define " + name;
+    }
+
     if (pos == std::string::npos)
     {
         return shaderCode + defines;
@@ -195,7 +236,7 @@ static std::string InjectDefines(const std::string &shaderCode)
 }
 
 
-unsigned int Shader::CreateShader(const std::string &shaderFile, GLenum shaderType)
+unsigned int Shader::CreateShader(const std::string &shaderFile, GLenum shaderType, const std::vector<std::string> &defines)
 {
     std::string shader_code;
     std::ifstream file(shaderFile.c_str(), std::ios::in);
@@ -214,7 +255,7 @@ unsigned int Shader::CreateShader(const std::string &shaderFile, GLenum shaderTy
     file.read(&shader_code[0], shader_code.size());
     file.close();
 
-    return CompileShader(InjectDefines(shader_code), shaderType);
+    return CompileShader(InjectDefines(shader_code, defines), shaderType);
 }
 
 
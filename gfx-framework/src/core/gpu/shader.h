@@ -26,17 +26,31 @@ class Shader
 
     void AddShader(const std::string &shaderFile, GLenum shaderType);
     void AddShaderCode(const std::string &shaderCode, GLenum shaderType);
+
+    // Defines a macro at the top of the shader files, after the #version
+    // line. Takes effect the next time the program is linked.
+    void AddDefine(const std::string &name);
     void ClearShaders();
     unsigned int CreateAndLink();
 
     void BindTexturesUnits();
     GLint GetUniformLocation(const char * uniformName) const;
 
+    // True if the program declares the CameraBlock uniform block. It is then
+    // bound to CameraUniformBuffer::kBindingPoint, and the View and
+    // Projection uniforms do not need to be set per draw.
+    bool UsesCameraBlock() const;
+
+    // True if the program reads its model matrices from InstanceBuffer,
+    // which shaders opt in to with the INSTANCED macro. Draws with such a
+    // program set the InstanceBase uniform instead of Model.
+    bool UsesInstancing() const;
+
     void OnLoad(std::function<void()> onLoad);
 
  private:
     void GetUniforms();
-    static unsigned int CreateShader(const std::string &shaderFile, GLenum shaderType);
+    static unsigned int CreateShader(const std::string &shaderFile, GLenum shaderType, const std::vector<std::string> &defines);
     static unsigned int CompileShader(const std::string shaderCode, GLenum shaderType);
     static unsigned int CreateProgram(const std::vector<unsigned int> &shaderObjects);
 
@@ -50,6 +64,7 @@ class Shader
     GLint loc_model_matrix;
     GLint loc_view_matrix;
     GLint loc_projection_matrix;
+    GLint loc_instance_base;
 
     // Shadow
     GLint loc_light_pos;
@@ -65,6 +80,9 @@ class Shader
 
     // General
     GLint loc_resolution;
+
+    // Uniform blocks
+    GLuint camera_block_index;
         
     // Text
     GLint text_color;
@@ -79,5 +97,6 @@ class Shader
     std::string shaderName;
     std::vector<ShaderFile> shaderFiles;
     std::vector<ShaderFile> shaderCodes;
+    std::vector<std::string> defines;
     std::list<std::function<void()>> loadObservers;
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/gpu/render_stats.h"
 #include "utils/gl_utils.h"
 #include "utils/memory_utils.h"
 
@@ -13,6 +14,7 @@ class SSBO
         this->size = size;
         memorySize = size * sizeof(StorageEntry);
         data = createLocalBuffer ? new StorageEntry[size] : nullptr;
+        allocatedMemory = 0;
 
         #ifdef GLEW_ARB_shader_storage_buffer_object
         {
@@ -20,6 +22,8 @@ class SSBO
             Bind();
             glBufferData(GL_SHADER_STORAGE_BUFFER, memorySize, NULL, GL_DYNAMIC_DRAW);
             Unbind();
+            allocatedMemory = memorySize;
+            render_stats::AddBufferMemory(allocatedMemory);
         }
         #endif
     }
@@ -27,6 +31,7 @@ class SSBO
     ~SSBO()
     {
         glDeleteBuffers(1, &ssbo);
+        render_stats::AddBufferMemory(-static_cast<long long>(allocatedMemory));
         SAFE_FREE_ARRAY(data);
     };
 
@@ -101,5 +106,7 @@ class SSBO
     unsigned int ssbo;
     unsigned int size;
     unsigned int memorySize;
+    // Bytes counted in render_stats, zero when the buffer was not created
+    unsigned int allocatedMemory;
     StorageEntry *data;
 };
@@ -0,0 +1,54 @@
+#include "core/gpu/streaming_buffer.h"
+
+#include "core/gpu/render_stats.h"
+
+
+StreamingBuffer::StreamingBuffer(unsigned int elementSize)
+{
+    this->elementSize = elementSize;
+    capacity = 0;
+
+    glGenBuffers(1, &vbo);
+}
+
+
+StreamingBuffer::~StreamingBuffer()
+{
+    glDeleteBuffers(1, &vbo);
+    render_stats::AddBufferMemory(-static_cast<long long>(capacity) * elementSize);
+}
+
+
+void StreamingBuffer::Orphan(unsigned int count)
+{
+    const unsigned int previousCapacity = capacity;
+    while (capacity < count)
+        capacity = capacity ? 2 * capacity : 1024U;
+    render_stats::AddBufferMemory(static_cast<long long>(capacity - previousCapacity) * elementSize);
+
+    // Without data, glBufferData orphans the storage instead of waiting
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(capacity) * elementSize, NULL, GL_STREAM_DRAW);
+}
+
+
+void StreamingBuffer::SetData(unsigned int first, const void *elements, unsigned int count) const
+{
+    if (count == 0)
+        return;
+
+    glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(first) * elementSize,
+                    static_cast<GLsizeiptr>(count) * elementSize, elements);
+}
+
+
+void StreamingBuffer::Bind() const
+{
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+}
+
+
+unsigned int StreamingBuffer::GetCapacity() const
+{
+    return capacity;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "utils/gl_utils.h"
+
+
+// Vertex buffer whose content is replaced every frame. Its storage grows by
+// powers of two, and is orphaned before each upload, so the upload does not
+// wait for the draws of the previous frame that still read it. The storage
+// is counted in the buffer memory of render_stats.
+class StreamingBuffer
+{
+ public:
+    explicit StreamingBuffer(unsigned int elementSize);
+    ~StreamingBuffer();
+
+    StreamingBuffer(const StreamingBuffer &) = delete;
+    StreamingBuffer& operator=(const StreamingBuffer &) = delete;
+
+    // Binds the buffer to GL_ARRAY_BUFFER and replaces its storage by one
+    // that holds at least `count` elements. The elements are then written
+    // with SetData, while the buffer is still bound.
+    void Orphan(unsigned int count);
+    void SetData(unsigned int first, const void *elements, unsigned int count) const;
+
+    void Bind() const;
+    unsigned int GetCapacity() const;
+
+ private:
+    GLuint vbo;
+    unsigned int elementSize;
+    unsigned int capacity;
+};
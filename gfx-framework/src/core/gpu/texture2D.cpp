@@ -1,6 +1,5 @@
 #include "core/gpu/texture2D.h"
 
-#include <thread>
 #include <iostream>
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -8,16 +7,11 @@
 #include "stb/stb_image.h"
 #include "stb/stb_image_write.h"
 
+#include "core/cpu_profiler.h"
+#include "core/gpu/render_stats.h"
 #include "utils/memory_utils.h"
 
 
-void write_image_thread(const char* fileName, unsigned int width, unsigned int height, unsigned int channels, const unsigned char *data)
-{
-    stbi_write_png(fileName, width, height, channels, data, width * channels);
-    delete data;
-}
-
-
 const GLint pixelFormat[5] = { 0, GL_RED, GL_RG, GL_RGB, GL_RGBA };
 const GLint internalFormat[][5] = {
     { 0, GL_R8, GL_RG8, GL_RGB8, GL_RGBA8 },
@@ -35,6 +29,7 @@ Texture2D::Texture2D()
     textureID = 0;
     bitsPerPixel = 8;
     cacheInMemory = false;
+    gpuMemory = 0;
     targetType = GL_TEXTURE_2D;
     wrappingMode = GL_REPEAT;
     textureMinFilter = GL_LINEAR;
@@ -63,6 +58,8 @@ void Texture2D::Init(GLuint gpuTextureID, unsigned int width, unsigned int heigh
 
 bool Texture2D::Load2D(const char *fileName, GLenum wrapping_mode)
 {
+    PROFILE_ZONE("Texture2D::Load2D");
+
     int width, height, chn;
     imageData = stbi_load(fileName, &width, &height, &chn, 0);
 
@@ -84,6 +81,9 @@ bool Texture2D::Load2D(const char *fileName, GLenum wrapping_mode)
     Init2DTexture(width, height, chn);
     glTexImage2D(targetType, 0, internalFormat[0][chn], width, height, 0, pixelFormat[chn], GL_UNSIGNED_BYTE, imageData);
     glGenerateMipmap(targetType);
+
+    // The mipmaps add a third
+    SetGpuMemory(4LL * width * height * chn / 3);
     glBindTexture(targetType, 0);
     CheckOpenGLError();
 
@@ -137,6 +137,7 @@ void Texture2D::Create(const unsigned char *img, int width, int height, int chn)
 {
     Init2DTexture(width, height, chn);
     glTexImage2D(targetType, 0, internalFormat[0][chn], width, height, 0, pixelFormat[chn], GL_UNSIGNED_BYTE, (void *)img);
+    SetGpuMemory(1LL * width * height * chn);
     UnBind();
 }
 
@@ -145,6 +146,7 @@ void Texture2D::CreateU16(const unsigned int *img, int width, int height, int ch
 {
     Init2DTexture(width, height, chn);
     glTexImage2D(targetType, 0, internalFormat[1][chn], width, height, 0, pixelFormat[chn], GL_UNSIGNED_INT, (void *)img);
+    SetGpuMemory(2LL * width * height * chn);
     UnBind();
 }
 
@@ -157,6 +159,7 @@ void Texture2D::CreateCubeTexture(const float *data, unsigned int width, unsigne
 
     glDeleteTextures(1, &textureID);
     glGenTextures(1, &textureID);
+    SetGpuMemory(6LL * 4 * width * height * chn);
 
     glBindTexture(targetType, textureID);
     glTexParameteri(targetType, GL_TEXTURE_MIN_FILTER, textureMinFilter);
@@ -184,6 +187,7 @@ void Texture2D::CreateFrameBufferTexture(unsigned int width, unsigned int height
     int prec = precision / 8 - 1;
     Init2DTexture(width, height, 4);
     glTexImage2D(targetType, 0, internalFormat[prec][4], width, height, 0, pixelFormat[4], GL_UNSIGNED_BYTE, 0);
+    SetGpuMemory(1LL * width * height * 4 * (precision / 8));
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + targetID, GL_TEXTURE_2D, textureID, 0);
     UnBind();
 }
@@ -193,6 +197,7 @@ void Texture2D::CreateDepthBufferTexture(unsigned int width, unsigned int height
 {
     Init2DTexture(width, height, 1);
     glTexImage2D(targetType, 0, GL_DEPTH_COMPONENT32F, width, height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE, 0);
+    SetGpuMemory(4LL * width * height);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, textureID, 0);
     UnBind();
 }
@@ -309,9 +314,18 @@ void Texture2D::Init2DTexture(unsigned int width, unsigned int height, unsigned
 
     if (textureID)
         glDeleteTextures(1, &textureID);
+    SetGpuMemory(0);
+
     glGenTextures(1, &textureID);
     glBindTexture(targetType, textureID);
     SetTextureParameters();
     glPixelStorei(GL_PACK_ALIGNMENT, 1);
     CheckOpenGLError();
 }
+
+
+void Texture2D::SetGpuMemory(long long bytes)
+{
+    render_stats::AddTextureMemory(bytes - gpuMemory);
+    gpuMemory = bytes;
+}
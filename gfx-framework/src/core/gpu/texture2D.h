@@ -44,8 +44,12 @@ class Texture2D
     void SetTextureParameters();
     void Init2DTexture(unsigned int width, unsigned int height, unsigned int channels);
 
+    // Estimated size of the texture on the GPU, reported to render_stats
+    void SetGpuMemory(long long bytes);
+
  private:
     bool cacheInMemory;
+    long long gpuMemory;
     unsigned int bitsPerPixel;
     unsigned int width;
     unsigned int height;
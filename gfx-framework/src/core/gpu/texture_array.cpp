@@ -0,0 +1,93 @@
+#include "core/gpu/texture_array.h"
+
+#include "core/gpu/render_stats.h"
+#include "core/gpu/texture2D.h"
+
+
+TextureArray::TextureArray()
+{
+    textureID = 0;
+    layerCount = 0;
+    gpuMemory = 0;
+}
+
+
+TextureArray::~TextureArray()
+{
+    if (textureID)
+        glDeleteTextures(1, &textureID);
+    render_stats::AddTextureMemory(-gpuMemory);
+}
+
+
+bool TextureArray::Create(const std::vector<const Texture2D *> &textures)
+{
+    if (textures.empty())
+        return false;
+
+    const unsigned int width = textures[0]->GetWidth();
+    const unsigned int height = textures[0]->GetHeight();
+
+    for (const Texture2D *texture : textures)
+    {
+        if (!texture->GetTextureID() || texture->GetWidth() != width || texture->GetHeight() != height)
+            return false;
+    }
+
+    if (textureID)
+        glDeleteTextures(1, &textureID);
+
+    layerCount = static_cast<unsigned int>(textures.size());
+
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, layerCount, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+    // RGBA layers, and a third more for the mipmaps
+    render_stats::AddTextureMemory(-gpuMemory);
+    gpuMemory = 4LL * 4 * width * height * layerCount / 3;
+    render_stats::AddTextureMemory(gpuMemory);
+
+    // The textures are read back from the GPU, since their images are
+    // usually not kept in memory (see Texture2D::CacheInMemory), and
+    // converted to RGBA on the way. RGBA rows are always 4-byte aligned.
+    std::vector<unsigned char> pixels(width * height * 4);
+
+    for (unsigned int layer = 0; layer < layerCount; layer++)
+    {
+        textures[layer]->Bind();
+        glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    CheckOpenGLError();
+
+    return true;
+}
+
+
+void TextureArray::BindToTextureUnit(GLenum textureUnit) const
+{
+    if (!textureID) return;
+    glActiveTexture(textureUnit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, textureID);
+}
+
+
+unsigned int TextureArray::GetLayerCount() const
+{
+    return layerCount;
+}
+
+
+GLuint TextureArray::GetTextureID() const
+{
+    return textureID;
+}
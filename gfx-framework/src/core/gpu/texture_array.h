@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+
+#include "utils/gl_utils.h"
+
+
+class Texture2D;
+
+
+// Textures of the same size packed in the layers of a GL_TEXTURE_2D_ARRAY,
+// so that a model drawn with several of them binds a single texture. The
+// layer is selected in the shader, with the third texture coordinate:
+//
+//      uniform sampler2DArray u_texture_0;
+//      ... texture(u_texture_0, vec3(tex_coord, layer)) ...
+//
+// See assets/shaders/TextureArray.FS.glsl.
+class TextureArray
+{
+ public:
+    TextureArray();
+    ~TextureArray();
+
+    TextureArray(const TextureArray &) = delete;
+    TextureArray& operator=(const TextureArray &) = delete;
+
+    // Copies the textures in the layers, in order, as RGBA. Fails, without
+    // creating anything, if the textures do not all have the same size.
+    bool Create(const std::vector<const Texture2D *> &textures);
+
+    void BindToTextureUnit(GLenum textureUnit) const;
+
+    unsigned int GetLayerCount() const;
+    GLuint GetTextureID() const;
+
+ private:
+    GLuint textureID;
+    unsigned int layerCount;
+    long long gpuMemory;
+};
@@ -0,0 +1,326 @@
+#include "core/job_system.h"
+
+#include <algorithm>
+
+
+// Number of times an idle worker looks for a job before it sleeps
+static const unsigned int kSpinCount = 64;
+
+// Pool and queue of the worker running on this thread, if any
+static thread_local const JobSystem *currentSystem = nullptr;
+static thread_local unsigned int currentQueue = 0;
+
+
+JobCounter::JobCounter()
+    : count(0)
+{
+}
+
+
+bool JobCounter::IsDone() const
+{
+    return count.load() == 0;
+}
+
+
+JobSystem::JobSystem(unsigned int threadCount)
+    : mainThreadId(std::this_thread::get_id()),
+      queues(std::max(threadCount ? threadCount : std::thread::hardware_concurrency(), 1U)),
+      queuedJobs(0),
+      sleepingWorkers(0),
+      stop(false)
+{
+    // The calling thread is the first one
+    for (unsigned int i = 1; i < queues.size(); i++)
+        threads.push_back(std::thread(&JobSystem::WorkerLoop, this, i));
+}
+
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stop = true;
+    }
+    wakeCondition.notify_all();
+
+    // The workers run the jobs left in the queues before they quit
+    for (std::thread &thread : threads)
+        thread.join();
+
+    // Then the main thread runs the jobs they left for it, such as the
+    // uploads of the meshes they read. The jobs started from here on run
+    // right away, since there are no workers anymore.
+    threads.clear();
+
+    Job job;
+    while (PopMainThread(job) || Pop(0, job) || Steal(0, job))
+        Execute(job);
+}
+
+
+unsigned int JobSystem::GetThreadCount() const
+{
+    return static_cast<unsigned int>(queues.size());
+}
+
+
+bool JobSystem::IsMainThread() const
+{
+    return std::this_thread::get_id() == mainThreadId;
+}
+
+
+void JobSystem::Run(const std::function<void()> &job, JobCounter *counter, JobAffinity affinity)
+{
+    if (counter)
+        counter->count++;
+
+    Push(Job{ job, counter }, affinity);
+}
+
+
+void JobSystem::RunAfter(JobCounter &dependency, const std::function<void()> &job, JobCounter *counter, JobAffinity affinity)
+{
+    if (counter)
+        counter->count++;
+
+    {
+        std::lock_guard<std::mutex> lock(dependency.mutex);
+        if (dependency.count.load() > 0)
+        {
+            dependency.continuations.push_back(JobCounter::Continuation{ job, counter, affinity });
+            return;
+        }
+    }
+
+    Push(Job{ job, counter }, affinity);
+}
+
+
+void JobSystem::Wait(JobCounter &counter)
+{
+    const unsigned int index = GetQueueIndex();
+    const bool mainThread = IsMainThread();
+
+    while (counter.count.load() > 0)
+    {
+        Job job;
+        if (Pop(index, job) || (mainThread && PopMainThread(job)) || Steal(index, job))
+            Execute(job);
+        else
+            std::this_thread::yield();
+    }
+
+    // The last job may still be releasing the counter
+    std::lock_guard<std::mutex> lock(counter.mutex);
+}
+
+
+void JobSystem::ParallelFor(unsigned int begin, unsigned int end, unsigned int grainSize,
+                            const std::function<void(unsigned int, unsigned int)> &func)
+{
+    if (begin >= end)
+        return;
+
+    if (grainSize == 0)
+    {
+        const unsigned int ranges = 4 * GetThreadCount();
+        grainSize = std::max((end - begin + ranges - 1) / ranges, 1U);
+    }
+
+    const unsigned int firstEnd = end - begin > grainSize ? begin + grainSize : end;
+
+    JobCounter counter;
+    for (unsigned int first = firstEnd; first < end;)
+    {
+        const unsigned int last = end - first > grainSize ? first + grainSize : end;
+        Run([&func, first, last]() { func(first, last); }, &counter);
+        first = last;
+    }
+
+    func(begin, firstEnd);
+    Wait(counter);
+}
+
+
+unsigned int JobSystem::RunMainThreadJobs()
+{
+    // Jobs started by these ones wait for the next call
+    unsigned int count = 0;
+    {
+        std::lock_guard<std::mutex> lock(mainThreadQueue.mutex);
+        count = static_cast<unsigned int>(mainThreadQueue.jobs.size());
+    }
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        Job job;
+        if (!PopMainThread(job))
+            return i;
+        Execute(job);
+    }
+
+    return count;
+}
+
+
+void JobSystem::WorkerLoop(unsigned int index)
+{
+    currentSystem = this;
+    currentQueue = index;
+
+    unsigned int spins = 0;
+    while (true)
+    {
+        Job job;
+        if (queuedJobs.load() > 0 && (Pop(index, job) || Steal(index, job)))
+        {
+            Execute(job);
+            spins = 0;
+            continue;
+        }
+
+        if (stop)
+            break;
+
+        if (++spins < kSpinCount)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        spins = 0;
+
+        // Push reads the number of sleeping workers after it queues a job,
+        // and the worker reads the number of queued jobs after it counts
+        // itself, so one of them sees the other
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepingWorkers++;
+        wakeCondition.wait(lock, [this]() { return stop || queuedJobs.load() > 0; });
+        sleepingWorkers--;
+    }
+
+    currentSystem = nullptr;
+}
+
+
+unsigned int JobSystem::GetQueueIndex() const
+{
+    return currentSystem == this ? currentQueue : 0;
+}
+
+
+void JobSystem::Push(Job &&job, JobAffinity affinity)
+{
+    if (affinity == JobAffinity::MainThread)
+    {
+        std::lock_guard<std::mutex> lock(mainThreadQueue.mutex);
+        mainThreadQueue.jobs.push_back(std::move(job));
+        return;
+    }
+
+    if (threads.empty())
+    {
+        Execute(job);
+        return;
+    }
+
+    Queue &queue = queues[GetQueueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    queuedJobs++;
+
+    if (sleepingWorkers.load() > 0)
+    {
+        // Makes sure the worker is either waiting, or has not checked the
+        // number of queued jobs yet
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        wakeCondition.notify_one();
+    }
+}
+
+
+bool JobSystem::Pop(unsigned int index, Job &job)
+{
+    Queue &queue = queues[index];
+
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty())
+        return false;
+
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    queuedJobs--;
+    return true;
+}
+
+
+bool JobSystem::Steal(unsigned int thief, Job &job)
+{
+    const unsigned int count = static_cast<unsigned int>(queues.size());
+
+    for (unsigned int i = 1; i < count && queuedJobs.load() > 0; i++)
+    {
+        Queue &queue = queues[(thief + i) % count];
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty())
+            continue;
+
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        queuedJobs--;
+        return true;
+    }
+
+    return false;
+}
+
+
+bool JobSystem::PopMainThread(Job &job)
+{
+    std::lock_guard<std::mutex> lock(mainThreadQueue.mutex);
+    if (mainThreadQueue.jobs.empty())
+        return false;
+
+    job = std::move(mainThreadQueue.jobs.front());
+    mainThreadQueue.jobs.pop_front();
+    return true;
+}
+
+
+void JobSystem::Execute(Job &job)
+{
+    job.function();
+    Finish(job.counter);
+}
+
+
+void JobSystem::Finish(JobCounter *counter)
+{
+    if (!counter)
+        return;
+
+    // Other jobs are left, so nobody can be done waiting for the counter
+    unsigned int count = counter->count.load();
+    while (count > 1)
+    {
+        if (counter->count.compare_exchange_weak(count, count - 1))
+            return;
+    }
+
+    std::vector<JobCounter::Continuation> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter->mutex);
+        if (counter->count.fetch_sub(1) == 1)
+            continuations.swap(counter->continuations);
+    }
+
+    // The counter may be gone by now
+    for (JobCounter::Continuation &continuation : continuations)
+        Push(Job{ std::move(continuation.job), continuation.counter }, continuation.affinity);
+}
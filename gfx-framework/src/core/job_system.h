@@ -0,0 +1,159 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Where a job may run. Jobs that use OpenGL must run on the main thread,
+// the one that created the JobSystem, since it owns the context.
+enum class JobAffinity
+{
+    Any,
+    MainThread
+};
+
+
+// Number of unfinished jobs started with it. A job can wait for a counter
+// with JobSystem::Wait, or be started once it reaches zero with
+// JobSystem::RunAfter. The counter must outlive the jobs started with it,
+// and the jobs that depend on it.
+class JobCounter
+{
+    friend class JobSystem;
+
+ public:
+    JobCounter();
+
+    JobCounter(const JobCounter &) = delete;
+    JobCounter& operator=(const JobCounter &) = delete;
+
+    bool IsDone() const;
+
+ private:
+    struct Continuation
+    {
+        std::function<void()> job;
+        JobCounter *counter;
+        JobAffinity affinity;
+    };
+
+ private:
+    std::atomic<unsigned int> count;
+
+    // Guards the jobs waiting for the count to reach zero, and the last
+    // decrement, so that Wait does not return while it is in progress
+    std::mutex mutex;
+    std::vector<Continuation> continuations;
+};
+
+
+// Work-stealing pool of worker threads. Each thread, the main thread
+// included, has its own queue of jobs: it pushes and pops the jobs it
+// starts at the back, where they are still in its cache, and idle threads
+// steal from the front of the others, where the oldest and usually largest
+// jobs are. Workers spin for a while before they sleep, so that the jobs
+// of a frame do not pay for waking them up.
+//
+// Jobs with the main thread affinity are kept in their own queue, run by
+// RunMainThreadJobs, which World calls once a frame, and by Wait on the
+// main thread.
+//
+//      JobCounter loaded;
+//      for (const std::string &path : paths)
+//          jobs->Run([&]() { Decode(path); }, &loaded);
+//      jobs->RunAfter(loaded, [&]() { Upload(); }, nullptr, JobAffinity::MainThread);
+//
+// Engine::GetJobSystem returns the pool of the application.
+class JobSystem
+{
+ public:
+    // The thread count includes the calling thread, which becomes the main
+    // thread. Zero means one thread for every hardware thread.
+    explicit JobSystem(unsigned int threadCount = 0);
+
+    // Runs the jobs left, the main thread ones included, so it must be
+    // called on the main thread
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem& operator=(const JobSystem &) = delete;
+
+    unsigned int GetThreadCount() const;
+    bool IsMainThread() const;
+
+    // Starts `job`. When given, `counter` is incremented now and decremented
+    // once the job is done. Without workers, jobs that may run on any thread
+    // run before Run returns.
+    void Run(const std::function<void()> &job, JobCounter *counter = nullptr,
+             JobAffinity affinity = JobAffinity::Any);
+
+    // Starts `job` once `dependency` reaches zero, or now if it is zero.
+    // `counter` is incremented now, so waiting for it also waits for the
+    // dependency.
+    void RunAfter(JobCounter &dependency, const std::function<void()> &job, JobCounter *counter = nullptr,
+                  JobAffinity affinity = JobAffinity::Any);
+
+    // Runs other jobs until `counter` reaches zero. Do not wait on the main
+    // thread jobs from a worker, they only run on the main thread.
+    void Wait(JobCounter &counter);
+
+    // Calls func(first, last) on consecutive ranges of at most `grainSize`
+    // indices, which cover [begin, end), and returns once all of them are
+    // done. The calling thread runs the first range. A zero grain size
+    // makes four ranges per thread.
+    void ParallelFor(unsigned int begin, unsigned int end, unsigned int grainSize,
+                     const std::function<void(unsigned int, unsigned int)> &func);
+
+    // Runs the main thread jobs started so far, and returns their number.
+    // Must be called on the main thread.
+    unsigned int RunMainThreadJobs();
+
+ private:
+    struct Job
+    {
+        std::function<void()> function;
+        JobCounter *counter;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+ private:
+    void WorkerLoop(unsigned int index);
+
+    // Queue of the calling thread, or of the main thread for threads that
+    // are not part of the pool
+    unsigned int GetQueueIndex() const;
+
+    void Push(Job &&job, JobAffinity affinity);
+    bool Pop(unsigned int index, Job &job);
+    bool Steal(unsigned int thief, Job &job);
+    bool PopMainThread(Job &job);
+
+    void Execute(Job &job);
+    void Finish(JobCounter *counter);
+
+ private:
+    std::thread::id mainThreadId;
+    std::vector<std::thread> threads;
+
+    // One per thread, the main thread first
+    std::vector<Queue> queues;
+    Queue mainThreadQueue;
+
+    // Jobs in the queues of the threads, watched by the idle workers
+    std::atomic<unsigned int> queuedJobs;
+
+    std::mutex sleepMutex;
+    std::condition_variable wakeCondition;
+    std::atomic<unsigned int> sleepingWorkers;
+    std::atomic<bool> stop;
+};
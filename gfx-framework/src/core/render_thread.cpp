@@ -0,0 +1,87 @@
+#include "core/render_thread.h"
+
+#include "core/command_list.h"
+#include "core/cpu_profiler.h"
+#include "core/window/window_object.h"
+
+
+RenderThread::RenderThread(WindowObject *window)
+    : window(window)
+{
+    pending = nullptr;
+    busy = false;
+    quit = false;
+
+    window->ReleaseCurrentContext();
+    thread = std::thread(&RenderThread::Run, this);
+}
+
+
+RenderThread::~RenderThread()
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this]() { return !pending && !busy; });
+        quit = true;
+    }
+    condition.notify_all();
+
+    thread.join();
+    window->MakeCurrentContext();
+}
+
+
+void RenderThread::Submit(const CommandList *commands)
+{
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [this]() { return !pending && !busy; });
+        pending = commands;
+    }
+    condition.notify_all();
+}
+
+
+void RenderThread::Finish()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this]() { return !pending && !busy; });
+}
+
+
+void RenderThread::Run()
+{
+    window->MakeCurrentContext();
+
+    while (true)
+    {
+        const CommandList *commands = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return pending || quit; });
+            if (!pending)
+                break;
+
+            commands = pending;
+            pending = nullptr;
+            busy = true;
+        }
+
+        {
+            PROFILE_ZONE("RenderFrame");
+            commands->Execute();
+        }
+        {
+            PROFILE_ZONE("SwapBuffers");
+            window->SwapBuffers();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busy = false;
+        }
+        condition.notify_all();
+    }
+
+    window->ReleaseCurrentContext();
+}
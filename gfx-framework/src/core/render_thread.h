@@ -0,0 +1,48 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+class CommandList;
+class WindowObject;
+
+
+// Thread that owns the OpenGL context of a window. It executes the command
+// list of a frame, then swaps the buffers, while the thread that submitted
+// the list records the next one. At most one frame is in flight, so a frame
+// takes as long as the slower of the two threads instead of their sum.
+//
+// The context is taken from the creating thread, and given back to the
+// thread that destroys the render thread, once the last frame is done.
+class RenderThread
+{
+ public:
+    explicit RenderThread(WindowObject *window);
+    ~RenderThread();
+
+    RenderThread(const RenderThread &) = delete;
+    RenderThread& operator=(const RenderThread &) = delete;
+
+    // Waits until the previous frame has been executed, then hands over
+    // `commands`, which must not change until the next Submit or Finish
+    void Submit(const CommandList *commands);
+
+    // Waits until the submitted frame has been executed
+    void Finish();
+
+ private:
+    void Run();
+
+ private:
+    WindowObject *window;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    const CommandList *pending;
+    bool busy;
+    bool quit;
+
+    std::thread thread;
+};
@@ -0,0 +1,173 @@
+#include "core/window/headless_context.h"
+
+#include <cstdio>
+#include <cstring>
+
+#if defined(WITH_HEADLESS)
+#   include <EGL/egl.h>
+#   include <EGL/eglext.h>
+#endif
+
+
+/*
+ *  Implementation of the opaque EGL handles
+ */
+struct HeadlessContextImpl
+{
+#if defined(WITH_HEADLESS)
+    EGLDisplay display;
+    EGLSurface surface;
+    EGLContext context;
+#endif
+    bool valid;
+};
+
+
+#if defined(WITH_HEADLESS)
+
+// Reports a failed EGL call with the error code of the thread
+static void PrintEglError(const char *message)
+{
+    fprintf(stderr, "Error: %s (EGL error 0x%04X)\n", message, static_cast<unsigned int>(eglGetError()));
+}
+
+
+// Prefers the surfaceless platform of Mesa, which needs neither a display
+// server nor a GPU. Falls back to the default display of the driver.
+static EGLDisplay GetHeadlessDisplay()
+{
+#if defined(EGL_MESA_platform_surfaceless)
+    const char *extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+    if (extensions && strstr(extensions, "EGL_MESA_platform_surfaceless") && getPlatformDisplay)
+    {
+        EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+        if (display != EGL_NO_DISPLAY)
+            return display;
+    }
+#endif
+
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+#endif
+
+
+HeadlessContext::HeadlessContext(glm::ivec2 resolution)
+{
+    impl = new HeadlessContextImpl();
+    impl->valid = false;
+
+#if defined(WITH_HEADLESS)
+    impl->display = GetHeadlessDisplay();
+    impl->surface = EGL_NO_SURFACE;
+    impl->context = EGL_NO_CONTEXT;
+
+    EGLint major, minor;
+    if (impl->display == EGL_NO_DISPLAY || !eglInitialize(impl->display, &major, &minor))
+    {
+        PrintEglError("cannot initialize the EGL display");
+        return;
+    }
+
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_ALPHA_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_NONE
+    };
+
+    EGLConfig config;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(impl->display, configAttribs, &config, 1, &configCount) || configCount == 0)
+    {
+        PrintEglError("no EGL config with pbuffer and OpenGL support");
+        return;
+    }
+
+    const EGLint surfaceAttribs[] = {
+        EGL_WIDTH, resolution.x,
+        EGL_HEIGHT, resolution.y,
+        EGL_NONE
+    };
+
+    impl->surface = eglCreatePbufferSurface(impl->display, config, surfaceAttribs);
+    if (impl->surface == EGL_NO_SURFACE)
+    {
+        PrintEglError("cannot create the EGL pbuffer");
+        return;
+    }
+
+    // Same version and profile as the GLFW windows
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+
+    eglBindAPI(EGL_OPENGL_API);
+    impl->context = eglCreateContext(impl->display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (impl->context == EGL_NO_CONTEXT)
+    {
+        PrintEglError("cannot create the EGL context");
+        return;
+    }
+
+    impl->valid = true;
+    MakeCurrent();
+#else
+    fprintf(stderr, "Error: headless mode needs a build with WITH_HEADLESS\n");
+#endif
+}
+
+
+HeadlessContext::~HeadlessContext()
+{
+#if defined(WITH_HEADLESS)
+    if (impl->display != EGL_NO_DISPLAY)
+    {
+        eglMakeCurrent(impl->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (impl->context != EGL_NO_CONTEXT)
+            eglDestroyContext(impl->display, impl->context);
+        if (impl->surface != EGL_NO_SURFACE)
+            eglDestroySurface(impl->display, impl->surface);
+        eglTerminate(impl->display);
+    }
+#endif
+    delete impl;
+}
+
+
+bool HeadlessContext::IsValid() const
+{
+    return impl->valid;
+}
+
+
+void HeadlessContext::MakeCurrent() const
+{
+#if defined(WITH_HEADLESS)
+    // The bound API is per thread, and is OpenGL ES by default
+    if (impl->valid)
+    {
+        eglBindAPI(EGL_OPENGL_API);
+        eglMakeCurrent(impl->display, impl->surface, impl->surface, impl->context);
+    }
+#endif
+}
+
+
+void HeadlessContext::ReleaseCurrent() const
+{
+#if defined(WITH_HEADLESS)
+    if (impl->valid)
+        eglMakeCurrent(impl->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+#endif
+}
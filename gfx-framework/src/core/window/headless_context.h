@@ -0,0 +1,37 @@
+#pragma once
+
+#include "utils/glm_utils.h"
+
+
+/*
+ *  Opaque EGL handles
+ */
+struct HeadlessContextImpl;
+
+
+// OpenGL 3.3 core context without a window, for build machines and servers
+// that have no display. It is created through EGL, on the surfaceless
+// platform of Mesa when available (which also works with llvmpipe, without
+// a GPU), and renders into a pbuffer of the requested resolution, which
+// acts as the default framebuffer.
+//
+// Only available when built with WITH_HEADLESS, otherwise IsValid() is
+// always false.
+class HeadlessContext
+{
+ public:
+    explicit HeadlessContext(glm::ivec2 resolution);
+    ~HeadlessContext();
+
+    HeadlessContext(const HeadlessContext &) = delete;
+    HeadlessContext& operator=(const HeadlessContext &) = delete;
+
+    bool IsValid() const;
+
+    // On the calling thread. A context is current on one thread at most.
+    void MakeCurrent() const;
+    void ReleaseCurrent() const;
+
+ private:
+    HeadlessContextImpl *impl;
+};
@@ -13,6 +13,9 @@ InputController::InputController()
 
 InputController::~InputController()
 {
+    // Destroyed controllers must not receive the events of the next frames
+    if (isAttached)
+        window->UnsubscribeFromEvents(this);
 }
 
 
@@ -1,8 +1,10 @@
 #include "core/window/window_object.h"
 
+#include <cstdlib>
 #include <iostream>
 
 #include "core/engine.h"
+#include "core/window/headless_context.h"
 #include "core/window/window_callbacks.h"
 #include "core/window/input_controller.h"
 
@@ -16,6 +18,10 @@
 struct WindowDataImpl
 {
     GLFWwindow *handle;
+
+    // Only set in headless mode, where there is no GLFW window
+    HeadlessContext *headless;
+    bool shouldClose;
 };
 
 
@@ -33,6 +39,8 @@ WindowProperties::WindowProperties()
     visible = true;
     hideOnClose = false;
     vSync = true;
+    headless = false;
+    frameLimit = 0;
 }
 
 
@@ -41,6 +49,8 @@ WindowObject::WindowObject(WindowProperties properties)
 {
     window = new WindowDataImpl();
     window->handle = nullptr;
+    window->headless = nullptr;
+    window->shouldClose = false;
 
     resizeEvent = false;
     scrollEvent = false;
@@ -50,6 +60,32 @@ WindowObject::WindowObject(WindowProperties properties)
     deltaFrameTime = 0;
     props.aspectRatio = float(props.resolution.x) / props.resolution.y;
 
+    // Set default state
+    hiddenPointer = false;
+    mouseButtonAction = 0;
+    mouseButtonStates = 0;
+    registeredKeyEvents = 0;
+    keyMods = 0;
+    memset(keyStates, 0, 384);
+    memset(keyScanCode, 0, 512);
+
+    if (props.headless)
+    {
+        props.visible = false;
+        props.fullScreen = false;
+        props.vSync = false;
+
+        window->headless = new HeadlessContext(props.resolution);
+        if (!window->headless->IsValid())
+        {
+            fprintf(stderr, "Error: cannot create the headless OpenGL context\n");
+            exit(EXIT_FAILURE);
+        }
+
+        SetSize(props.resolution.x, props.resolution.y);
+        return;
+    }
+
     // Set context version, meaning 3.3 core profile
     glfwWindowHint(GLFW_VISIBLE, props.visible);
 
@@ -64,20 +100,16 @@ WindowObject::WindowObject(WindowProperties properties)
     props.fullScreen ? FullScreen() : WindowMode();
     SetVSync(props.vSync);
 
-    // Set default state
-    mouseButtonAction = 0;
-    mouseButtonStates = 0;
-    registeredKeyEvents = 0;
-    memset(keyStates, 0, 384);
-    memset(keyScanCode, 0, 512);
-
     SetWindowCallbacks();
 }
 
 
 WindowObject::~WindowObject()
 {
-    glfwDestroyWindow(window->handle);
+    if (window->headless)
+        delete window->headless;
+    else
+        glfwDestroyWindow(window->handle);
     delete window;
 }
 
@@ -85,6 +117,8 @@ WindowObject::~WindowObject()
 void WindowObject::Show()
 {
     props.visible = true;
+    if (props.headless)
+        return;
     glfwShowWindow(window->handle);
     MakeCurrentContext();
 }
@@ -93,6 +127,8 @@ void WindowObject::Show()
 void WindowObject::Hide()
 {
     props.visible = false;
+    if (props.headless)
+        return;
     glfwHideWindow(window->handle);
 }
 
@@ -100,6 +136,8 @@ void WindowObject::Hide()
 void WindowObject::SetVSync(bool state)
 {
     props.vSync = state;
+    if (props.headless)
+        return;
     glfwSwapInterval(state);
 }
 
@@ -113,12 +151,24 @@ bool WindowObject::ToggleVSync()
 
 void WindowObject::Close()
 {
+    if (props.headless)
+    {
+        window->shouldClose = true;
+        return;
+    }
+
     props.hideOnClose ? Hide() : glfwSetWindowShouldClose(window->handle, 1);
 }
 
 
 int WindowObject::ShouldClose() const
 {
+    if (props.frameLimit && frameID >= props.frameLimit)
+        return 1;
+
+    if (props.headless)
+        return window->shouldClose;
+
     return glfwWindowShouldClose(window->handle);
 }
 
@@ -126,27 +176,32 @@ int WindowObject::ShouldClose() const
 void WindowObject::ShowPointer()
 {
     hiddenPointer = false;
-    glfwSetInputMode(window->handle, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+    if (!props.headless)
+        glfwSetInputMode(window->handle, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
 }
 
 
 void WindowObject::HidePointer()
 {
     hiddenPointer = true;
-    glfwSetInputMode(window->handle, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
+    if (!props.headless)
+        glfwSetInputMode(window->handle, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
 }
 
 
 void WindowObject::DisablePointer()
 {
     hiddenPointer = true;
-    glfwSetInputMode(window->handle, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    if (!props.headless)
+        glfwSetInputMode(window->handle, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 }
 
 
 void WindowObject::SetWindowPosition(glm::ivec2 position)
 {
     props.position = position;
+    if (props.headless)
+        return;
     glfwSetWindowPos(window->handle, position.x, position.y);
 }
 
@@ -154,6 +209,8 @@ void WindowObject::SetWindowPosition(glm::ivec2 position)
 void WindowObject::CenterWindow()
 {
     props.centered = true;
+    if (props.headless)
+        return;
 
     GLFWmonitor *monitor = glfwGetPrimaryMonitor();
     const GLFWvidmode *videoDisplay = glfwGetVideoMode(monitor);
@@ -167,7 +224,8 @@ void WindowObject::CenterPointer()
 {
     props.cursorPos.x = props.resolution.x / 2;
     props.cursorPos.y = props.resolution.y / 2;
-    glfwSetCursorPos(window->handle, props.cursorPos.x, props.cursorPos.y);
+    if (!props.headless)
+        glfwSetCursorPos(window->handle, props.cursorPos.x, props.cursorPos.y);
 }
 
 
@@ -175,12 +233,15 @@ void WindowObject::SetPointerPosition(int mousePosX, int mousePosY)
 {
     props.cursorPos.x = mousePosX;
     props.cursorPos.y = mousePosY;
-    glfwSetCursorPos(window->handle, mousePosX, mousePosY);
+    if (!props.headless)
+        glfwSetCursorPos(window->handle, mousePosX, mousePosY);
 }
 
 
 void WindowObject::PollEvents() const
 {
+    if (props.headless)
+        return;
     glfwPollEvents();
 }
 
@@ -394,12 +455,40 @@ void WindowObject::UpdateObservers()
 
 void WindowObject::MakeCurrentContext() const
 {
+    if (window->headless)
+    {
+        window->headless->MakeCurrent();
+        return;
+    }
+
     glfwMakeContextCurrent(window->handle);
 }
 
 
+void WindowObject::ReleaseCurrentContext() const
+{
+    if (window->headless)
+    {
+        window->headless->ReleaseCurrent();
+        return;
+    }
+
+    glfwMakeContextCurrent(NULL);
+}
+
+
 void WindowObject::SetSize(int width, int height)
 {
+    // The pbuffer of a headless context has the size it was created with
+    if (props.headless)
+    {
+        props.scaleFactor = 1;
+        props.resolution = glm::ivec2(width, height);
+        props.aspectRatio = float(width) / height;
+        resizeEvent = true;
+        return;
+    }
+
     int frameBufferWidth, frameBufferHeight;
 
     glfwGetFramebufferSize(window->handle, &frameBufferWidth, &frameBufferHeight);
@@ -428,5 +517,9 @@ glm::ivec2 WindowObject::GetResolution(bool unscaled) const
 
 void WindowObject::SwapBuffers() const
 {
+    // Headless frames stay in the pbuffer, where they can be read back
+    if (props.headless)
+        return;
+
     glfwSwapBuffers(window->handle);
 }
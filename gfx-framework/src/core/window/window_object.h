@@ -28,6 +28,13 @@ class WindowProperties
     bool centered;
     bool hideOnClose;
     bool vSync;
+
+    // Renders offscreen, without a window or input (see HeadlessContext)
+    bool headless;
+
+    // Number of frames after which the window asks to close, or 0 to run
+    // until it is closed. Lets headless runs end on their own.
+    unsigned int frameLimit;
 };
 
 
@@ -68,7 +75,9 @@ class WindowObject
     void SetVSync(bool state);
     bool ToggleVSync();
 
+    // The context is current on one thread at most, see RenderThread
     void MakeCurrentContext() const;
+    void ReleaseCurrentContext() const;
 
     // Window Information
     void SetSize(int width, int height);
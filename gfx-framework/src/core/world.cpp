@@ -1,6 +1,10 @@
 #include "core/world.h"
 
+#include "core/cpu_profiler.h"
 #include "core/engine.h"
+#include "core/frame_timer.h"
+#include "core/job_system.h"
+#include "core/render_thread.h"
 #include "components/camera_input.h"
 #include "components/transform.h"
 
@@ -10,22 +14,55 @@ World::World()
     previousTime = 0;
     elapsedTime = 0;
     deltaTime = 0;
+    frameDeltaTime = 0;
+    fixedTimeStep = 0;
+    fixedTimeAccumulator = 0;
     paused = false;
     shouldClose = false;
 
+    renderThreadEnabled = false;
+    renderThread = nullptr;
+    recordingList = 0;
+
     window = Engine::GetWindow();
 }
 
 
+World::~World()
+{
+    StopRenderThread();
+}
+
+
 void World::Run()
 {
     if (!window)
         return;
 
+    StartRenderThread();
+
     while (!window->ShouldClose())
     {
         LoopUpdate();
     }
+
+    StopRenderThread();
+}
+
+
+void World::RunFrames(unsigned int frameCount, FrameTimer *timer)
+{
+    if (!window)
+        return;
+
+    StartRenderThread();
+
+    for (unsigned int i = 0; i < frameCount && !window->ShouldClose(); i++)
+    {
+        LoopUpdate(timer);
+    }
+
+    StopRenderThread();
 }
 
 
@@ -48,18 +85,106 @@ double World::GetLastFrameTime()
 }
 
 
+void World::SetFrameDeltaTime(double seconds)
+{
+    frameDeltaTime = seconds > 0 ? seconds : 0;
+}
+
+
+double World::GetFrameDeltaTime() const
+{
+    return frameDeltaTime;
+}
+
+
+void World::SetFixedTimeStep(double seconds)
+{
+    fixedTimeStep = seconds > 0 ? seconds : 0;
+    fixedTimeAccumulator = 0;
+}
+
+
+double World::GetFixedTimeStep() const
+{
+    return fixedTimeStep;
+}
+
+
+float World::GetInterpolationAlpha() const
+{
+    if (fixedTimeStep <= 0)
+        return 1.0f;
+
+    return static_cast<float>(fixedTimeAccumulator / fixedTimeStep);
+}
+
+
+void World::SetRenderThread(bool enabled)
+{
+    renderThreadEnabled = enabled;
+}
+
+
+bool World::UsesRenderThread() const
+{
+    return renderThreadEnabled;
+}
+
+
+void World::Submit(const std::function<void()> &command)
+{
+    if (renderThread)
+        commandLists[recordingList].Record(command);
+    else
+        command();
+}
+
+
+void World::StartRenderThread()
+{
+    if (renderThreadEnabled && !renderThread)
+        renderThread = new RenderThread(window);
+}
+
+
+void World::StopRenderThread()
+{
+    if (!renderThread)
+        return;
+
+    // Waits for the last frame, then takes the context back
+    delete renderThread;
+    renderThread = nullptr;
+
+    for (CommandList &commands : commandLists)
+        commands.Clear();
+    recordingList = 0;
+}
+
+
 void World::ComputeFrameDeltaTime()
 {
-    elapsedTime = Engine::GetElapsedTime();
+    elapsedTime = frameDeltaTime > 0 ? previousTime + frameDeltaTime : Engine::GetElapsedTime();
     deltaTime = elapsedTime - previousTime;
     previousTime = elapsedTime;
 }
 
 
-void World::LoopUpdate()
+void World::LoopUpdate(FrameTimer *timer)
 {
+    PROFILE_ZONE("Frame");
+
+    if (timer)
+    {
+        timer->BeginCpuFrame();
+        Submit([timer]() { timer->BeginGpuFrame(); });
+    }
+
     // Polls and buffers the events
-    window->PollEvents();
+    {
+        PROFILE_ZONE("PollEvents");
+        window->PollEvents();
+    }
 
     // Computes frame deltaTime in seconds
     ComputeFrameDeltaTime();
@@ -67,13 +192,81 @@ void World::LoopUpdate()
     // Calls the methods of the instance of InputController in the following order
     // OnWindowResize, OnMouseMove, OnMouseBtnPress, OnMouseBtnRelease, OnMouseScroll, OnKeyPress, OnMouseScroll, OnInputUpdate
     // OnInputUpdate will be called each frame, the other functions are called only if an event is registered
-    window->UpdateObservers();
+    {
+        PROFILE_ZONE("UpdateObservers");
+        window->UpdateObservers();
+    }
+
+    // Jobs that need the OpenGL context, started since the last frame
+    if (JobSystem *jobs = Engine::GetJobSystem())
+    {
+        PROFILE_ZONE("MainThreadJobs");
+        jobs->RunMainThreadJobs();
+    }
 
     // Frame processing
-    FrameStart();
-    Update(static_cast<float>(deltaTime));
-    FrameEnd();
+    PreFrame();
+    {
+        PROFILE_ZONE("FrameStart");
+        FrameStart();
+    }
+    {
+        PROFILE_ZONE("FixedUpdate");
+        FixedStepUpdate();
+    }
+    {
+        PROFILE_ZONE("Update");
+        Update(static_cast<float>(deltaTime));
+    }
+    {
+        PROFILE_ZONE("FrameEnd");
+        FrameEnd();
+    }
+    PostFrame();
+
+    if (timer)
+        Submit([timer]() { timer->EndGpuFrame(); });
+
+    if (renderThread)
+    {
+        // Waits for the previous frame, whose list can then be reused
+        PROFILE_ZONE("SubmitFrame");
+        renderThread->Submit(&commandLists[recordingList]);
+        recordingList = 1 - recordingList;
+        commandLists[recordingList].Clear();
+    }
+    else
+    {
+        // Swap front and back buffers - image will be displayed to the screen
+        PROFILE_ZONE("SwapBuffers");
+        window->SwapBuffers();
+    }
+
+    if (timer)
+        timer->EndCpuFrame();
+}
+
+
+void World::FixedStepUpdate()
+{
+    // Limits the number of steps run in one frame, so that a long frame
+    // (a breakpoint, a window drag) does not make the next ones even longer
+    const int maxStepsPerFrame = 8;
+
+    if (fixedTimeStep <= 0)
+        return;
+
+    fixedTimeAccumulator += deltaTime;
+
+    int steps = 0;
+    while (fixedTimeAccumulator >= fixedTimeStep && steps < maxStepsPerFrame)
+    {
+        FixedUpdate(static_cast<float>(fixedTimeStep));
+        fixedTimeAccumulator -= fixedTimeStep;
+        steps++;
+    }
 
-    // Swap front and back buffers - image will be displayed to the screen
-    window->SwapBuffers();
+    // Drops the time that could not be simulated
+    if (fixedTimeAccumulator >= fixedTimeStep)
+        fixedTimeAccumulator = 0;
 }
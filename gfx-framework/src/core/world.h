@@ -1,32 +1,99 @@
 #pragma once
 
+#include <functional>
+
+#include "core/command_list.h"
 #include "window/input_controller.h"
 
 
+class FrameTimer;
+class RenderThread;
+
+
 class World : public InputController
 {
  public:
     World();
-    virtual ~World() {}
+    virtual ~World();
     virtual void Init() {}
     virtual void FrameStart() {}
     virtual void Update(float deltaTimeSeconds) {}
+    virtual void FixedUpdate(float fixedDeltaTimeSeconds) {}
     virtual void FrameEnd() {}
 
     void Run();
+
+    // Runs `frameCount` frames, or fewer if the window closes, timing each
+    // one with `timer` when given. Used by the benchmark mode.
+    void RunFrames(unsigned int frameCount, FrameTimer *timer = nullptr);
+
     void Pause();
     void Exit();
 
     double GetLastFrameTime();
 
+    // Advances every frame by `seconds` instead of the time measured by the
+    // clock, so that runs are deterministic. Zero, the default, uses the
+    // clock.
+    void SetFrameDeltaTime(double seconds);
+    double GetFrameDeltaTime() const;
+
+    // Runs FixedUpdate every `seconds` of frame time, before Update. Zero,
+    // the default, disables the fixed simulation step.
+    void SetFixedTimeStep(double seconds);
+    double GetFixedTimeStep() const;
+
+    // Fraction of a fixed step elapsed since the last FixedUpdate, in [0, 1],
+    // used to interpolate the simulated state when rendering
+    float GetInterpolationAlpha() const;
+
+    // Runs the OpenGL work of each frame on a render thread, which owns the
+    // context, while the update thread runs the input callbacks and the
+    // updates of the next frame. Takes effect on the next Run or RunFrames.
+    //
+    // Scenes that enable it must only use OpenGL inside commands given to
+    // Submit, from every callback, including the input callbacks, and from
+    // the main thread jobs of the JobSystem. Init, and the destructor, still
+    // run with the context on the calling thread.
+    void SetRenderThread(bool enabled);
+    bool UsesRenderThread() const;
+
+    // Whether the scene follows the rules of SetRenderThread. Only enable
+    // the render thread for scenes that return true.
+    virtual bool SupportsRenderThread() const { return false; }
+
+    // Runs `command` now, or records it to be run by the render thread
+    // after the commands submitted before it in the frame
+    void Submit(const std::function<void()> &command);
+
+ protected:
+    // Run before FrameStart and after FrameEnd, for the work a base scene
+    // does every frame without relying on the overrides of derived scenes
+    virtual void PreFrame() {}
+    virtual void PostFrame() {}
+
  private:
     void ComputeFrameDeltaTime();
-    void LoopUpdate();
+    void LoopUpdate(FrameTimer *timer = nullptr);
+    void FixedStepUpdate();
+
+    void StartRenderThread();
+    void StopRenderThread();
 
  private:
     double previousTime;
     double elapsedTime;
     double deltaTime;
+    double frameDeltaTime;
+    double fixedTimeStep;
+    double fixedTimeAccumulator;
     bool paused;
     bool shouldClose;
+
+    bool renderThreadEnabled;
+    RenderThread *renderThread;
+
+    // One list records the next frame while the other is executed
+    CommandList commandLists[2];
+    unsigned int recordingList;
 };
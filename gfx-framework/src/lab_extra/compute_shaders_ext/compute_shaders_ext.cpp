@@ -32,6 +32,10 @@ static void DispatchCompute(unsigned int sizeX, unsigned int sizeY, unsigned int
 
 
 ComputeShadersExt::ComputeShadersExt()
+    : frameBuffer(nullptr),
+      frameBufferBlur(nullptr),
+      textureBlur(nullptr),
+      profiler(nullptr)
 {
 }
 
@@ -41,6 +45,7 @@ ComputeShadersExt::~ComputeShadersExt()
     delete frameBuffer;
     delete frameBufferBlur;
     delete textureBlur;
+    delete profiler;
 }
 
 
@@ -114,11 +119,14 @@ void ComputeShadersExt::Init()
 
     textureBlur = new Texture2D();
     textureBlur->Create(nullptr, resolution.x, resolution.y, 4);
+
+    profiler = new GpuProfiler();
 }
 
 
 void ComputeShadersExt::FrameStart()
 {
+    profiler->BeginFrame();
 }
 
 
@@ -133,16 +141,8 @@ void ComputeShadersExt::Update(float deltaTimeSeconds)
         DrawScene();
     }
 
-    glFinish();
-
-    const int kNrTimers = 3;
-    GLuint64 timers[kNrTimers];
-    unsigned int queryID[kNrTimers];
-
-    glGenQueries(kNrTimers, queryID);
-    glQueryCounter(queryID[0], GL_TIMESTAMP);
-
     {
+        GpuProfiler::Scope scope(profiler, "FB");
         auto tStart = std::chrono::high_resolution_clock::now();
 
         // Blur using a framebuffer
@@ -174,9 +174,8 @@ void ComputeShadersExt::Update(float deltaTimeSeconds)
 #endif
     }
 
-    glQueryCounter(queryID[1], GL_TIMESTAMP);
-
     {
+        GpuProfiler::Scope scope(profiler, "CS");
         auto tStart = std::chrono::high_resolution_clock::now();
 
         // Run compute shader
@@ -203,17 +202,13 @@ void ComputeShadersExt::Update(float deltaTimeSeconds)
 #endif
     }
 
-    glQueryCounter(queryID[2], GL_TIMESTAMP);
-    glFinish();
-
-    for (int i = 0; i < kNrTimers; i++)
+    // Results of a few frames ago, averaged, so that measuring does not
+    // stall the pipeline
+    for (const GpuProfiler::ScopeStats &stats : profiler->GetScopes())
     {
-        glGetQueryObjectui64v(queryID[i], GL_QUERY_RESULT, &timers[i]);
+        printf("Time spent on the GPU %s: %f ms (avg %f ms)\n", stats.name.c_str(), stats.gpu.lastMs, stats.gpu.averageMs);
     }
 
-    printf("Time spent on the GPU FB: %f ms\n", (timers[1] - timers[0]) / 1000000.0);
-    printf("Time spent on the GPU CB: %f ms\n", (timers[2] - timers[1]) / 1000000.0);
-
     // Render the scene normaly
 
     FrameBuffer::BindDefault();
@@ -2,6 +2,7 @@
 
 #include "components/simple_scene.h"
 #include "core/gpu/frame_buffer.h"
+#include "core/gpu/gpu_profiler.h"
 
 
 namespace extra
@@ -33,6 +34,7 @@ namespace extra
         FrameBuffer *frameBuffer;
         FrameBuffer *frameBufferBlur;
         Texture2D *textureBlur;
+        GpuProfiler *profiler;
         float angle = 0;
         int textureID = 0;
         bool fullScreenPass = true;
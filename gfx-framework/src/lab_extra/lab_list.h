@@ -5,3 +5,4 @@
 #include "lab_extra/compute_shaders_ext/compute_shaders_ext.h"
 #include "lab_extra/tessellation_shader/tessellation_shader.h"
 #include "lab_extra/basic_text/basic_text.h"
+#include "lab_extra/model_buffer/model_buffer.h"
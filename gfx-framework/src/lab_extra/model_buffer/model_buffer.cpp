@@ -0,0 +1,107 @@
+#include "lab_extra/model_buffer/model_buffer.h"
+
+#include "components/transform.h"
+
+using namespace extra;
+
+
+/*
+ *  To find out more about `FrameStart`, `Update`, `FrameEnd`
+ *  and the order in which they are called, see `world.cpp`.
+ */
+
+
+ModelBuffer::ModelBuffer()
+{
+    modelBuffer = nullptr;
+    locObjectId = INVALID_LOC;
+    frame = 0;
+}
+
+
+ModelBuffer::~ModelBuffer()
+{
+    // The journal must outlive the transforms attached to it
+    for (gfxc::Transform *box : boxes)
+        delete box;
+
+    delete modelBuffer;
+}
+
+
+void ModelBuffer::Init()
+{
+    auto camera = GetSceneCamera();
+    camera->SetPositionAndRotation(glm::vec3(0, 14, 26), glm::quat(glm::vec3(-30 * TO_RADIANS, 0, 0)));
+    camera->Update();
+
+    {
+        Mesh* mesh = new Mesh("box");
+        mesh->LoadMesh(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::MODELS, "primitives"), "box.obj");
+        meshes[mesh->GetMeshID()] = mesh;
+    }
+
+    // Create a shader program that reads the model matrices by object id
+    {
+        Shader *shader = new Shader("ModelBuffer");
+        shader->AddShader(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::SHADERS, "MVP.ModelBuffer.VS.glsl"), GL_VERTEX_SHADER);
+        shader->AddShader(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::SHADERS, "Normals.FS.glsl"), GL_FRAGMENT_SHADER);
+        shader->CreateAndLink();
+        shaders[shader->GetName()] = shader;
+        locObjectId = shader->GetUniformLocation("ObjectId");
+    }
+
+    // The boxes are attached before they are placed, so that the first
+    // upload sends all of their matrices
+    const float spacing = 1.5f;
+    const float offset = 0.5f * spacing * (kGridSize - 1);
+
+    for (unsigned int i = 0; i < kGridSize * kGridSize; i++)
+    {
+        gfxc::Transform *box = new gfxc::Transform();
+        box->SetJournal(&journal, i);
+        box->SetWorldPosition(glm::vec3(spacing * (i % kGridSize) - offset, 0.5f, spacing * (i / kGridSize) - offset));
+        box->SetScale(glm::vec3(0.5f));
+        boxes.push_back(box);
+    }
+
+    modelBuffer = new ModelMatrixBuffer(static_cast<unsigned int>(boxes.size()));
+}
+
+
+void ModelBuffer::FrameStart()
+{
+    ClearScreen();
+}
+
+
+void ModelBuffer::Update(float deltaTimeSeconds)
+{
+    // A different tenth of the boxes spins every frame
+    for (unsigned int i = frame % 10; i < boxes.size(); i += 10)
+        boxes[i]->RotateWorldOY(500.0f * deltaTimeSeconds);
+    frame++;
+
+    modelBuffer->Upload(journal);
+    modelBuffer->BindBuffer(0);
+
+    Shader *shader = shaders["ModelBuffer"];
+    Mesh *mesh = meshes["box"];
+
+    // The camera is read from the camera block, and the model matrix from
+    // the model buffer, so only the object id changes between the draws
+    shader->Use();
+    mesh->Bind();
+    for (gfxc::Transform *box : boxes)
+    {
+        glUniform1ui(locObjectId, box->GetObjectId());
+        mesh->Draw();
+    }
+    glBindVertexArray(0);
+}
+
+
+void ModelBuffer::FrameEnd()
+{
+    DrawCoordinateSystem();
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+
+#include "components/simple_scene.h"
+#include "components/transform_journal.h"
+#include "core/gpu/model_matrix_buffer.h"
+
+
+namespace extra
+{
+    // A grid of boxes whose model matrices live in a ModelMatrixBuffer. Each
+    // frame, a tenth of the boxes spin, and only their matrices are sent to
+    // the GPU. The vertex shader reads the matrix of a box by its object id.
+    class ModelBuffer : public gfxc::SimpleScene
+    {
+     public:
+        ModelBuffer();
+        ~ModelBuffer();
+
+        void Init() override;
+
+     private:
+        void FrameStart() override;
+        void Update(float deltaTimeSeconds) override;
+        void FrameEnd() override;
+
+     private:
+        static const unsigned int kGridSize = 32U;
+
+        gfxc::TransformJournal journal;
+        std::vector<gfxc::Transform *> boxes;
+        ModelMatrixBuffer *modelBuffer;
+        GLint locObjectId;
+        unsigned int frame;
+    };
+}   // namespace extra
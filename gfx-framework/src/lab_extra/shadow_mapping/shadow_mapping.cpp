@@ -4,6 +4,9 @@
 #include <string>
 #include <iostream>
 
+#include "core/engine.h"
+#include "core/job_system.h"
+
 using namespace std;
 using namespace extra;
 
@@ -32,27 +35,30 @@ void ShadowMapping::Init()
 
     TextureManager::LoadTexture(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::TEXTURES), "ground.jpg");
 
+    // The meshes are read on worker threads while the shaders are compiled
+    JobCounter meshesLoaded;
+
     {
         Mesh* mesh = new Mesh("box");
-        mesh->LoadMesh(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::MODELS, "primitives"), "box.obj");
+        mesh->LoadMeshAsync(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::MODELS, "primitives"), "box.obj", &meshesLoaded);
         meshes[mesh->GetMeshID()] = mesh;
     }
 
     {
         Mesh* mesh = new Mesh("sphere");
-        mesh->LoadMesh(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::MODELS, "primitives"), "sphere.obj");
+        mesh->LoadMeshAsync(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::MODELS, "primitives"), "sphere.obj", &meshesLoaded);
         meshes[mesh->GetMeshID()] = mesh;
     }
 
     {
         Mesh* mesh = new Mesh("plane");
-        mesh->LoadMesh(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::MODELS, "primitives"), "plane50.obj");
+        mesh->LoadMeshAsync(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::MODELS, "primitives"), "plane50.obj", &meshesLoaded);
         meshes[mesh->GetMeshID()] = mesh;
     }
 
     {
         Mesh* mesh = new Mesh("quad");
-        mesh->LoadMesh(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::MODELS, "primitives"), "quad.obj");
+        mesh->LoadMeshAsync(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::MODELS, "primitives"), "quad.obj", &meshesLoaded);
         mesh->UseMaterials(false);
         meshes[mesh->GetMeshID()] = mesh;
     }
@@ -64,6 +70,8 @@ void ShadowMapping::Init()
         LoadShader("TextureDebug");
     }
 
+    Engine::GetJobSystem()->Wait(meshesLoaded);
+
     // Light & material properties
     {
         lightDirection = glm::vec3(0, -1, 0);
@@ -97,6 +97,7 @@ void Lab3_Vis2D::SetViewportArea(const ViewportSpace & viewSpace, glm::vec3 colo
 
     GetSceneCamera()->SetOrthographic((float)viewSpace.x, (float)(viewSpace.x + viewSpace.width), (float)viewSpace.y, (float)(viewSpace.y + viewSpace.height), 0.1f, 400);
     GetSceneCamera()->Update();
+    UpdateCameraUniforms();
 }
 
 
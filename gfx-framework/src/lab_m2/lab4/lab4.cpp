@@ -34,9 +34,10 @@ void Lab4::Init()
     std::string texturePath = PATH_JOIN(window->props.selfDir, RESOURCE_PATH::TEXTURES, "cube");
     std::string shaderPath = PATH_JOIN(window->props.selfDir, SOURCE_PATH::M2, "lab4", "shaders");
 
+    // Drawn as a box until the model is read
     {
         Mesh* mesh = new Mesh("bunny");
-        mesh->LoadMesh(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::MODELS, "animals"), "bunny.obj");
+        mesh->LoadMeshAsync(PATH_JOIN(window->props.selfDir, RESOURCE_PATH::MODELS, "animals"), "bunny.obj");
         mesh->UseMaterials(false);
         meshes[mesh->GetMeshID()] = mesh;
     }
@@ -3,6 +3,8 @@
 #include <vector>
 #include <iostream>
 
+#include "core/engine.h"
+#include "core/job_system.h"
 #include "pfd/portable-file-dialogs.h"
 
 using namespace std;
@@ -142,17 +144,21 @@ void Lab7::GrayScale()
 
     glm::ivec2 imageSize = glm::ivec2(originalImage->GetWidth(), originalImage->GetHeight());
 
-    for (int i = 0; i < imageSize.y; i++)
+    // Every job converts a range of rows
+    Engine::GetJobSystem()->ParallelFor(0, imageSize.y, 0, [&](unsigned int firstRow, unsigned int lastRow)
     {
-        for (int j = 0; j < imageSize.x; j++)
+        for (int i = firstRow; i < static_cast<int>(lastRow); i++)
         {
-            int offset = channels * (i * imageSize.x + j);
-
-            // Reset save image data
-            char value = static_cast<char>(data[offset + 0] * 0.2f + data[offset + 1] * 0.71f + data[offset + 2] * 0.07);
-            memset(&newData[offset], value, 3);
+            for (int j = 0; j < imageSize.x; j++)
+            {
+                int offset = channels * (i * imageSize.x + j);
+
+                // Reset save image data
+                char value = static_cast<char>(data[offset + 0] * 0.2f + data[offset + 1] * 0.71f + data[offset + 2] * 0.07);
+                memset(&newData[offset], value, 3);
+            }
         }
-    }
+    });
 
     processedImage->UploadNewData(newData);
 }
@@ -1,9 +1,16 @@
+#include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "components/camera.h"
 #include "components/transform.h"
+#include "core/cpu_profiler.h"
 #include "core/engine.h"
+#include "core/frame_stats.h"
+#include "core/frame_timer.h"
 #include "components/simple_scene.h"
 #include "core/gpu/mesh.h"
 
@@ -35,6 +42,255 @@ std::string GetParentDir(const std::string &filePath)
 }
 
 
+template <typename T>
+World* CreateWorld()
+{
+    return new T();
+}
+
+
+// Scenes that can be picked by name on the command line
+struct SceneEntry
+{
+    const char *name;
+    World* (*create)();
+};
+
+static const SceneEntry kScenes[] = {
+    { "simple_scene", CreateWorld<gfxc::SimpleScene> },
+#if defined(WITH_LAB_M1)
+    { "m1/lab1", CreateWorld<m1::Lab1> },
+    { "m1/lab2", CreateWorld<m1::Lab2> },
+    { "m1/lab3", CreateWorld<m1::Lab3> },
+    { "m1/lab3_vis2d", CreateWorld<m1::Lab3_Vis2D> },
+    { "m1/lab4", CreateWorld<m1::Lab4> },
+    { "m1/lab5", CreateWorld<m1::Lab5> },
+    { "m1/lab6", CreateWorld<m1::Lab6> },
+    { "m1/lab7", CreateWorld<m1::Lab7> },
+    { "m1/lab8", CreateWorld<m1::Lab8> },
+    { "m1/lab9", CreateWorld<m1::Lab9> },
+#endif
+#if defined(WITH_LAB_M2)
+    { "m2/lab1", CreateWorld<m2::Lab1> },
+    { "m2/lab2", CreateWorld<m2::Lab2> },
+    { "m2/lab3", CreateWorld<m2::Lab3> },
+    { "m2/lab4", CreateWorld<m2::Lab4> },
+    { "m2/lab5", CreateWorld<m2::Lab5> },
+    { "m2/lab6", CreateWorld<m2::Lab6> },
+    { "m2/lab7", CreateWorld<m2::Lab7> },
+#endif
+#if defined(WITH_LAB_EXTRA)
+    { "extra/shadow_mapping", CreateWorld<extra::ShadowMapping> },
+    { "extra/compute_shaders", CreateWorld<extra::ComputeShaders> },
+    { "extra/compute_shaders_ext", CreateWorld<extra::ComputeShadersExt> },
+    { "extra/tessellation_shader", CreateWorld<extra::TessellationShader> },
+    { "extra/basic_text", CreateWorld<extra::BasicText> },
+    { "extra/model_buffer", CreateWorld<extra::ModelBuffer> },
+#endif
+};
+
+
+World* CreateScene(const std::string &name)
+{
+    for (const SceneEntry &entry : kScenes)
+    {
+        if (name == entry.name)
+            return entry.create();
+    }
+
+    std::cerr << "Unknown scene: " << name << ". Available scenes:" << std::endl;
+    for (const SceneEntry &entry : kScenes)
+        std::cerr << "    " << entry.name << std::endl;
+    return nullptr;
+}
+
+
+struct RunOptions
+{
+    std::string scene = "simple_scene";
+
+    // OpenGL work on a render thread, see World::SetRenderThread
+    bool renderThread = false;
+
+    // Renders the scene with and without the render thread, and compares
+    // the last frames
+    bool checkRenderThread = false;
+
+    // Benchmark mode: warm-up frames, then measured frames, all advanced by
+    // a fixed delta time
+    bool benchmark = false;
+    unsigned int warmupFrames = 60;
+    unsigned int measuredFrames = 600;
+    double deltaTime = 1.0 / 60;
+    std::string output;
+};
+
+
+static bool ReadValue(const char *arg, const char *flag, const char **value)
+{
+    const size_t length = strlen(flag);
+    if (strncmp(arg, flag, length) != 0 || arg[length] != '=')
+        return false;
+
+    *value = arg + length + 1;
+    return true;
+}
+
+
+// Reads the command line flags:
+//   --headless         render offscreen, without a display
+//   --scene=NAME       run a scene of kScenes instead of simple_scene
+//   --render-thread    submit the OpenGL work of each frame to a render
+//                      thread, for scenes that support it (simple_scene)
+//   --check-render-thread
+//                      render the frames with and without the render
+//                      thread, and fail if the last ones differ
+//   --frames=N         close after N frames, or measure N frames in
+//                      benchmark mode
+//   --benchmark        run the warm-up and measured frames with a fixed
+//                      delta time, then print the frame time stats
+//   --warmup=N         frames run before measuring
+//   --delta=SECONDS    delta time of each benchmark frame
+//   --output=FILE      write the samples to FILE, as JSON with the stats
+//                      if it ends with .json, as CSV otherwise
+//   --trace=FILE       write the CPU profiler zones to FILE at exit, as a
+//                      Chrome trace (only with WITH_PROFILER)
+void ParseArguments(int argc, char **argv, WindowProperties &wp, RunOptions &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *value = nullptr;
+
+        if (strcmp(argv[i], "--headless") == 0)
+            wp.headless = true;
+        else if (strcmp(argv[i], "--benchmark") == 0)
+            options.benchmark = true;
+        else if (strcmp(argv[i], "--render-thread") == 0)
+            options.renderThread = true;
+        else if (strcmp(argv[i], "--check-render-thread") == 0)
+            options.checkRenderThread = true;
+        else if (ReadValue(argv[i], "--scene", &value))
+            options.scene = value;
+        else if (ReadValue(argv[i], "--frames", &value))
+            options.measuredFrames = wp.frameLimit = static_cast<unsigned int>(strtoul(value, NULL, 10));
+        else if (ReadValue(argv[i], "--warmup", &value))
+            options.warmupFrames = static_cast<unsigned int>(strtoul(value, NULL, 10));
+        else if (ReadValue(argv[i], "--delta", &value))
+            options.deltaTime = strtod(value, NULL);
+        else if (ReadValue(argv[i], "--output", &value))
+            options.output = value;
+#if defined(WITH_PROFILER)
+        else if (ReadValue(argv[i], "--trace", &value))
+            CpuProfiler::SetExitTracePath(value);
+#endif
+        else
+            std::cerr << "Unknown argument: " << argv[i] << std::endl;
+    }
+
+    // Frames must not wait for the display when they are measured, and the
+    // benchmark runs its own frame count
+    if (options.benchmark || options.checkRenderThread)
+    {
+        wp.vSync = false;
+        wp.frameLimit = 0;
+    }
+}
+
+
+static void PrintStats(const char *name, const std::vector<double> &samples)
+{
+    if (samples.empty())
+        return;
+
+    const FrameStats stats = frame_stats::Compute(samples);
+    printf("%-4s min %8.3f  avg %8.3f  p50 %8.3f  p95 %8.3f  p99 %8.3f  max %8.3f ms\n",
+           name, stats.min, stats.avg, stats.p50, stats.p95, stats.p99, stats.max);
+}
+
+
+int RunBenchmark(World *world, const RunOptions &options)
+{
+    world->SetFrameDeltaTime(options.deltaTime);
+    world->Init();
+    world->RunFrames(options.warmupFrames);
+
+    FrameTimer timer;
+    world->RunFrames(options.measuredFrames, &timer);
+    timer.Finish();
+
+    printf("%s: %u frames after %u warm-up frames, delta time %.6f s\n", options.scene.c_str(),
+           static_cast<unsigned int>(timer.GetCpuTimes().size()), options.warmupFrames, options.deltaTime);
+    PrintStats("cpu", timer.GetCpuTimes());
+    PrintStats("gpu", timer.GetGpuTimes());
+
+    if (!options.output.empty()
+        && !frame_stats::Write(options.output, options.scene, options.deltaTime, timer.GetCpuTimes(), timer.GetGpuTimes()))
+    {
+        std::cerr << "Cannot write " << options.output << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+
+// Color of the default framebuffer, after the last frame
+static std::vector<unsigned char> ReadFrame()
+{
+    const glm::ivec2 resolution = Engine::GetWindow()->GetResolution();
+    std::vector<unsigned char> pixels(4 * resolution.x * resolution.y);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, resolution.x, resolution.y, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    return pixels;
+}
+
+
+// Runs the same frames of two instances of the scene, the first one without
+// the render thread, and the second one with it. Both see the same delta
+// times and random numbers, so their last frames must be the same.
+int CheckRenderThread(const RunOptions &options)
+{
+    std::vector<unsigned char> frames[2];
+
+    for (int i = 0; i < 2; i++)
+    {
+        World *world = CreateScene(options.scene);
+        if (!world)
+            return 1;
+
+        if (!world->SupportsRenderThread())
+        {
+            std::cerr << "The " << options.scene << " scene does not support the render thread" << std::endl;
+            delete world;
+            return 1;
+        }
+
+        srand(0U);
+        world->SetRenderThread(i == 1);
+        world->SetFrameDeltaTime(options.deltaTime);
+        world->Init();
+        world->RunFrames(options.measuredFrames);
+
+        frames[i] = ReadFrame();
+        delete world;
+    }
+
+    unsigned int differentPixels = 0;
+    for (size_t i = 0; i < frames[0].size(); i += 4)
+    {
+        if (memcmp(&frames[0][i], &frames[1][i], 4) != 0)
+            differentPixels++;
+    }
+
+    printf("%s: %u of %u pixels differ with the render thread after %u frames\n", options.scene.c_str(),
+           differentPixels, static_cast<unsigned int>(frames[0].size() / 4), options.measuredFrames);
+
+    return differentPixels == 0 ? 0 : 1;
+}
+
+
 #define OFFSETOF(type, field)    ((unsigned long) &(((type *) 0)->field))
 #define PRINT_FIELD(type, field) (std::cout << #type << "::" << #field \
                                             << " offset: " << OFFSETOF(type, field) \
@@ -134,26 +390,62 @@ int main(int argc, char **argv)
 #endif
 
 #if true // original code
-    srand((unsigned int)time(NULL));
-
     // Create a window property structure
     WindowProperties wp;
     wp.resolution = glm::ivec2(1280, 720);
     wp.vSync = true;
     wp.selfDir = GetParentDir(std::string(argv[0]));
 
+    RunOptions options;
+    ParseArguments(argc, argv, wp, options);
+
+    // Benchmark runs see the same random numbers every time
+    srand(options.benchmark ? 0U : (unsigned int)time(NULL));
+
     // Init the Engine and create a new window with the defined properties
     (void)Engine::Init(wp);
 
+    if (options.checkRenderThread)
+    {
+        const int status = CheckRenderThread(options);
+        Engine::Exit();
+        return status;
+    }
+
     // Create a new 3D world and start running it
-    gfxc::SimpleScene world;
+    World *world = CreateScene(options.scene);
+    if (!world)
+        return 1;
+
+    // Other scenes use OpenGL outside of the submitted commands, on a
+    // thread that no longer has the context
+    if (options.renderThread && !world->SupportsRenderThread())
+    {
+        std::cerr << "The " << options.scene << " scene does not support --render-thread" << std::endl;
+        delete world;
+        Engine::Exit();
+        return 1;
+    }
+
+    world->SetRenderThread(options.renderThread);
+
+    int status = 0;
+    if (options.benchmark)
+    {
+        status = RunBenchmark(world, options);
+    }
+    else
+    {
+        world->Init();
+        world->Run();
+    }
 
-    world.Init();
-    world.Run();
+    delete world;
 
     // Signals to the Engine to release the OpenGL context
     Engine::Exit();
 
+    return status;
 #endif
     return 0;
 }
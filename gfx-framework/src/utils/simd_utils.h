@@ -0,0 +1,102 @@
+#pragma once
+
+/*
+ *  Compile time and run time detection of the SIMD instruction sets used
+ *  by the batch kernels. SSE2 is part of the x86_64 baseline and NEON is
+ *  part of the arm64 baseline, so only AVX2 needs a run time check.
+ */
+
+#if defined(__x86_64__) || defined(_M_X64)
+#   define GFXF_SIMD_X64    1
+#   include <emmintrin.h>
+#   include <immintrin.h>
+#   if defined(_MSC_VER)
+#       include <intrin.h>
+#   endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#   define GFXF_SIMD_NEON   1
+#   include <arm_neon.h>
+#endif
+
+// Enables an instruction set for a single function, so that the rest of
+// the translation unit can still run on the baseline CPU
+#if defined(GFXF_SIMD_X64) && (defined(__GNUC__) || defined(__clang__))
+#   define GFXF_TARGET_AVX2     __attribute__((target("avx2")))
+#else
+#   define GFXF_TARGET_AVX2
+#endif
+
+
+enum class SimdPath
+{
+    SCALAR,
+    SSE2,
+    AVX2,
+    NEON,
+};
+
+
+inline const char *GetSimdPathName(SimdPath path)
+{
+    switch (path) {
+    case SimdPath::SCALAR:  return "scalar";
+    case SimdPath::SSE2:    return "sse2";
+    case SimdPath::AVX2:    return "avx2";
+    case SimdPath::NEON:    return "neon";
+    }
+    return "";
+}
+
+
+inline bool IsSimdPathSupported(SimdPath path)
+{
+    switch (path) {
+    case SimdPath::SCALAR:
+        return true;
+
+#if defined(GFXF_SIMD_X64)
+    case SimdPath::SSE2:
+        return true;
+
+    case SimdPath::AVX2:
+    {
+#   if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#   else
+        static const bool supported = __builtin_cpu_supports("avx2") != 0;
+        return supported;
+#   endif
+    }
+#endif
+
+#if defined(GFXF_SIMD_NEON)
+    case SimdPath::NEON:
+        return true;
+#endif
+
+    default:
+        return false;
+    }
+}
+
+
+// The widest instruction set supported by the current CPU
+inline SimdPath GetBestSimdPath()
+{
+    if (IsSimdPathSupported(SimdPath::AVX2))    return SimdPath::AVX2;
+    if (IsSimdPathSupported(SimdPath::SSE2))    return SimdPath::SSE2;
+    if (IsSimdPathSupported(SimdPath::NEON))    return SimdPath::NEON;
+    return SimdPath::SCALAR;
+}